@@ -6,12 +6,18 @@
 #include "verify.h"
 #include "operation.h"
 #include "test.h"
+#include "drbg.h"
 
 int main()
 {   
     atexit(check_leaks);
     
+#if T_TEST_FIXED_SEED == 1
+    srand(0);
+    drbg_seed((const byte*)"OKT", 3);
+#else
     srand(time(NULL));
+#endif
     // printf("============================================================================\n");
     // printf("                           OKT Bignumber Library\n");
     // printf("============================================================================\n");
@@ -66,6 +72,54 @@ int main()
     
     // python_rsa_enc_dec_test("rsa_enc_dec_test.py");
     // printf("rsa_enc_dec_test.py completed\n");
+
+    // python_small_prime_test("small_prime_test.py");
+    // printf("small_prime_test.py completed\n");
+
+    // python_bytes_test("bytes_test.py");
+    // printf("bytes_test.py completed\n");
+
+    // python_dec_test("dec_test.py");
+    // printf("dec_test.py completed\n");
+
+    // python_mont_exp_test("mont_exp_test.py");
+    // printf("mont_exp_test.py completed\n");
+
+    // python_inplace_test("inplace_test.py");
+    // printf("inplace_test.py completed\n");
+
+    // python_rsa_ctx_test("rsa_ctx_test.py");
+    // printf("rsa_ctx_test.py completed\n");
+
+    // python_rsa_batch_test("rsa_batch_test.py");
+    // printf("rsa_batch_test.py completed\n");
+
+    // python_rsa_multi_prime_test("rsa_multi_prime_test.py", 2);
+    // printf("rsa_multi_prime_test.py completed\n");
+
+    // python_sha256_test("sha256_test.py");
+    // printf("sha256_test.py completed\n");
+
+    // python_pkcs1_test("pkcs1_test.py");
+    // printf("pkcs1_test.py completed\n");
+
+    // python_rsa_verify_batch_test("rsa_verify_batch_test.py");
+    // printf("rsa_verify_batch_test.py completed\n");
+
+    // python_mont_exp_multi_test("mont_exp_multi_test.py");
+    // printf("mont_exp_multi_test.py completed\n");
+
+    // python_mont_exp_wide_test("mont_exp_wide_test.py");
+    // printf("mont_exp_wide_test.py completed\n");
+
+    // python_cpu_kernels_test("cpu_kernels_test.py");
+    // printf("cpu_kernels_test.py completed\n");
+
+    // python_mempool_test("mempool_test.py");
+    // printf("mempool_test.py completed\n");
+
+    // python_fixed_test("fixed_test.py");
+    // printf("fixed_test.py completed\n");
     // py_file_check();
 
     return 0;
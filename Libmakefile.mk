@@ -1,6 +1,6 @@
 # Compiler and Flags
 CC = gcc
-CFLAGS = -Wall -Wextra -O2 -std=c99
+CFLAGS = -Wall -Wextra -O2 -std=c99 -pthread
 DLLEXT = dll
 
 # Target directories
@@ -20,9 +20,9 @@ LIB_DIR = $(TARGET_DIR)
 APP_DIR = $(TARGET_DIR)
 
 # Source files
-MAIN_SRC = arrayfun.c bigintfun.c operation_tool.c operation.c rsa.c
-TOOL_SRC = arrayfun.c bigintfun.c operation.c operation_tool.c rsa.c
-APP_SRC = arrayfun.c bigintfun.c operation_tool.c operation.c test.c verify.c rsa.c 2024_bigint.c
+MAIN_SRC = arrayfun.c bigintfun.c operation_tool.c operation.c rsa.c drbg.c mempool.c montgomery.c threadpool.c cpu.c mont_avx2.c sha256.c pkcs1.c
+TOOL_SRC = arrayfun.c bigintfun.c operation.c operation_tool.c rsa.c drbg.c mempool.c montgomery.c threadpool.c cpu.c mont_avx2.c sha256.c pkcs1.c
+APP_SRC = arrayfun.c bigintfun.c operation_tool.c operation.c test.c verify.c rsa.c drbg.c mempool.c montgomery.c threadpool.c cpu.c mont_avx2.c sha256.c pkcs1.c 2024_bigint.c
 
 # Object files
 MAIN_OBJ = $(MAIN_SRC:.c=.o)
@@ -1,10 +1,28 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "arrayfun.h"
+#include "drbg.h"
 #include "params.h"
 #include "dtype.h"
 #include "errormsg.h"
+#include "wordfun.h"
+#include "cpu.h"
+
+#if defined(__SSE2__) && (SIZEOFWORD == 64)
+    #include <emmintrin.h>
+    #define ARRAY_SHIFT_SSE2 1      //two-word funnel shifts, SSE2 is part of every x86-64 target
+#else
+    #define ARRAY_SHIFT_SSE2 0
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__) && (SIZEOFWORD == 64)
+    #include <immintrin.h>
+    #define ARRAY_X86_KERNELS 1     //MULX/ADCX/ADOX, AVX2 and AVX-512 variants, bound at run time
+#else
+    #define ARRAY_X86_KERNELS 0
+#endif
 
 
 /**
@@ -12,25 +30,17 @@
  * 
  * This function populates the specified array (`dst`) with random byte values, 
  * where the length of the array is determined by the specified word length 
- * (`word_len`).
+ * (`word_len`). The bytes come from the calling thread's ChaCha20 DRBG in one
+ * bulk request.
  * 
  * @param[out] dst Pointer to the array of `word` to be filled with random values.
  * @param[in] word_len The number of words to be filled with random data.
  * 
- * @return void
+ * @return Returns 1 on success, -1 on failure.
  */
-void array_rand(OUT word* dst, IN int word_len)
+msg array_rand(OUT word* dst, IN int word_len)
 {
-    byte* p = (byte*)dst;
-    
-    int byte_index = word_len * sizeof(word);
-
-    while(byte_index > 0)
-    {
-        *p = rand() & 0xff;
-        p++;
-        byte_index--;
-    }
+    return drbg_words(dst, word_len);
 }
 
 /**
@@ -77,4 +87,575 @@ void array_copy(OUT word* dst_arr, IN const word* src_arr, IN int array_len)
     {
         dst_arr[index] = src_arr[index];
     }
+}
+
+
+/**
+ * @brief Shifts a word array left by `num_bits` bits into a destination array.
+ * 
+ * Writes `src_len + num_bits / SIZEOFWORD` words to `dst`: the vacated low words are zero
+ * and the bits shifted out of the top word are returned instead of being stored, so the
+ * caller only needs room for a carry word when it is non-zero. Whole-word shifts are a
+ * single memmove; otherwise every output word is the funnel shift of two input words.
+ * `dst` may equal `src` (the words are produced from the top down). The variant for the CPU
+ * comes from `cpu_kernels_get`.
+ * 
+ * @param[out] dst Pointer to the destination array.
+ * @param[in] src Pointer to the source array.
+ * @param[in] src_len The number of source words (at least 1).
+ * @param[in] num_bits The shift amount in bits.
+ * 
+ * @return The carry word shifted out of the top.
+ */
+word array_lshift(OUT word* dst, IN const word* src, IN int src_len, IN int num_bits)
+{
+    return cpu_kernels_get()->lshift(dst, src, src_len, num_bits);
+}
+
+/**
+ * @brief Shifts a word array right by `num_bits` bits into a destination array.
+ * 
+ * Writes `src_len - num_bits / SIZEOFWORD` words to `dst`, which must be positive. Whole-word
+ * shifts are a single memmove; otherwise every output word is the funnel shift of two input
+ * words. `dst` may equal `src` (the words are produced from the bottom up). The variant for
+ * the CPU comes from `cpu_kernels_get`.
+ * 
+ * @param[out] dst Pointer to the destination array.
+ * @param[in] src Pointer to the source array.
+ * @param[in] src_len The number of source words.
+ * @param[in] num_bits The shift amount in bits.
+ * 
+ * @return void
+ */
+void array_rshift(OUT word* dst, IN const word* src, IN int src_len, IN int num_bits)
+{
+    cpu_kernels_get()->rshift(dst, src, src_len, num_bits);
+}
+
+/**
+ * @brief Adds two word arrays of the same length with one carry chain.
+ * 
+ * The loop is unrolled by 4 so that the carries stay in the flags register between words.
+ * `dst` may equal `src1` or `src2`.
+ * 
+ * @param[out] dst Pointer to the sum, `len` words.
+ * @param[in] src1, src2 Pointers to the words to be added.
+ * @param[in] len The number of words.
+ * 
+ * @return The carry out of the top word (0 or 1).
+ */
+word array_add_n(OUT word* dst, IN const word* src1, IN const word* src2, IN int len)
+{
+    word carry = 0;
+    int index = 0;
+
+    for(; index + 4 <= len; index += 4)
+    {
+        dst[index] = word_add_c(&carry, src1[index], src2[index], carry);
+        dst[index + 1] = word_add_c(&carry, src1[index + 1], src2[index + 1], carry);
+        dst[index + 2] = word_add_c(&carry, src1[index + 2], src2[index + 2], carry);
+        dst[index + 3] = word_add_c(&carry, src1[index + 3], src2[index + 3], carry);
+    }
+    for(; index < len; index++)
+    {
+        dst[index] = word_add_c(&carry, src1[index], src2[index], carry);
+    }
+
+    return carry;
+}
+
+/**
+ * @brief Subtracts two word arrays of the same length with one borrow chain.
+ * 
+ * `dst` may equal `src1` or `src2`.
+ * 
+ * @param[out] dst Pointer to the difference `src1 - src2` modulo W^len, `len` words.
+ * @param[in] src1 Pointer to the minuend.
+ * @param[in] src2 Pointer to the subtrahend.
+ * @param[in] len The number of words.
+ * 
+ * @return The borrow out of the top word (1 if src1 < src2).
+ */
+word array_sub_n(OUT word* dst, IN const word* src1, IN const word* src2, IN int len)
+{
+    word borrow = 0;
+    int index = 0;
+
+    for(; index + 4 <= len; index += 4)
+    {
+        dst[index] = word_sub_b(&borrow, src1[index], src2[index], borrow);
+        dst[index + 1] = word_sub_b(&borrow, src1[index + 1], src2[index + 1], borrow);
+        dst[index + 2] = word_sub_b(&borrow, src1[index + 2], src2[index + 2], borrow);
+        dst[index + 3] = word_sub_b(&borrow, src1[index + 3], src2[index + 3], borrow);
+    }
+    for(; index < len; index++)
+    {
+        dst[index] = word_sub_b(&borrow, src1[index], src2[index], borrow);
+    }
+
+    return borrow;
+}
+
+/**
+ * @brief Adds a single word to a word array.
+ * 
+ * The carry is propagated only as far as it reaches; the remaining words are copied
+ * (nothing is written when `dst` equals `src`).
+ * 
+ * @param[out] dst Pointer to the sum, `len` words.
+ * @param[in] src Pointer to the array.
+ * @param[in] len The number of words.
+ * @param[in] w The word to be added.
+ * 
+ * @return The carry out of the top word (0 or 1).
+ */
+word array_add_1(OUT word* dst, IN const word* src, IN int len, IN word w)
+{
+    int index = 0;
+
+    for(; (index < len) && (w != 0); index++)
+    {
+        dst[index] = src[index] + w;
+        w = (dst[index] < w);
+    }
+    if(dst != src)
+    {
+        memmove(dst + index, src + index, sizeof(word) * (len - index));
+    }
+
+    return w;
+}
+
+/**
+ * @brief Subtracts a single word from a word array.
+ * 
+ * The borrow is propagated only as far as it reaches; the remaining words are copied
+ * (nothing is written when `dst` equals `src`).
+ * 
+ * @param[out] dst Pointer to the difference, `len` words.
+ * @param[in] src Pointer to the array.
+ * @param[in] len The number of words.
+ * @param[in] w The word to be subtracted.
+ * 
+ * @return The borrow out of the top word (0 or 1).
+ */
+word array_sub_1(OUT word* dst, IN const word* src, IN int len, IN word w)
+{
+    int index = 0;
+
+    for(; (index < len) && (w != 0); index++)
+    {
+        word s = src[index];
+
+        dst[index] = s - w;
+        w = (s < w);
+    }
+    if(dst != src)
+    {
+        memmove(dst + index, src + index, sizeof(word) * (len - index));
+    }
+
+    return w;
+}
+
+/**
+ * @brief Adds `src * w` to a word array.
+ * 
+ * This is the row operation of schoolbook multiplication and of Montgomery reduction; the
+ * variant for the CPU comes from `cpu_kernels_get`.
+ * 
+ * @param[inout] dst Pointer to the accumulator, `len` words.
+ * @param[in] src Pointer to the array to be multiplied.
+ * @param[in] len The number of words.
+ * @param[in] w The word multiplier.
+ * 
+ * @return The carry word out of the top of `dst`.
+ */
+word array_addmul_1(INOUT word* dst, IN const word* src, IN int len, IN word w)
+{
+    return cpu_kernels_get()->addmul_1(dst, src, len, w);
+}
+
+/**
+ * @brief Multiplies two word arrays by schoolbook multiplication.
+ * 
+ * `dst` must not overlap either source; the variant for the CPU comes from `cpu_kernels_get`.
+ * 
+ * @param[out] dst Pointer to the product, `len1 + len2` words.
+ * @param[in] src1 Pointer to the first factor, `len1` words.
+ * @param[in] len1 The number of words of `src1`.
+ * @param[in] src2 Pointer to the second factor, `len2` words (at least 1).
+ * @param[in] len2 The number of words of `src2`.
+ * 
+ * @return void
+ */
+void array_mul_basecase(OUT word* dst, IN const word* src1, IN int len1, IN const word* src2, IN int len2)
+{
+    cpu_kernels_get()->mul_basecase(dst, src1, len1, src2, len2);
+}
+
+/***********************************************
+ * Kernel Variants
+ ***********************************************/
+/**
+ * @brief `addmul_1` in portable C, one `word_mul_add` per word.
+ */
+static word addmul_1_generic(INOUT word* dst, IN const word* src, IN int len, IN word w)
+{
+    word carry = 0;
+
+    for(int index = 0; index < len; index++)
+    {
+        dst[index] = word_mul_add(&carry, w, src[index], dst[index], carry);
+    }
+    return carry;
+}
+
+/**
+ * @brief `mul_basecase` in portable C: one row of `word_mul_add` per word of `src1`.
+ */
+static void mul_basecase_generic(OUT word* dst, IN const word* src1, IN int len1, IN const word* src2, IN int len2)
+{
+    array_init(dst, len2);
+    for(int idx1 = 0; idx1 < len1; idx1++)
+    {
+        dst[idx1 + len2] = addmul_1_generic(dst + idx1, src2, len2, src1[idx1]);
+    }
+}
+
+/**
+ * @brief `array_lshift` with two-word SSE2 funnel shifts on x86-64, one word at a time elsewhere.
+ */
+static word lshift_generic(OUT word* dst, IN const word* src, IN int src_len, IN int num_bits)
+{
+    int num_words = num_bits / SIZEOFWORD;
+    int bits = num_bits % SIZEOFWORD;
+    word* out = dst + num_words;
+    word carry = 0;
+    int index = src_len - 1;
+
+    if(bits == 0)
+    {
+        memmove(out, src, sizeof(word) * src_len);
+        array_init(dst, num_words);
+        return 0;
+    }
+
+    carry = src[src_len - 1] >> (SIZEOFWORD - bits);
+#if ARRAY_SHIFT_SSE2 == 1
+    {
+        __m128i left = _mm_cvtsi32_si128(bits);
+        __m128i right = _mm_cvtsi32_si128(SIZEOFWORD - bits);
+
+        for(; index >= 2; index -= 2)
+        {
+            __m128i hi = _mm_loadu_si128((const __m128i*)(src + index - 1));
+            __m128i lo = _mm_loadu_si128((const __m128i*)(src + index - 2));
+
+            _mm_storeu_si128((__m128i*)(out + index - 1), _mm_or_si128(_mm_sll_epi64(hi, left), _mm_srl_epi64(lo, right)));
+        }
+    }
+#endif
+    for(; index > 0; index--)
+    {
+        out[index] = (src[index] << bits) | (src[index - 1] >> (SIZEOFWORD - bits));
+    }
+    out[0] = src[0] << bits;
+    array_init(dst, num_words);
+
+    return carry;
+}
+
+/**
+ * @brief `array_rshift` with two-word SSE2 funnel shifts on x86-64, one word at a time elsewhere.
+ */
+static void rshift_generic(OUT word* dst, IN const word* src, IN int src_len, IN int num_bits)
+{
+    int num_words = num_bits / SIZEOFWORD;
+    int bits = num_bits % SIZEOFWORD;
+    int dst_len = src_len - num_words;
+    const word* in = src + num_words;
+    int index = 0;
+
+    if(bits == 0)
+    {
+        memmove(dst, in, sizeof(word) * dst_len);
+        return;
+    }
+
+#if ARRAY_SHIFT_SSE2 == 1
+    {
+        __m128i left = _mm_cvtsi32_si128(SIZEOFWORD - bits);
+        __m128i right = _mm_cvtsi32_si128(bits);
+
+        for(; index + 2 < dst_len; index += 2)
+        {
+            __m128i lo = _mm_loadu_si128((const __m128i*)(in + index));
+            __m128i hi = _mm_loadu_si128((const __m128i*)(in + index + 1));
+
+            _mm_storeu_si128((__m128i*)(dst + index), _mm_or_si128(_mm_srl_epi64(lo, right), _mm_sll_epi64(hi, left)));
+        }
+    }
+#endif
+    for(; index < dst_len - 1; index++)
+    {
+        dst[index] = (in[index] >> bits) | (in[index + 1] << (SIZEOFWORD - bits));
+    }
+    dst[dst_len - 1] = in[dst_len - 1] >> bits;
+}
+
+#if ARRAY_X86_KERNELS == 1
+/**
+ * @brief `addmul_1` with MULX and two carry chains: ADCX adds the high word of the previous
+ * product to the low word, ADOX adds the result to `dst`.
+ *
+ * Neither chain touches the flags of the other, and the loop control (LEA, JRCXZ) touches
+ * neither. Four words per iteration; the first `len % 4` words are done in C.
+ */
+__attribute__((target("bmi2,adx"))) static word addmul_1_adx(INOUT word* dst, IN const word* src, IN int len, IN word w)
+{
+    int head = len & 3;
+    word carry = 0;
+
+    for(int index = 0; index < head; index++)
+    {
+        dst[index] = word_mul_add(&carry, w, src[index], dst[index], carry);
+    }
+    if(len > head)
+    {
+        long long index = -(long long)(len - head);     //counts up to zero
+        word* d = dst + len;
+        const word* s = src + len;
+        word lo0, hi0, lo1, hi1;
+
+        __asm__ volatile(
+            "xor %%r8d, %%r8d\n\t"                      //r8 = 0, clears CF and OF
+            "1:\n\t"
+            "mulx (%[s],%[i],8), %[lo0], %[hi0]\n\t"
+            "adcx %[carry], %[lo0]\n\t"
+            "adox (%[d],%[i],8), %[lo0]\n\t"
+            "mov %[lo0], (%[d],%[i],8)\n\t"
+            "mulx 8(%[s],%[i],8), %[lo1], %[hi1]\n\t"
+            "adcx %[hi0], %[lo1]\n\t"
+            "adox 8(%[d],%[i],8), %[lo1]\n\t"
+            "mov %[lo1], 8(%[d],%[i],8)\n\t"
+            "mulx 16(%[s],%[i],8), %[lo0], %[hi0]\n\t"
+            "adcx %[hi1], %[lo0]\n\t"
+            "adox 16(%[d],%[i],8), %[lo0]\n\t"
+            "mov %[lo0], 16(%[d],%[i],8)\n\t"
+            "mulx 24(%[s],%[i],8), %[lo1], %[carry]\n\t"
+            "adcx %[hi0], %[lo1]\n\t"
+            "adox 24(%[d],%[i],8), %[lo1]\n\t"
+            "mov %[lo1], 24(%[d],%[i],8)\n\t"
+            "lea 4(%[i]), %[i]\n\t"
+            "jrcxz 2f\n\t"
+            "jmp 1b\n\t"
+            "2:\n\t"
+            "adcx %%r8, %[carry]\n\t"                  //the two chains end in the carry word
+            "adox %%r8, %[carry]\n\t"
+            : [carry] "+&r"(carry), [i] "+&c"(index), [lo0] "=&r"(lo0), [hi0] "=&r"(hi0), [lo1] "=&r"(lo1), [hi1] "=&r"(hi1)
+            : [s] "r"(s), [d] "r"(d), "d"(w)
+            : "r8", "cc", "memory");
+    }
+    return carry;
+}
+
+/**
+ * @brief `mul_basecase` with one `addmul_1_adx` row per word of `src1`.
+ */
+static void mul_basecase_adx(OUT word* dst, IN const word* src1, IN int len1, IN const word* src2, IN int len2)
+{
+    array_init(dst, len2);
+    for(int idx1 = 0; idx1 < len1; idx1++)
+    {
+        dst[idx1 + len2] = addmul_1_adx(dst + idx1, src2, len2, src1[idx1]);
+    }
+}
+
+/**
+ * @brief `array_lshift` with four-word AVX2 funnel shifts.
+ */
+__attribute__((target("avx2"))) static word lshift_avx2(OUT word* dst, IN const word* src, IN int src_len, IN int num_bits)
+{
+    int num_words = num_bits / SIZEOFWORD;
+    int bits = num_bits % SIZEOFWORD;
+    word* out = dst + num_words;
+    int index = src_len - 1;
+    word carry;
+
+    if(bits == 0)
+    {
+        return lshift_generic(dst, src, src_len, num_bits);
+    }
+
+    carry = src[src_len - 1] >> (SIZEOFWORD - bits);
+    {
+        __m128i left = _mm_cvtsi32_si128(bits);
+        __m128i right = _mm_cvtsi32_si128(SIZEOFWORD - bits);
+
+        for(; index >= 4; index -= 4)
+        {
+            __m256i hi = _mm256_loadu_si256((const __m256i*)(src + index - 3));
+            __m256i lo = _mm256_loadu_si256((const __m256i*)(src + index - 4));
+
+            _mm256_storeu_si256((__m256i*)(out + index - 3), _mm256_or_si256(_mm256_sll_epi64(hi, left), _mm256_srl_epi64(lo, right)));
+        }
+    }
+    for(; index > 0; index--)
+    {
+        out[index] = (src[index] << bits) | (src[index - 1] >> (SIZEOFWORD - bits));
+    }
+    out[0] = src[0] << bits;
+    array_init(dst, num_words);
+
+    return carry;
+}
+
+/**
+ * @brief `array_rshift` with four-word AVX2 funnel shifts.
+ */
+__attribute__((target("avx2"))) static void rshift_avx2(OUT word* dst, IN const word* src, IN int src_len, IN int num_bits)
+{
+    int num_words = num_bits / SIZEOFWORD;
+    int bits = num_bits % SIZEOFWORD;
+    int dst_len = src_len - num_words;
+    const word* in = src + num_words;
+    int index = 0;
+
+    if(bits == 0)
+    {
+        rshift_generic(dst, src, src_len, num_bits);
+        return;
+    }
+
+    {
+        __m128i left = _mm_cvtsi32_si128(SIZEOFWORD - bits);
+        __m128i right = _mm_cvtsi32_si128(bits);
+
+        for(; index + 4 < dst_len; index += 4)
+        {
+            __m256i lo = _mm256_loadu_si256((const __m256i*)(in + index));
+            __m256i hi = _mm256_loadu_si256((const __m256i*)(in + index + 1));
+
+            _mm256_storeu_si256((__m256i*)(dst + index), _mm256_or_si256(_mm256_srl_epi64(lo, right), _mm256_sll_epi64(hi, left)));
+        }
+    }
+    for(; index < dst_len - 1; index++)
+    {
+        dst[index] = (in[index] >> bits) | (in[index + 1] << (SIZEOFWORD - bits));
+    }
+    dst[dst_len - 1] = in[dst_len - 1] >> bits;
+}
+
+/**
+ * @brief `array_lshift` with eight-word AVX-512 funnel shifts.
+ */
+__attribute__((target("avx512f"))) static word lshift_avx512(OUT word* dst, IN const word* src, IN int src_len, IN int num_bits)
+{
+    int num_words = num_bits / SIZEOFWORD;
+    int bits = num_bits % SIZEOFWORD;
+    word* out = dst + num_words;
+    int index = src_len - 1;
+    word carry;
+
+    if(bits == 0)
+    {
+        return lshift_generic(dst, src, src_len, num_bits);
+    }
+
+    carry = src[src_len - 1] >> (SIZEOFWORD - bits);
+    {
+        __m128i left = _mm_cvtsi32_si128(bits);
+        __m128i right = _mm_cvtsi32_si128(SIZEOFWORD - bits);
+
+        for(; index >= 8; index -= 8)
+        {
+            __m512i hi = _mm512_loadu_si512((const void*)(src + index - 7));
+            __m512i lo = _mm512_loadu_si512((const void*)(src + index - 8));
+
+            _mm512_storeu_si512((void*)(out + index - 7), _mm512_or_si512(_mm512_sll_epi64(hi, left), _mm512_srl_epi64(lo, right)));
+        }
+    }
+    for(; index > 0; index--)
+    {
+        out[index] = (src[index] << bits) | (src[index - 1] >> (SIZEOFWORD - bits));
+    }
+    out[0] = src[0] << bits;
+    array_init(dst, num_words);
+
+    return carry;
+}
+
+/**
+ * @brief `array_rshift` with eight-word AVX-512 funnel shifts.
+ */
+__attribute__((target("avx512f"))) static void rshift_avx512(OUT word* dst, IN const word* src, IN int src_len, IN int num_bits)
+{
+    int num_words = num_bits / SIZEOFWORD;
+    int bits = num_bits % SIZEOFWORD;
+    int dst_len = src_len - num_words;
+    const word* in = src + num_words;
+    int index = 0;
+
+    if(bits == 0)
+    {
+        rshift_generic(dst, src, src_len, num_bits);
+        return;
+    }
+
+    {
+        __m128i left = _mm_cvtsi32_si128(SIZEOFWORD - bits);
+        __m128i right = _mm_cvtsi32_si128(bits);
+
+        for(; index + 8 < dst_len; index += 8)
+        {
+            __m512i lo = _mm512_loadu_si512((const void*)(in + index));
+            __m512i hi = _mm512_loadu_si512((const void*)(in + index + 1));
+
+            _mm512_storeu_si512((void*)(dst + index), _mm512_or_si512(_mm512_srl_epi64(lo, right), _mm512_sll_epi64(hi, left)));
+        }
+    }
+    for(; index < dst_len - 1; index++)
+    {
+        dst[index] = (in[index] >> bits) | (in[index + 1] << (SIZEOFWORD - bits));
+    }
+    dst[dst_len - 1] = in[dst_len - 1] >> bits;
+}
+#endif
+
+/**
+ * @brief Binds the word array kernels of a `cpu_kernels` table for the given extensions.
+ * 
+ * BMI2 alone gains nothing over the compiler's multiply, so the MULX kernels need ADX too.
+ * 
+ * @param[out] kernels Pointer to the table.
+ * @param[in] features The `CPU_*` flags the kernels may use, all supported by the CPU.
+ * 
+ * @return void
+ */
+void array_kernels_bind(OUT cpu_kernels* kernels, IN int features)
+{
+    kernels->addmul_1 = addmul_1_generic;
+    kernels->mul_basecase = mul_basecase_generic;
+    kernels->lshift = lshift_generic;
+    kernels->rshift = rshift_generic;
+#if ARRAY_X86_KERNELS == 1
+    if((features & CPU_TIER_ADX) == CPU_TIER_ADX)
+    {
+        kernels->addmul_1 = addmul_1_adx;
+        kernels->mul_basecase = mul_basecase_adx;
+    }
+    if(features & CPU_AVX512)
+    {
+        kernels->lshift = lshift_avx512;
+        kernels->rshift = rshift_avx512;
+    }
+    else if(features & CPU_AVX2)
+    {
+        kernels->lshift = lshift_avx2;
+        kernels->rshift = rshift_avx2;
+    }
+#else
+    (void)features;
+#endif
 }
\ No newline at end of file
@@ -3,10 +3,26 @@
 
 #include "dtype.h"
 
-void array_rand(OUT word* dst, IN int word_len);
+msg array_rand(OUT word* dst, IN int word_len);
 
 void array_init(OUT word* a, IN int word_len);
 
 void array_copy(OUT word* dst_arr, IN const word* src_arr, IN int array_len);
 
+word array_lshift(OUT word* dst, IN const word* src, IN int src_len, IN int num_bits);
+
+void array_rshift(OUT word* dst, IN const word* src, IN int src_len, IN int num_bits);
+
+word array_add_n(OUT word* dst, IN const word* src1, IN const word* src2, IN int len);
+
+word array_sub_n(OUT word* dst, IN const word* src1, IN const word* src2, IN int len);
+
+word array_add_1(OUT word* dst, IN const word* src, IN int len, IN word w);
+
+word array_sub_1(OUT word* dst, IN const word* src, IN int len, IN word w);
+
+word array_addmul_1(INOUT word* dst, IN const word* src, IN int len, IN word w);
+
+void array_mul_basecase(OUT word* dst, IN const word* src1, IN int len1, IN const word* src2, IN int len2);
+
 #endif
\ No newline at end of file
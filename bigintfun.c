@@ -7,136 +7,1131 @@
 #include "errormsg.h"
 #include "dtype.h"
 #include "arrayfun.h"
+#include "wordfun.h"
+#include "drbg.h"
+#include "mempool.h"
 #include "operation.h"
 
+#define FORMAT_STACK_LEN    4096    //characters formatted on the stack when printing (15360-bit values in hex)
+
+/* valid hex characters map to (0x10 | digit), everything else to 0 */
+static const byte hex_decode_table[256] = {
+    ['0'] = 0x10, ['1'] = 0x11, ['2'] = 0x12, ['3'] = 0x13, ['4'] = 0x14,
+    ['5'] = 0x15, ['6'] = 0x16, ['7'] = 0x17, ['8'] = 0x18, ['9'] = 0x19,
+    ['a'] = 0x1a, ['b'] = 0x1b, ['c'] = 0x1c, ['d'] = 0x1d, ['e'] = 0x1e, ['f'] = 0x1f,
+    ['A'] = 0x1a, ['B'] = 0x1b, ['C'] = 0x1c, ['D'] = 0x1d, ['E'] = 0x1e, ['F'] = 0x1f
+};
+
+/* two lowercase hex characters for every byte value */
+static const char hex_pair_table[] =
+    "000102030405060708090a0b0c0d0e0f"
+    "101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f"
+    "303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f"
+    "505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f"
+    "707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f"
+    "909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+    "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+    "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+    "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+/**
+ * @brief Decodes up to one word of hex characters.
+ * 
+ * The characters are accumulated without branching on their value; validity is checked once
+ * for the whole chunk.
+ * 
+ * @param[out] dst Pointer to the decoded word.
+ * @param[in] str Pointer to the first (most significant) character of the chunk.
+ * @param[in] len The number of characters (at most 2 * sizeof(word)).
+ * 
+ * @return Returns 1 on success, -1 if the chunk contains a non-hex character.
+ */
+static msg hex_decode_word(OUT word* dst, IN const char* str, IN int len)
+{
+    word w = 0;
+    byte valid = 0x10;
+
+    for(int i = 0; i < len; i++)
+    {
+        byte d = hex_decode_table[(byte)str[i]];
+        valid &= d;
+        w = (word)(w << 4) | (d & 0xf);
+    }
+    *dst = w;
+
+    return (valid != 0) ? SUCCESS : FAILED;
+}
+
+/**
+ * @brief Encodes one word as 2 * sizeof(word) hex characters, most significant first.
+ * 
+ * @param[out] dst Pointer to the output characters.
+ * @param[in] w The word to be encoded.
+ */
+static void hex_encode_word(OUT char* dst, IN word w)
+{
+    for(int byte_index = sizeof(word) - 1; byte_index >= 0; byte_index--)
+    {
+        memcpy(dst, &hex_pair_table[2 * ((w >> (8 * byte_index)) & 0xff)], 2);
+        dst += 2;
+    }
+}
+
+/* largest power of 10 that fits in a word; decimal strings are converted in chunks of this size */
+#if SIZEOFWORD == 64
+    #define DEC_CHUNK           (word)10000000000000000000ULL
+    #define DEC_CHUNK_DIGITS    19
+    #define DEC_CHUNK_INV       (word)0xd83c94fb6d2ac34aULL    //floor((2^128 - 1) / 10^19) - 2^64
+#elif SIZEOFWORD == 32
+    #define DEC_CHUNK           (word)1000000000
+    #define DEC_CHUNK_DIGITS    9
+#elif SIZEOFWORD == 8
+    #define DEC_CHUNK           (word)100
+    #define DEC_CHUNK_DIGITS    2
+#endif
+#define DEC_MAX_LEVEL       32    //DEC_CHUNK^(2^level) powers kept for divide and conquer
+#define DEC_DC_LEAF         (DEC_DC_FLAG / 4)   //word_len below which divide and conquer converts directly
+
+/**
+ * @brief Divides the double word (hi, lo) by DEC_CHUNK.
+ * 
+ * With 64-bit words 10^19 is already normalized (top bit set), so the division uses its
+ * precomputed reciprocal (Moller-Granlund) instead of a 128-bit division call.
+ * 
+ * @param[out] rem Pointer to the remainder.
+ * @param[in] hi The upper word of the dividend (must be less than DEC_CHUNK).
+ * @param[in] lo The lower word of the dividend.
+ * 
+ * @return The quotient.
+ */
+static word dec_div_rem(OUT word* rem, IN word hi, IN word lo)
+{
+#if SIZEOFWORD == 64
+    word t_hi;
+    word t_lo = word_mul_add(&t_hi, DEC_CHUNK_INV, hi, lo, 0);
+    word q = t_hi + hi + 1;
+    word r = lo - q * DEC_CHUNK;
+
+    if(r > t_lo)
+    {
+        q--;
+        r += DEC_CHUNK;
+    }
+    if(r >= DEC_CHUNK)
+    {
+        q++;
+        r -= DEC_CHUNK;
+    }
+    *rem = r;
+    return q;
+#elif HAVE_DWORD == 1
+    dword t = ((dword)hi << SIZEOFWORD) | lo;
+
+    *rem = (word)(t % DEC_CHUNK);
+    return (word)(t / DEC_CHUNK);
+#else
+    word q = 0;
+    word r = hi;
+
+    for(int j = SIZEOFWORD - 1; j >= 0; j--)
+    {
+        word top = r >> (SIZEOFWORD - 1);
+        r = (r << 1) | ((lo >> j) & 1);
+        q <<= 1;
+        if(top || (r >= DEC_CHUNK))
+        {
+            r -= DEC_CHUNK;
+            q |= 1;
+        }
+    }
+    *rem = r;
+    return q;
+#endif
+}
+
+/**
+ * @brief Returns DEC_CHUNK^(2^level), squaring the previous level on first use.
+ * 
+ * @param[inout] pow Array of DEC_MAX_LEVEL cached powers (NULL when not computed yet).
+ * @param[in] level The level of the power.
+ * 
+ * @return Pointer to the power, or NULL on failure.
+ */
+static bigint* dec_get_pow(INOUT bigint** pow, IN int level)
+{
+    if(pow[level] == NULL)
+    {
+        if(level == 0)
+        {
+            word chunk = DEC_CHUNK;
+            if(bi_set_from_array(&pow[0], POSITIVE, 1, &chunk) == FAILED)
+            {
+                return NULL;
+            }
+        }
+        else if((dec_get_pow(pow, level - 1) == NULL) || (bi_squ_kara(&pow[level], pow[level - 1]) == FAILED))
+        {
+            return NULL;
+        }
+        else
+        {
+            pow[level]->sign = POSITIVE;
+        }
+    }
+    return pow[level];
+}
+
+/**
+ * @brief Frees an array of DEC_MAX_LEVEL cached powers or Barrett constants.
+ */
+static void dec_clear_pow(INOUT bigint** pow)
+{
+    for(int level = 0; level < DEC_MAX_LEVEL; level++)
+    {
+        if(pow[level] != NULL)
+        {
+            bi_delete(&pow[level]);
+        }
+    }
+}
+
+/**
+ * @brief Returns the Barrett constant T = floor(W^(2n) / P) of P = DEC_CHUNK^(2^level), computing it on first use.
+ * 
+ * n is the word length of P. As P is the square of the previous power, the square of the previous
+ * constant is already within a relative error of about W^(-n/2) below T; one Newton step and a few
+ * increments make it exact with multiplications only. Level 0 (one word) is divided directly.
+ * 
+ * @param[inout] pow Array of DEC_MAX_LEVEL cached powers.
+ * @param[inout] pow_inv Array of DEC_MAX_LEVEL cached Barrett constants (NULL when not computed yet).
+ * @param[in] level The level of the power.
+ * 
+ * @return Pointer to the constant, or NULL on failure.
+ */
+static bigint* dec_get_pow_inv(INOUT bigint** pow, INOUT bigint** pow_inv, IN int level)
+{
+    msg error_msg = SUCCESS;
+    bigint* N = NULL;
+    bigint* S = NULL;
+    bigint* X = NULL;
+    bigint* E = NULL;
+    bigint* temp = NULL;
+    bigint* one = NULL;
+    word one_word = 1;
+    int n = 0;
+
+    if(pow_inv[level] != NULL)
+    {
+        return pow_inv[level];
+    }
+    N = dec_get_pow(pow, level);
+    if((N == NULL) || (bi_new(&S, 2 * N->word_len + 1) == FAILED))
+    {
+        return NULL;
+    }
+    n = N->word_len;
+    S->a[2 * n] = 1;        //S = W^(2n)
+    S->sign = POSITIVE;
+
+    if(level == 0)
+    {
+        error_msg = bi_word_division(&X, &temp, S, N);
+    }
+    else if((dec_get_pow_inv(pow, pow_inv, level - 1) == NULL) || (bi_squ_kara(&X, pow_inv[level - 1]) == FAILED))
+    {
+        error_msg = FAILED;
+    }
+    else
+    {
+        // X = T'^2 / W^(4m - 2n) <= T for the constant T' of the m-word previous power, then
+        // X += X * (S - N * X) / S, which stays at most T and leaves it a few units short
+        X->sign = POSITIVE;
+        bi_bit_rshift(X, (4 * pow[level - 1]->word_len - 2 * n) * SIZEOFWORD);
+        if((bi_mul_kara(&temp, N, X) == FAILED) || (bi_sub(&E, S, temp) == FAILED) ||
+            (bi_mul_kara(&temp, X, E) == FAILED) || (bi_bit_rshift(temp, 2 * n * SIZEOFWORD) == FAILED) ||
+            (bi_add(&X, X, temp) == FAILED) ||
+            (bi_mul_kara(&temp, N, X) == FAILED) || (bi_sub(&E, S, temp) == FAILED) ||
+            (bi_set_from_array(&one, POSITIVE, 1, &one_word) == FAILED))
+        {
+            error_msg = FAILED;
+        }
+        while((error_msg == SUCCESS) && (bi_compare(E, N) >= 0))
+        {
+            if((bi_sub(&E, E, N) == FAILED) || (bi_add(&X, X, one) == FAILED))
+            {
+                error_msg = FAILED;
+            }
+        }
+    }
+    if(error_msg == SUCCESS)
+    {
+        pow_inv[level] = X;
+        X = NULL;
+    }
+    bi_delete(&S);
+    bi_delete(&X);
+    bi_delete(&E);
+    bi_delete(&temp);
+    bi_delete(&one);
+
+    return pow_inv[level];
+}
+
+/**
+ * @brief Computes quotient and remainder of A / N with Barrett reduction.
+ * 
+ * A must be non-negative and below W^(2n), where n is the word length of N, and T must be
+ * the Barrett constant floor(W^(2n) / N) (see `dec_get_pow_inv`).
+ * 
+ * @param[out] quotient Pointer to the quotient.
+ * @param[out] remainder Pointer to the remainder.
+ * @param[in] A The dividend.
+ * @param[in] N The divisor.
+ * @param[in] T The Barrett constant of N.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+static msg dec_barrett_divmod(OUT bigint** quotient, OUT bigint** remainder, IN const bigint* A, IN const bigint* N, IN const bigint* T)
+{
+    msg error_msg = SUCCESS;
+    int n = N->word_len;
+    bigint* shifted = NULL;
+    bigint* temp = NULL;
+    bigint* one = NULL;
+    word one_word = 1;
+
+    // Q = ((A >> w(n-1)) * T) >> w(n+1), at most two below the exact quotient
+    bi_assign(&shifted, A);
+    bi_bit_rshift(shifted, (n - 1) * SIZEOFWORD);
+    bi_mul_kara(&temp, shifted, T);
+    bi_bit_rshift(temp, (n + 1) * SIZEOFWORD);
+    bi_assign(quotient, temp);
+
+    bi_mul_kara(&temp, N, *quotient);
+    bi_sub(remainder, A, temp);
+
+    bi_set_from_array(&one, POSITIVE, 1, &one_word);
+    while(bi_compare(*remainder, N) >= 0)
+    {
+        bi_sub(remainder, *remainder, N);
+        bi_add(quotient, *quotient, one);
+    }
+
+    bi_delete(&shifted);
+    bi_delete(&temp);
+    bi_delete(&one);
+
+    return error_msg;
+}
+
+/**
+ * @brief Writes exactly `width` decimal digits of a small bigint by repeated single-word division.
+ * 
+ * @param[out] dst Pointer to the output digits (zero padded on the left).
+ * @param[in] width The number of digits to be written (the value must fit).
+ * @param[in] src Pointer to the non-negative `bigint` to be converted.
+ * @param[in] buf Scratch array of at least `src->word_len` words.
+ */
+static void dec_encode_base(OUT char* dst, IN int width, IN const bigint* src, IN word* buf)
+{
+    int len = src->word_len;
+    int pos = width;
+
+    memcpy(buf, src->a, len * sizeof(word));
+    while((len > 0) && (buf[len - 1] == 0))
+    {
+        len--;
+    }
+    while((len > 0) && (pos > 0))
+    {
+        word rem = 0;
+
+        for(int i = len - 1; i >= 0; i--)
+        {
+            buf[i] = dec_div_rem(&rem, rem, buf[i]);
+        }
+        while((len > 0) && (buf[len - 1] == 0))
+        {
+            len--;
+        }
+        for(int i = 0; (i < DEC_CHUNK_DIGITS) && (pos > 0); i++)
+        {
+            dst[--pos] = (char)('0' + rem % 10);
+            rem /= 10;
+        }
+    }
+    memset(dst, '0', pos);
+}
+
+/**
+ * @brief Writes exactly DEC_CHUNK_DIGITS * 2^(level+1) decimal digits of src (src < DEC_CHUNK^(2^(level+1))).
+ * 
+ * Large values are split by DEC_CHUNK^(2^level) into a high and a low half, which are converted
+ * recursively; small values fall back to `dec_encode_base`.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+static msg dec_encode_rec(OUT char* dst, IN const bigint* src, IN int level, INOUT bigint** pow, INOUT bigint** pow_inv, IN word* buf)
+{
+    int half = DEC_CHUNK_DIGITS << level;
+    msg error_msg = SUCCESS;
+    bigint* quotient = NULL;
+    bigint* remainder = NULL;
+
+    if((level == 0) || (src->word_len < DEC_DC_LEAF))
+    {
+        dec_encode_base(dst, 2 * half, src, buf);
+        return SUCCESS;
+    }
+
+    if(dec_get_pow_inv(pow, pow_inv, level) == NULL)
+    {
+        return FAILED;
+    }
+    error_msg = dec_barrett_divmod(&quotient, &remainder, src, pow[level], pow_inv[level]);
+    if(error_msg == SUCCESS)
+    {
+        error_msg = dec_encode_rec(dst, quotient, level - 1, pow, pow_inv, buf);
+    }
+    if(error_msg == SUCCESS)
+    {
+        error_msg = dec_encode_rec(dst + half, remainder, level - 1, pow, pow_inv, buf);
+    }
+    bi_delete(&quotient);
+    bi_delete(&remainder);
+
+    return error_msg;
+}
+
+/**
+ * @brief Converts up to DEC_DC_FLAG chunks of decimal digits with a linear multiply-add pass per chunk.
+ * 
+ * @return Returns 1 on success, -1 on failure (e.g., a non-decimal character).
+ */
+static msg dec_decode_base(OUT bigint** dst, IN const char* str, IN int len)
+{
+    int chunk_len = (len - 1) % DEC_CHUNK_DIGITS + 1;
+    int word_len = 1;
+
+    if(bi_new(dst, (len + DEC_CHUNK_DIGITS - 1) / DEC_CHUNK_DIGITS + 1) == FAILED)
+    {
+        return FAILED;
+    }
+    for(int pos = 0; pos < len; pos += chunk_len, chunk_len = DEC_CHUNK_DIGITS)
+    {
+        word chunk = 0;
+        word mul = 1;
+        word carry = 0;
+
+        for(int i = 0; i < chunk_len; i++)
+        {
+            word digit = (word)(str[pos + i] - '0');
+            if(digit > 9)
+            {
+                fprintf(stderr, ERR_INVALID_INPUT);
+                bi_delete(dst);
+                return FAILED;
+            }
+            chunk = chunk * 10 + digit;
+            mul *= 10;
+        }
+
+        carry = chunk;
+        for(int i = 0; i < word_len; i++)
+        {
+            (*dst)->a[i] = word_mul_add(&carry, (*dst)->a[i], mul, carry, 0);
+        }
+        if(carry != 0)
+        {
+            (*dst)->a[word_len++] = carry;
+        }
+    }
+    (*dst)->sign = POSITIVE;
+
+    return bi_refine(*dst);
+}
+
+/**
+ * @brief Converts a decimal digit string, splitting long strings into a high part and a low
+ *        part of DEC_CHUNK_DIGITS * 2^level digits that are combined by one multiplication.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+static msg dec_decode_rec(OUT bigint** dst, IN const char* str, IN int len, INOUT bigint** pow)
+{
+    int level = 0;
+    int low_len = 0;
+    msg error_msg = SUCCESS;
+    bigint* high = NULL;
+    bigint* low = NULL;
+    bigint* temp = NULL;
+
+    if(len <= DEC_CHUNK_DIGITS * DEC_DC_LEAF)
+    {
+        return dec_decode_base(dst, str, len);
+    }
+
+    while((DEC_CHUNK_DIGITS << (level + 1)) < len)
+    {
+        level++;
+    }
+    low_len = DEC_CHUNK_DIGITS << level;
+
+    if((dec_get_pow(pow, level) == NULL) ||
+        (dec_decode_rec(&high, str, len - low_len, pow) == FAILED) ||
+        (dec_decode_rec(&low, str + len - low_len, low_len, pow) == FAILED) ||
+        (bi_mul_kara(&temp, high, pow[level]) == FAILED) ||
+        (bi_add(dst, temp, low) == FAILED))
+    {
+        error_msg = FAILED;
+    }
+    bi_delete(&high);
+    bi_delete(&low);
+    bi_delete(&temp);
+
+    return error_msg;
+}
+
+/**
+ * @brief Initializes a bigint structure from an array of words.
+ * 
+ * This function converts an array of words into a `bigint` structure and stores it in the specified location.
+ * 
+ * @param[out] dst Pointer to a double pointer of `bigint`, where the converted bigint will be stored.
+ * @param[in] sign The sign of the bigint (POSITIVE or NEGATIVE).
+ * @param[in] word_len The length of the input array.
+ * @param[in] a Pointer to the input array of words.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_set_from_array(OUT bigint** dst, IN int sign, IN int word_len, IN const word* a)
+{
+    bi_new(dst, word_len);
+    for (int i = 0; i < word_len; i++){
+        (*dst) -> a[i] = a[i];
+    }
+    (*dst) -> sign = sign;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Converts a string to a bigint structure.
+ * 
+ * This function converts a given string representation of an integer into a `bigint` structure.
+ * A leading '-' marks a negative value. Hex strings are decoded one word at a time; decimal
+ * strings in chunks of DEC_CHUNK_DIGITS digits, and by divide and conquer from DEC_DC_FLAG words.
+ * 
+ * @param[out] dst Pointer to a double pointer of `bigint`, where the converted bigint will be stored.
+ * @param[in] int_str Pointer to the input string representing the integer.
+ * @param[in] base The base of the input string (valid values are 2, 10, 16).
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_set_from_string(OUT bigint** dst, IN const char* int_str, IN int base)
+{
+    const char* digits = int_str;
+    int sign = POSITIVE;
+    int word_len = 0;
+    int strlength = 0;
+
+    if((dst == NULL) || (int_str == NULL) || !(base == 2 || base == 10 || base == 16))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    if(digits[0] == '-')
+    {
+        sign = NEGATIVE;
+        digits++;
+    }
+    strlength = (int)strlen(digits);
+    if(strlength == 0)
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    if(base == 2)
+    {
+        word_len = (strlength + SIZEOFWORD - 1) / SIZEOFWORD;
+        if(bi_new(dst, word_len) == FAILED)
+        {
+            return FAILED;
+        }
+        for(int i = 0; i < strlength; i++)
+        {
+            char c = digits[strlength - i - 1];
+            if(c == '1')
+            {
+                (*dst)->a[i / SIZEOFWORD] |= (word)1 << (i % SIZEOFWORD);
+            }
+            else if(c != '0')
+            {
+                fprintf(stderr, ERR_INVALID_INPUT);
+                bi_delete(dst);
+                return FAILED;
+            }
+        }
+    }
+    else if(base == 10)
+    {
+        bigint* pow[DEC_MAX_LEVEL] = {NULL};
+        msg error_msg = (strlength <= DEC_CHUNK_DIGITS * DEC_DC_FLAG) ? dec_decode_base(dst, digits, strlength)
+                                                                       : dec_decode_rec(dst, digits, strlength, pow);
+
+        dec_clear_pow(pow);
+        if(error_msg == FAILED)
+        {
+            return FAILED;
+        }
+    }
+    else
+    {
+        int word_chars = 2 * sizeof(word);
+
+        word_len = (strlength + word_chars - 1) / word_chars;
+        if(bi_new(dst, word_len) == FAILED)
+        {
+            return FAILED;
+        }
+        for(int word_index = 0; word_index < word_len; word_index++)
+        {
+            int end = strlength - word_index * word_chars;
+            int len = (end < word_chars) ? end : word_chars;
+
+            if(hex_decode_word(&(*dst)->a[word_index], digits + end - len, len) == FAILED)
+            {
+                fprintf(stderr, ERR_INVALID_INPUT);
+                bi_delete(dst);
+                return FAILED;
+            }
+        }
+    }
+    (*dst)->sign = sign;
+    bi_refine(*dst);
+
+    return SUCCESS;
+}
+
+
+/**
+ * @brief Writes the magnitude of a bigint as lowercase hex digits into a caller buffer.
+ * 
+ * The digits are written without sign, prefix or leading zeros ("0" for zero) and are
+ * terminated with '\0'. A buffer of `2 * sizeof(word) * src->word_len + 1` characters is always
+ * large enough.
+ * 
+ * @param[out] dst Pointer to the output buffer.
+ * @param[in] dst_len The size of the output buffer in characters.
+ * @param[in] src Pointer to the `bigint` structure to be encoded.
+ * 
+ * @return The number of digits written (excluding '\0'), or -1 on failure.
+ */
+int bi_hex_encode(OUT char* dst, IN int dst_len, IN const bigint* src)
+{
+    int top_chars = 0;
+    int len = 0;
+    word top = 0;
+    char top_buf[2 * sizeof(word)];
+
+    if((dst == NULL) || (src == NULL) || (src->a == NULL) || (src->word_len <= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    top = src->a[src->word_len - 1];
+    for(top_chars = 1; (top_chars < 2 * (int)sizeof(word)) && ((top >> (4 * top_chars)) != 0); top_chars++);
+    len = top_chars + (src->word_len - 1) * 2 * (int)sizeof(word);
+    if(dst_len < len + 1)
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    hex_encode_word(top_buf, top);
+    memcpy(dst, top_buf + 2 * sizeof(word) - top_chars, top_chars);
+    for(int word_index = src->word_len - 2, pos = top_chars; word_index >= 0; word_index--, pos += 2 * sizeof(word))
+    {
+        hex_encode_word(dst + pos, src->a[word_index]);
+    }
+    dst[len] = '\0';
+
+    return len;
+}
+
+
+/**
+ * @brief Writes the magnitude of a bigint as decimal digits into a caller buffer.
+ * 
+ * The digits are written without sign or leading zeros ("0" for zero) and are terminated
+ * with '\0'. A buffer of `(uint64_t)SIZEOFWORD * src->word_len * 30103 / 100000 + 2` characters
+ * (the product taken in 64 bits) is always large enough. Values from DEC_DC_FLAG words are split
+ * recursively by the powers DEC_CHUNK^(2^k), using Barrett reduction for each split; the Barrett
+ * constants come from Newton steps (`dec_get_pow_inv`), so a split costs a few multiplications.
+ * 
+ * @param[out] dst Pointer to the output buffer.
+ * @param[in] dst_len The size of the output buffer in characters.
+ * @param[in] src Pointer to the `bigint` structure to be encoded.
+ * 
+ * @return The number of digits written (excluding '\0'), or -1 on failure.
+ */
+int bi_dec_encode(OUT char* dst, IN int dst_len, IN const bigint* src)
+{
+    char stack_digits[FORMAT_STACK_LEN];
+    word stack_words[FORMAT_STACK_LEN / DEC_CHUNK_DIGITS];
+    char* digits = stack_digits;
+    word* buf = stack_words;
+    bigint* pow[DEC_MAX_LEVEL] = {NULL};
+    bigint* pow_inv[DEC_MAX_LEVEL] = {NULL};
+    bigint magnitude;
+    int level = -1;
+    int width = 0;
+    int start = 0;
+    msg error_msg = SUCCESS;
+
+    if((dst == NULL) || (src == NULL) || (src->a == NULL) || (src->word_len <= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    magnitude = *src;    //shares the words of src, only the sign differs
+    magnitude.sign = POSITIVE;
+
+    if(src->word_len < DEC_DC_FLAG)
+    {
+        // every chunk holds more than 3 * DEC_CHUNK_DIGITS bits (10 > 2^3), so this many chunks always suffice
+        width = DEC_CHUNK_DIGITS * (SIZEOFWORD * src->word_len / (3 * DEC_CHUNK_DIGITS) + 2);
+    }
+    else
+    {
+        // smallest level with src < DEC_CHUNK^(2^(level+1))
+        for(level = 0; error_msg == SUCCESS; level++)
+        {
+            if((dec_get_pow(pow, level) == NULL) || (dec_get_pow(pow, level + 1) == NULL))
+            {
+                error_msg = FAILED;
+            }
+            else if(bi_compare(pow[level + 1], &magnitude) > 0)
+            {
+                break;
+            }
+        }
+        width = DEC_CHUNK_DIGITS << (level + 1);
+    }
+
+    if((width > FORMAT_STACK_LEN) || (src->word_len > FORMAT_STACK_LEN / DEC_CHUNK_DIGITS))
+    {
+        digits = (char*)malloc(width);
+        buf = (word*)malloc(src->word_len * sizeof(word));
+        if((digits == NULL) || (buf == NULL))
+        {
+            fprintf(stderr, ERR_MEMORY_ALLOCATION);
+            error_msg = FAILED;
+        }
+    }
+    if(error_msg == SUCCESS)
+    {
+        if(level < 0)
+        {
+            dec_encode_base(digits, width, src, buf);
+        }
+        else
+        {
+            error_msg = dec_encode_rec(digits, &magnitude, level, pow, pow_inv, buf);
+        }
+    }
+    dec_clear_pow(pow);
+    dec_clear_pow(pow_inv);
+
+    if(error_msg == SUCCESS)
+    {
+        while((start < width - 1) && (digits[start] == '0'))
+        {
+            start++;
+        }
+        if(dst_len < width - start + 1)
+        {
+            fprintf(stderr, ERR_INVALID_INPUT);
+            error_msg = FAILED;
+        }
+        else
+        {
+            memcpy(dst, digits + start, width - start);
+            dst[width - start] = '\0';
+        }
+    }
+    if(digits != stack_digits)
+    {
+        free(digits);
+        free(buf);
+    }
+
+    return (error_msg == SUCCESS) ? width - start : FAILED;
+}
+
+
+/**
+ * @brief Returns the buffer size needed to format a bigint with `bi_format`.
+ * 
+ * The size includes the sign, the base prefix and the terminating '\0'. It is exact for
+ * bases 2 and 16 and an upper bound for base 10.
+ * 
+ * @param[in] src Pointer to the `bigint` structure to be formatted.
+ * @param[in] base The base of the output (valid values are 2, 10, 16).
+ * 
+ * @return The buffer size in characters, or -1 on failure.
+ */
+int bi_format_len(IN const bigint* src, IN int base)
+{
+    int top_bits = 0;
+    int len = 0;
+
+    if((src == NULL) || (src->a == NULL) || (src->word_len <= 0) || !(base == 2 || base == 10 || base == 16))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    for(top_bits = SIZEOFWORD; (top_bits > 1) && (((src->a[src->word_len - 1] >> (top_bits - 1)) & 1) == 0); top_bits--);
+    if(base == 2)
+    {
+        len = 2 + top_bits + (src->word_len - 1) * SIZEOFWORD;
+    }
+    else if(base == 16)
+    {
+        len = 2 + (top_bits + 3) / 4 + (src->word_len - 1) * 2 * (int)sizeof(word);
+    }
+    else
+    {
+        len = (int)((uint64_t)SIZEOFWORD * src->word_len * 30103 / 100000 + 1);    //in 64 bits: the product overflows an int above 71k bits
+    }
+
+    return len + (src->sign == NEGATIVE) + 1;
+}
+
+
+/**
+ * @brief Formats a bigint as text into a caller buffer.
+ * 
+ * The output is the sign ('-' for negative values), the prefix "0b" or "0x" for bases 2 and 16,
+ * and the digits without leading zeros, terminated with '\0' (e.g. "-0x1f", "0b0", "42").
+ * No stdio calls or heap allocations are made for bases 2 and 16.
+ * 
+ * @param[out] dst Pointer to the output buffer.
+ * @param[in] dst_len The size of the output buffer (at least `bi_format_len(src, base)`).
+ * @param[in] src Pointer to the `bigint` structure to be formatted.
+ * @param[in] base The base of the output (valid values are 2, 10, 16).
+ * 
+ * @return The number of characters written (excluding '\0'), or -1 on failure.
+ */
+int bi_format(OUT char* dst, IN int dst_len, IN const bigint* src, IN int base)
+{
+    int need_len = bi_format_len(src, base);
+    int pos = 0;
+    int len = 0;
+
+    if((dst == NULL) || (need_len == FAILED) || (dst_len < need_len))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    if(src->sign == NEGATIVE)
+    {
+        dst[pos++] = '-';
+    }
+    if(base == 2)
+    {
+        dst[pos++] = '0';
+        dst[pos++] = 'b';
+        len = need_len - pos - 1;
+        for(int bit_index = 0; bit_index < len; bit_index++)
+        {
+            dst[pos + len - 1 - bit_index] = (char)('0' + ((src->a[bit_index / SIZEOFWORD] >> (bit_index % SIZEOFWORD)) & 1));
+        }
+        dst[pos + len] = '\0';
+    }
+    else if(base == 16)
+    {
+        dst[pos++] = '0';
+        dst[pos++] = 'x';
+        len = bi_hex_encode(dst + pos, dst_len - pos, src);
+    }
+    else
+    {
+        len = bi_dec_encode(dst + pos, dst_len - pos, src);
+    }
+
+    return (len == FAILED) ? FAILED : pos + len;
+}
+
+
+/**
+ * @brief Formats a bigint followed by a newline and writes it to a file with one fwrite.
+ * 
+ * The text is formatted into a stack buffer; only values that do not fit use the heap.
+ * 
+ * @param[in] file Pointer to the `FILE` where the bigint will be printed.
+ * @param[in] src Pointer to the `bigint` structure to be printed.
+ * @param[in] base The base of the output (valid values are 2, 10, 16).
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+static msg bi_write(IN FILE* file, IN const bigint* src, IN int base)
+{
+    char stack_buf[FORMAT_STACK_LEN];
+    char* buf = stack_buf;
+    int buf_len = bi_format_len(src, base);
+    int len = 0;
+
+    if(buf_len == FAILED)
+    {
+        return FAILED;
+    }
+    if(buf_len > FORMAT_STACK_LEN)
+    {
+        buf = (char*)malloc(buf_len);
+        if(buf == NULL)
+        {
+            fprintf(stderr, ERR_MEMORY_ALLOCATION);
+            return FAILED;
+        }
+    }
+
+    len = bi_format(buf, buf_len, src, base);
+    if(len != FAILED)
+    {
+        buf[len] = '\n';    //replaces the terminating '\0'
+        if(fwrite(buf, 1, len + 1, file) != (size_t)(len + 1))
+        {
+            len = FAILED;
+        }
+    }
+    if(buf != stack_buf)
+    {
+        free(buf);
+    }
+
+    return (len != FAILED) ? SUCCESS : FAILED;
+}
+
+
+/**
+ * @brief Converts a byte string to a non-negative bigint (OS2IP).
+ * 
+ * This function reads `byte_len` bytes in the given byte order directly into the
+ * words of a new bigint, without going through a text representation. When the host
+ * layout (`ENDIAN`) matches the byte order the bytes are copied with one memcpy.
+ * 
+ * @param[out] dst Pointer to a double pointer of `bigint`, where the converted bigint will be stored.
+ * @param[in] src Pointer to the input bytes.
+ * @param[in] byte_len The number of input bytes.
+ * @param[in] order The byte order of `src` (BYTES_BIG or BYTES_LITTLE).
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_set_from_bytes(OUT bigint** dst, IN const byte* src, IN int byte_len, IN int order)
+{
+    int word_len = 0;
+    int full_len = 0;
+
+    if((dst == NULL) || ((src == NULL) && (byte_len > 0)) || (byte_len < 0) || ((order != BYTES_BIG) && (order != BYTES_LITTLE)))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    word_len = (byte_len + (int)sizeof(word) - 1) / (int)sizeof(word);
+    if(bi_new(dst, (word_len > 0) ? word_len : 1) == FAILED)
+    {
+        return FAILED;
+    }
+    (*dst)->sign = POSITIVE;
+
+#if ENDIAN == 0
+    if(order == BYTES_LITTLE)
+    {
+        memcpy((*dst)->a, src, (size_t)byte_len);
+        return bi_refine(*dst);
+    }
+#else
+    if((order == BYTES_BIG) && (byte_len % sizeof(word) == 0))
+    {
+        for(int word_index = 0; word_index < word_len; word_index++)
+        {
+            memcpy(&(*dst)->a[word_index], src + byte_len - (word_index + 1) * sizeof(word), sizeof(word));
+        }
+        return bi_refine(*dst);
+    }
+#endif
+
+    // whole words, then the remaining most significant bytes
+    full_len = byte_len / (int)sizeof(word);
+    for(int word_index = 0; word_index < full_len; word_index++)
+    {
+        word w = 0;
+        for(int byte_index = (int)sizeof(word) - 1; byte_index >= 0; byte_index--)
+        {
+            int pos = word_index * (int)sizeof(word) + byte_index;
+            w = (w << 8) | ((order == BYTES_BIG) ? src[byte_len - 1 - pos] : src[pos]);
+        }
+        (*dst)->a[word_index] = w;
+    }
+    for(int pos = full_len * (int)sizeof(word); pos < byte_len; pos++)
+    {
+        byte b = (order == BYTES_BIG) ? src[byte_len - 1 - pos] : src[pos];
+        (*dst)->a[full_len] |= (word)b << (8 * (pos % sizeof(word)));
+    }
+
+    return bi_refine(*dst);
+}
+
+
 /**
- * @brief Initializes a bigint structure from an array of words.
+ * @brief Wraps a word-aligned little-endian byte buffer as a bigint without copying.
  * 
- * This function converts an array of words into a `bigint` structure and stores it in the specified location.
+ * When the host is little endian (`ENDIAN` 0), `src` is aligned to a word and `byte_len`
+ * is a multiple of the word size, the buffer already has the layout of a word array.
+ * This function then points `dst` at the caller's buffer instead of copying it. The
+ * view may only be used as an input operand and is valid as long as `src` is;
+ * `bi_delete` only detaches it. If the buffer does not qualify the function returns
+ * -1 without a message so the caller can fall back to `bi_set_from_bytes`.
  * 
- * @param[out] dst Pointer to a double pointer of `bigint`, where the converted bigint will be stored.
- * @param[in] sign The sign of the bigint (POSITIVE or NEGATIVE).
- * @param[in] word_len The length of the input array.
- * @param[in] a Pointer to the input array of words.
+ * @param[out] dst Pointer to a caller-owned `bigint` structure that becomes the view.
+ * @param[in] src Pointer to the little-endian input bytes.
+ * @param[in] byte_len The number of input bytes.
  * 
- * @return Returns 1 on success, -1 on failure.
+ * @return Returns 1 on success, -1 if the buffer cannot be viewed in place.
  */
-msg bi_set_from_array(OUT bigint** dst, IN int sign, IN int word_len, IN const word* a)
+msg bi_view_from_bytes(OUT bigint* dst, IN const byte* src, IN int byte_len)
 {
-    bi_new(dst, word_len);
-    for (int i = 0; i < word_len; i++){
-        (*dst) -> a[i] = a[i];
+    if((dst == NULL) || (src == NULL) || (byte_len <= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
     }
-    (*dst) -> sign = sign;
+#if ENDIAN == 0
+    if((((uintptr_t)src % sizeof(word)) != 0) || ((byte_len % sizeof(word)) != 0))
+    {
+        return FAILED;
+    }
+
+    dst->a = (word*)src;
+    dst->word_len = byte_len / (int)sizeof(word);
+    dst->capacity = dst->word_len;
+    dst->flags = BI_FLAG_FIXED | BI_FLAG_VIEW;
+    while((dst->word_len > 1) && (dst->a[dst->word_len - 1] == 0))
+    {
+        dst->word_len--;     //trim without touching the buffer
+    }
+    dst->sign = ((dst->word_len == 1) && (dst->a[0] == 0)) ? ZERO : POSITIVE;
 
     return SUCCESS;
+#else
+    return FAILED;
+#endif
 }
 
+
 /**
- * @brief Converts a string to a bigint structure.
- * 
- * This function converts a given string representation of an integer into a `bigint` structure.
+ * @brief Returns the minimal number of bytes needed to hold the magnitude of a bigint.
  * 
- * @param[out] dst Pointer to a double pointer of `bigint`, where the converted bigint will be stored.
- * @param[in] int_str Pointer to the input string representing the integer.
- * @param[in] base The base of the input string (valid values are 2, 16).
+ * @param[in] src Pointer to the `bigint` structure.
  * 
- * @return Returns 1 on success, -1 on failure.
+ * @return The number of bytes (0 for zero), or -1 on invalid input.
  */
-msg bi_set_from_string(OUT bigint** dst, IN const char* int_str, IN int base)
+int bi_get_byte_len(IN const bigint* src)
 {
     int word_len = 0;
-    unsigned int strlength = 0; 
-    if (base == 2){
-        if (int_str[0] == '-'){
-            strlength = strlen(int_str) - 1;
-            word_len = strlength % SIZEOFWORD == 0 ? strlength / SIZEOFWORD : strlength / SIZEOFWORD +1;
-            bi_new(dst, word_len);
-            (*dst) -> sign = NEGATIVE;
-            for (unsigned int i = 0; i < strlength; i++){
-                if (int_str[strlength - i] == '1'){
-                    (*dst) -> a[i/SIZEOFWORD] |= (word)1 << (i % SIZEOFWORD);
-                }
-                else if (int_str[strlength - i] != '0'){
-                    fprintf(stderr, ERR_INVALID_INPUT);
-                    bi_delete(dst);
-                    return FAILED;
-                }
-            }
-        }
-        else{
-            strlength = strlen(int_str);
-            word_len = strlength % SIZEOFWORD == 0 ? strlength / SIZEOFWORD : strlength / SIZEOFWORD +1;
-            bi_new(dst, word_len);
-            (*dst) -> sign = POSITIVE;
-            for (unsigned int i = 0; i < strlength; i++){
-                if (int_str[strlength - i - 1] == '1'){
-                    (*dst) -> a[i/SIZEOFWORD] |= (word)1 << (i % SIZEOFWORD);
-                }
-                else if (int_str[strlength - i - 1] != '0'){
-                    fprintf(stderr, ERR_INVALID_INPUT);
-                    bi_delete(dst);
-                    return FAILED;
-                }
-            }
-        }
-        
+    int byte_len = 0;
+    word top = 0;
+
+    if((src == NULL) || (src->a == NULL) || (src->word_len <= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
     }
-    else if (base == 16){
-        if (int_str[0] == '-'){
-            strlength = strlen(int_str)-1;
-            word_len = strlength * 4 % SIZEOFWORD == 0 ? strlength * 4 / SIZEOFWORD : strlength * 4 / SIZEOFWORD +1;  
-            bi_new(dst, word_len);
-            (*dst)->sign = NEGATIVE;
-            for (unsigned int i = 0; i < strlength; i++) {
-                char c = int_str[strlength - i];
-                int digit = 0;
-            
-                if (c >= '0' && c <= '9') {
-                    digit = c - '0';
-                } else if (c >= 'a' && c <= 'f') {
-                    digit = c - 'a' + 10;
-                } else if (c >= 'A' && c <= 'F') {
-                    digit = c - 'A' + 10;
-                }
-                else{
-                    fprintf(stderr, ERR_INVALID_INPUT);
-                    bi_delete(dst);
-                    return FAILED;
-                }
-                (*dst)->a[i * 4 / SIZEOFWORD] |= (word)(digit & 0xF) << (i * 4 % SIZEOFWORD);
-            }
-        }
-        else {
-            strlength = strlen(int_str); 
-            word_len = strlength * 4 % SIZEOFWORD == 0 ? strlength * 4 / SIZEOFWORD : strlength * 4 / SIZEOFWORD +1;  
-            bi_new(dst, word_len);
-            (*dst)->sign = POSITIVE;
-            for (unsigned int i = 0; i < strlength; i++) {
-                char c = int_str[strlength - i - 1];
-                int digit = 0;
-
-                if (c >= '0' && c <= '9') {
-                    digit = c - '0';
-                } else if (c >= 'a' && c <= 'f') {
-                    digit = c - 'a' + 10;
-                } else if (c >= 'A' && c <= 'F') {
-                    digit = c - 'A' + 10;
-                }
-                else{
-                    fprintf(stderr, ERR_INVALID_INPUT);
-                    bi_delete(dst);
-                    return FAILED;
-                }
-                (*dst)->a[i * 4 / SIZEOFWORD] |= (word)(digit & 0xF) << (i * 4 % SIZEOFWORD);
-            }
-        }
+
+    for(word_len = src->word_len; (word_len > 0) && (src->a[word_len - 1] == 0); word_len--);
+    if(word_len == 0)
+    {
+        return 0;
     }
-    else {
+    top = src->a[word_len - 1];
+    byte_len = (word_len - 1) * (int)sizeof(word);
+    while(top != 0)
+    {
+        top >>= 8;
+        byte_len++;
+    }
+    return byte_len;
+}
+
+
+/**
+ * @brief Converts a non-negative bigint to a fixed-length byte string (I2OSP).
+ * 
+ * This function writes the magnitude of `src` into exactly `byte_len` bytes in the given
+ * byte order, padding with leading zero bytes. When the host layout (`ENDIAN`) matches
+ * the byte order the words are copied with one memcpy.
+ * 
+ * @param[out] dst Pointer to the output buffer of `byte_len` bytes.
+ * @param[in] byte_len The length of the output (at least `bi_get_byte_len(src)`).
+ * @param[in] src Pointer to the non-negative `bigint` to be converted.
+ * @param[in] order The byte order of `dst` (BYTES_BIG or BYTES_LITTLE).
+ * 
+ * @return Returns 1 on success, -1 on failure (e.g., negative input or output too short).
+ */
+msg bi_get_bytes(OUT byte* dst, IN int byte_len, IN const bigint* src, IN int order)
+{
+    int need_len = 0;
+    int src_len = 0;
+
+    if((dst == NULL) || (src == NULL) || (src->sign == NEGATIVE) || ((order != BYTES_BIG) && (order != BYTES_LITTLE)))
+    {
         fprintf(stderr, ERR_INVALID_INPUT);
         return FAILED;
     }
-    bi_refine(*dst);
+    need_len = bi_get_byte_len(src);
+    if((need_len < 0) || (byte_len < need_len))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    src_len = src->word_len * (int)sizeof(word);
+    src_len = (src_len < byte_len) ? src_len : byte_len;
+
+#if ENDIAN == 0
+    if(order == BYTES_LITTLE)
+    {
+        memcpy(dst, src->a, (size_t)src_len);
+        memset(dst + src_len, 0, (size_t)(byte_len - src_len));
+        return SUCCESS;
+    }
+#endif
+
+    for(int pos = 0; pos < byte_len; pos++)
+    {
+        byte b = (pos < src_len) ? (byte)(src->a[pos / sizeof(word)] >> (8 * (pos % sizeof(word)))) : 0;
+        if(order == BYTES_BIG)
+        {
+            dst[byte_len - 1 - pos] = b;
+        }
+        else
+        {
+            dst[pos] = b;
+        }
+    }
 
     return SUCCESS;
 }
@@ -166,7 +1161,11 @@ msg bi_get_random(OUT bigint** dst, IN int sign, IN int word_len)
     
     while(!((*dst)->a[word_len - 1])) // last word nonzero
     {
-        array_rand((*dst)->a, word_len);
+        if(array_rand((*dst)->a, word_len) == FAILED)
+        {
+            bi_delete(dst);
+            return FAILED;
+        }
     }
 
     return SUCCESS;
@@ -180,8 +1179,8 @@ msg bi_get_random(OUT bigint** dst, IN int sign, IN int word_len)
  * @brief Generates a random bigint within a specified range.
  * 
  * This function generates a random bigint that lies within the range defined by the 
- * `lower_bound` and `upper_bound` (inclusive). It ensures the generated number is uniformly
- * distributed within the given range.
+ * `lower_bound` and `upper_bound` (inclusive). The number is exactly uniformly
+ * distributed within the given range (see `bi_get_random_within_range_batch`).
  * 
  * @param[out] dst Pointer to the bigint that will hold the generated random number.
  * @param[in] lower_bound The lower bound of the range (inclusive).
@@ -191,46 +1190,145 @@ msg bi_get_random(OUT bigint** dst, IN int sign, IN int word_len)
  */
 msg bi_get_random_within_range(OUT bigint** dst, IN bigint* lower_bound, IN bigint* upper_bound)
 {
-    if((lower_bound == NULL) || (upper_bound == NULL) || (lower_bound->a == NULL) || (upper_bound->a == NULL) || (lower_bound->word_len <= 0) 
-    || (upper_bound->word_len <= 0))
+    return bi_get_random_within_range_batch(dst, 1, lower_bound, upper_bound);
+}
+
+
+/**
+ * @brief Releases the candidate buffer of `bi_get_random_within_range_batch`.
+ * 
+ * The buffer holds secret random candidates, so it is cleared (with ZERORIZE) before
+ * it is freed. On a failure the `done` outputs produced so far are deleted as well.
+ * 
+ * @param[inout] range The range and candidate words of the batch.
+ * @param[in] range_words The number of words in `range`.
+ * @param[inout] dst The outputs of the batch.
+ * @param[in] done The number of outputs to delete.
+ * 
+ * @return void
+ */
+static void random_batch_release(INOUT word* range, IN int range_words, INOUT bigint** dst, IN int done)
+{
+#if ZERORIZE == 1
+    array_init(range, range_words);
+#endif
+    free(range);
+    for(int i = 0; i < done; i++)
+    {
+        bi_delete(&dst[i]);
+    }
+}
+
+/**
+ * @brief Generates several uniform random bigints within a specified range.
+ * 
+ * This function fills `dst[0 .. num - 1]` with independent random bigints uniformly
+ * distributed in [`lower_bound`, `upper_bound`]. The range `upper - lower` is computed
+ * once on a word array, and candidates are drawn with exactly as many random bits as
+ * the range has, in one bulk request for all pending samples. A candidate larger than
+ * the range is rejected and redrawn (masked rejection sampling), so every value is
+ * equally likely and at most half of the candidates are rejected on average.
+ * 
+ * @param[out] dst Array of `num` bigint pointers that will hold the generated numbers.
+ * @param[in] num The number of samples to generate.
+ * @param[in] lower_bound The lower bound of the range (inclusive, non-negative).
+ * @param[in] upper_bound The upper bound of the range (inclusive, not less than `lower_bound`).
+ * 
+ * @return Returns 1 on success, -1 on failure (e.g., invalid range, invalid input, or memory allocation error).
+ */
+msg bi_get_random_within_range_batch(OUT bigint** dst, IN int num, IN const bigint* lower_bound, IN const bigint* upper_bound)
+{
+    if((dst == NULL) || (num <= 0) || (lower_bound == NULL) || (upper_bound == NULL) || (lower_bound->a == NULL) || (upper_bound->a == NULL)
+    || (lower_bound->word_len <= 0) || (upper_bound->word_len <= 0) || (lower_bound->sign == NEGATIVE) || (upper_bound->sign == NEGATIVE)
+    || (bi_compare(lower_bound, upper_bound) > 0))
     {
         fprintf(stderr, ERR_INVALID_INPUT);
         return FAILED;
     }
 
-    bigint* range = NULL;
-    bigint* random_range = NULL;
-    int word_len = 0;
-    int byte_len = 0;
-    byte rand_byte = 0;
-
-    bi_sub(&range, upper_bound, lower_bound);
-    word_len = range->word_len;
-    bi_new(&random_range, word_len);
-    random_range->sign = POSITIVE;
-    for (byte_len = (int)sizeof(word) - 1; byte_len > 0; byte_len--)
+    int word_len = upper_bound->word_len;
+    int range_len = 0;
+    int pending = num;
+    int next = 0;
+    word* range = NULL;
+    word* pool = NULL;
+    word mask = 0;
+    word borrow = 0;
+
+    // range = upper - lower on words
+    range = (word*)calloc((size_t)word_len * (num + 1), sizeof(word));
+    if(range == NULL)
     {
-        if(((range->a[word_len - 1] >> (8 * byte_len)) & (byte)0xff) != 0)
-        {
-            break;
-        }
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        return FAILED;
     }
-    if(word_len > 0)
+    pool = range + word_len;
+    for(int i = 0; i < word_len; i++)
     {
-        array_rand(random_range->a, word_len - 1);
+        word l = (i < lower_bound->word_len) ? lower_bound->a[i] : 0;
+        word t = upper_bound->a[i] - l;
+        word borrow_out = (upper_bound->a[i] < l) | (t < borrow);
+
+        range[i] = t - borrow;
+        borrow = borrow_out;
     }
-    
-    for(int byte_index = 0; byte_index < byte_len; byte_index++)
+    for(range_len = word_len; (range_len > 1) && (range[range_len - 1] == 0); range_len--);
+    mask = range[range_len - 1];
+    for(int shift = 1; shift < SIZEOFWORD; shift <<= 1)
     {
-        random_range->a[word_len - 1] ^= (((word)(rand() & 0xff)) << (8 * byte_index));
+        mask |= mask >> shift;
+    }
+
+    // draw candidates for all pending samples at once, keep the ones within range
+    while(pending > 0)
+    {
+        if(drbg_words(pool, pending * range_len) == FAILED)
+        {
+            random_batch_release(range, word_len * (num + 1), dst, next);
+            return FAILED;
+        }
+        for(int sample = 0; sample < pending; sample++)
+        {
+            word* x = pool + sample * range_len;
+            int cmp = 0;
+
+            x[range_len - 1] &= mask;
+            for(int i = range_len - 1; (i >= 0) && (cmp == 0); i--)
+            {
+                cmp = (x[i] > range[i]) - (x[i] < range[i]);
+            }
+            if(cmp > 0)
+            {
+                continue;
+            }
+
+            // dst = lower + x
+            word carry = 0;
+            if(bi_new(&dst[next], word_len + 1) == FAILED)
+            {
+                random_batch_release(range, word_len * (num + 1), dst, next);
+                return FAILED;
+            }
+            for(int i = 0; i < word_len + 1; i++)
+            {
+                word l = (i < lower_bound->word_len) ? lower_bound->a[i] : 0;
+                word r = (i < range_len) ? x[i] : 0;
+                word t = l + r;
+                word carry_out = (t < l);
+
+                t += carry;
+                carry_out |= (t < carry);
+                dst[next]->a[i] = t;
+                carry = carry_out;
+            }
+            dst[next]->sign = POSITIVE;
+            bi_refine(dst[next]);
+            next++;
+        }
+        pending = num - next;
     }
-    rand_byte = (rand() & 0xff) % ((range->a[word_len - 1] >> (8 * byte_len)) & 0xff);
-    random_range->a[word_len - 1] ^= ((word)(rand_byte) << (8 * byte_len));
-    bi_refine(random_range);
 
-    bi_add(dst, lower_bound, random_range);
-    bi_delete(&range);
-    bi_delete(&random_range);
+    random_batch_release(range, word_len * (num + 1), dst, 0);
 
     return SUCCESS;
 }
@@ -242,14 +1340,12 @@ msg bi_get_random_within_range(OUT bigint** dst, IN bigint* lower_bound, IN bigi
  * This function takes a bigint structure and outputs its value in the specified numerical base.
  * 
  * @param[in] src Pointer to the `bigint` structure to be printed.
- * @param[in] base The base in which to print the bigint (valid values are 2, 16).
+ * @param[in] base The base in which to print the bigint (valid values are 2, 10, 16).
  * 
  * @return Returns 1 on success, -1 on failure.
  */
 msg bi_print(IN const bigint* src, IN int base)
 {
-    int temp = 0;
-
     if((src == NULL) || !(base == 2 || base == 10 || base == 16))
     {
         fprintf(stderr, ERR_INVALID_INPUT);
@@ -261,224 +1357,271 @@ msg bi_print(IN const bigint* src, IN int base)
         return SUCCESS;
     }
 
-    if(base == 2)
+    return bi_write(stdout, src, base);
+}
+
+
+/**
+ * @brief Prints a bigint to a specified file.
+ * 
+ * This function takes a bigint structure and writes its value to the provided file.
+ * 
+ * @param[in] file Pointer to the `FILE` where the bigint will be printed.
+ * @param[in] src Pointer to the `bigint` structure to be printed.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_fprint(IN FILE* file, IN bigint* src)
+{
+    if (src == NULL) {
+        fprintf(stderr, "Error: NULL pointer dereference in bi_fprint\n");
+        return FAILED;
+    }
+    if((src->sign != POSITIVE) && (src->sign != NEGATIVE) && (src->sign != ZERO))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    if (src->a == NULL) {
+        fprintf(stderr, "Error: NULL pointer dereference for bigint array in bi_fprint\n");
+        return FAILED;
+    }
+
+    return bi_write(file, src, 16);
+}
+
+
+/**
+ * @brief Allocates a new bigint with a specified word length.
+ * 
+ * This function allocates memory for a new `bigint` structure with an array size equal to the specified word length.
+ * Both come from `bi_mem_alloc` (the thread-local pool by default). If `dst` already holds a bigint,
+ * the structure and, when it is large enough, its array are reused and cleared instead. A fixed-capacity
+ * bigint is always reused and fails if `word_len` exceeds its capacity.
+ * 
+ * @param[out] dst Pointer to a double pointer of `bigint`, where the allocated bigint will be stored.
+ * @param[in] word_len The length of the array to be allocated for the bigint.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_new(OUT bigint** dst, IN int word_len)
+{
+    if(*dst != NULL)
     {
-        if(src->sign == POSITIVE)
+        bigint* old = *dst;
+
+        if(old->flags & BI_FLAG_VIEW)
         {
-            printf("0b");
+            fprintf(stderr, ERR_NOT_CONDITION_FUNC);
+            return FAILED;
         }
-        else if(src->sign == NEGATIVE)
+        if(word_len <= old->capacity)
         {
-            printf("-0b");
+            array_init(old->a, old->word_len);      //words past word_len are already zero
         }
-        else
+        else if(old->flags & BI_FLAG_FIXED)
         {
+            fprintf(stderr, ERR_FIXED_CAPACITY);
             return FAILED;
         }
-        
-        temp = sizeof(word) * 8;
-        while(temp)
-        {
-            if((src->a[src->word_len - 1] >> (temp - 1) & 0x01))
-            {
-                break;
-            }
-            temp--;
-        }
-        for(int bit_index = temp - 1; bit_index >=0; bit_index--)
+        else
         {
-            printf("%1u", (byte)((src->a[src->word_len - 1]) >> bit_index) & 0x01);
-        }
+            word* a = (word*)bi_mem_alloc_for(old, sizeof(word) * word_len);
 
-        for(int word_index = src->word_len - 1; word_index > 0 ; word_index--)
-        {
-            for(int bit_index = 8 * sizeof(word) - 1; bit_index >=0 ; bit_index--)
+            if(a == NULL)
             {
-                printf("%1u", (byte)((src->a[word_index - 1]) >> bit_index) & 0x01);
+                fprintf(stderr, ERR_MEMORY_ALLOCATION);
+                return FAILED;
             }
+            bi_mem_free(old->a, sizeof(word) * old->capacity);
+            old->a = a;
+            old->capacity = word_len;
         }
-        printf("\n");
+        old->sign = ZERO;
+        old->word_len = word_len;
 
         return SUCCESS;
     }
-    else if(base == 16)
+    
+    (*dst) = (bigint*)bi_mem_alloc(sizeof(bigint));
+    if((*dst) == NULL)
     {
-        if(src->sign == POSITIVE)
-        {
-            printf("0x");
-        }
-        else if(src->sign == NEGATIVE)
-        {
-            printf("-0x");
-        }
-        else
-        {
-            fprintf(stderr, ERR_INVALID_INPUT);
-            return FAILED;
-        }
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        return FAILED;
+    }
 
-        temp = sizeof(word) * 2;
-        while(temp)
-        {
-            if((src->a[src->word_len - 1] >> (temp - 1) * 4) & 0xf)
-            {
-                break;
-            }
-            temp--;
-        }
-        for(int byte_index = temp; byte_index > 0; byte_index--)
-        {
-            printf("%01x", (byte)((src->a[src->word_len - 1] >> ((byte_index - 1) * 4)) & 0xf));
-        }
-        for(int word_index = src->word_len - 1; word_index > 0; word_index--)
-        {
-            for(int byte_index = sizeof(word); byte_index > 0; byte_index--)
-            {
-                printf("%02x", (byte)((src->a[word_index - 1] >> ((byte_index - 1) * 8)) & 0xff));
-            }
-        }
-        printf("\n");
+    (*dst) -> sign = ZERO;
+    (*dst) -> word_len = word_len;
+    (*dst) -> capacity = word_len;
+    (*dst) -> a = (word*)bi_mem_alloc(sizeof(word) * word_len);
 
-        return SUCCESS;
+    if((*dst) -> a == NULL)
+    {
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        bi_delete(dst);
+        return FAILED;
     }
 
-    return FAILED;
+    return SUCCESS;
 }
 
 
 /**
- * @brief Prints a bigint to a specified file.
+ * @brief Sets up a fixed-capacity bigint on caller-provided words.
  * 
- * This function takes a bigint structure and writes its value to the provided file.
+ * The bigint becomes zero and never allocates: functions that write to it reuse `a`
+ * and fail when a result needs more than `capacity` words. `bi_delete` clears it
+ * but leaves it usable. See `BI_FIXED_INIT` for the inline types of dtype.h.
  * 
- * @param[in] file Pointer to the `FILE` where the bigint will be printed.
- * @param[in] src Pointer to the `bigint` structure to be printed.
+ * @param[out] dst Pointer to the `bigint` structure to be set up.
+ * @param[in] a Pointer to the caller's word array, which must outlive `dst`.
+ * @param[in] capacity The number of words in `a`.
  * 
  * @return Returns 1 on success, -1 on failure.
  */
-msg bi_fprint(IN FILE* file, IN bigint* src)
+msg bi_fixed_init(OUT bigint* dst, IN word* a, IN int capacity)
 {
-    int temp = 0;
-
-    if (src == NULL) {
-        fprintf(stderr, "Error: NULL pointer dereference in bi_fprint\n");
+    if((dst == NULL) || (a == NULL) || (capacity <= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
         return FAILED;
     }
-    if(src->sign == ZERO)
+    array_init(a, capacity);
+    dst->sign = ZERO;
+    dst->word_len = 1;
+    dst->capacity = capacity;
+    dst->flags = BI_FLAG_FIXED;
+    dst->a = a;
+
+    return SUCCESS;
+}
+
+
+/**
+ * @brief Deletes a bigint structure and frees allocated memory.
+ * 
+ * This function deallocates the memory associated with the specified `bigint` structure.
+ * The memory is cleared when ZERORIZE is set and handed back through `bi_mem_free`.
+ * A fixed-capacity bigint is cleared to zero and `dst` keeps pointing to it; a view
+ * (`bi_view_from_bytes`) is only detached, leaving the caller's buffer untouched.
+ * 
+ * @param[out] dst Pointer to a double pointer of `bigint`, which will be deleted.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_delete(OUT bigint** dst)
+{
+    if((*dst) == NULL)
     {
-        fprintf(file, "0x0\n");
         return SUCCESS;
     }
-    else if(src->sign == POSITIVE)
+    if((*dst)->flags & BI_FLAG_VIEW)
     {
-        fprintf(file, "0x");
-    }
-    else if(src->sign == NEGATIVE)
-    {
-        fprintf(file, "-0x");
+        (*dst) = NULL;
+        return SUCCESS;
     }
-    else
+    if((*dst)->flags & BI_FLAG_FIXED)
     {
-        fprintf(stderr, ERR_INVALID_INPUT);
-        return FAILED;
+        array_init((*dst)->a, (*dst)->word_len);
+        (*dst)->sign = ZERO;
+        (*dst)->word_len = 1;
+        return SUCCESS;
     }
+    bi_mem_free((*dst)->a, sizeof(word) * (*dst)->capacity);    //cleared there with ZERORIZE
+    bi_mem_free((*dst), sizeof(bigint));
+    (*dst) = NULL;
 
-    if (src->a == NULL) {
-        fprintf(stderr, "Error: NULL pointer dereference for bigint array in bi_fprint\n");
-        return FAILED;
-    }
+    return SUCCESS;
+}
 
-    temp = sizeof(word) * 2;
-    while(temp)
-    {
-        if((src->a[src->word_len - 1] >> (temp - 1) * 4) & 0xf)
-        {
-            break;
-        }
-        temp--;
-    }
 
-    for(int byte_index = temp; byte_index > 0; byte_index--)
-    {
-        fprintf(file, "%01x", (byte)((src->a[src->word_len - 1] >> ((byte_index - 1) * 4)) & 0xf));
-    }
-    for(int word_index = src->word_len - 1; word_index > 0; word_index--)
+/**
+ * @brief Changes the allocated capacity of a bigint, keeping its value.
+ * 
+ * The words are moved to a new array and the old one is released through `bi_mem_free`
+ * (cleared with ZERORIZE), since realloc could leave a copy behind.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+static msg bi_set_capacity(INOUT bigint* dst, IN int capacity)
+{
+    word* a = (word*)bi_mem_alloc_for(dst, sizeof(word) * capacity);    //not into an arena younger than dst
+
+    if(a == NULL)
     {
-        for(int byte_index = sizeof(word); byte_index > 0; byte_index--)
-        {
-            fprintf(file, "%02x", (byte)((src->a[word_index - 1] >> ((byte_index - 1) * 8)) & 0xff));
-        }
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        return FAILED;
     }
-    fprintf(file, "\n");
+    array_copy(a, dst->a, dst->word_len);
+    bi_mem_free(dst->a, sizeof(word) * dst->capacity);
+    dst->a = a;
+    dst->capacity = capacity;
 
     return SUCCESS;
 }
 
 
 /**
- * @brief Allocates a new bigint with a specified word length.
+ * @brief Makes sure a bigint has room for at least `capacity` words.
  * 
- * This function allocates memory for a new `bigint` structure with an array size equal to the specified word length.
+ * The capacity grows geometrically (at least doubling), so repeated growth by small steps
+ * costs amortized constant allocator calls. `word_len` and the value are unchanged, and the
+ * new words are zero.
  * 
- * @param[out] dst Pointer to a double pointer of `bigint`, where the allocated bigint will be stored.
- * @param[in] word_len The length of the array to be allocated for the bigint.
+ * @param[inout] dst Pointer to the `bigint` structure to be grown.
+ * @param[in] capacity The number of words needed.
  * 
  * @return Returns 1 on success, -1 on failure.
  */
-msg bi_new(OUT bigint** dst, IN int word_len)
+msg bi_reserve(INOUT bigint* dst, IN int capacity)
 {
-    if(*dst != NULL)
+    if((dst == NULL) || (capacity < 0))
     {
-        bi_delete(dst);
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
     }
-    
-    (*dst) = (bigint*)calloc(1, sizeof(bigint));
-    if((*dst) == NULL)
+    if(capacity <= dst->capacity)
     {
-        fprintf(stderr, ERR_MEMORY_ALLOCATION);
-        return FAILED;
+        return SUCCESS;
     }
-
-    (*dst) -> sign = ZERO;
-    (*dst) -> word_len = word_len;
-    (*dst) -> a = (word*)calloc(word_len, sizeof(word));
-
-    if((*dst) -> a == NULL)
+    if(dst->flags & (BI_FLAG_FIXED | BI_FLAG_VIEW))
     {
-        fprintf(stderr, ERR_MEMORY_ALLOCATION);
-        bi_delete(dst);
+        fprintf(stderr, ERR_FIXED_CAPACITY);
         return FAILED;
     }
+    if(capacity < 2 * dst->capacity)
+    {
+        capacity = 2 * dst->capacity;
+    }
 
-    return SUCCESS;
+    return bi_set_capacity(dst, capacity);
 }
 
 
 /**
- * @brief Deletes a bigint structure and frees allocated memory.
+ * @brief Releases the capacity of a bigint beyond its word length.
  * 
- * This function deallocates the memory associated with the specified `bigint` structure.
+ * Capacity is never given back implicitly; call this for long-lived values that were built up
+ * through many intermediate sizes.
  * 
- * @param[out] dst Pointer to a double pointer of `bigint`, which will be deleted.
+ * @param[inout] dst Pointer to the `bigint` structure to be shrunk.
  * 
  * @return Returns 1 on success, -1 on failure.
  */
-msg bi_delete(OUT bigint** dst)
+msg bi_shrink(INOUT bigint* dst)
 {
-    if((*dst) == NULL)
+    if(dst == NULL)
     {
-        return SUCCESS;
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    if((dst->capacity == dst->word_len) || (dst->flags & (BI_FLAG_FIXED | BI_FLAG_VIEW)))
+    {
+        return SUCCESS;     //caller storage keeps its size
     }
-#if ZERORIZE == 1
-    array_init((*dst)->a, (*dst)->word_len);
-    (*dst)->sign = 0;
-    (*dst)->word_len = 0;
-#endif
-    free((*dst)->a);
-    free((*dst));
-    (*dst) = NULL;
 
-    return SUCCESS;
+    return bi_set_capacity(dst, dst->word_len);
 }
 
 
@@ -487,6 +1630,7 @@ msg bi_delete(OUT bigint** dst)
  * 
  * This function refines the given `bigint` structure by reducing its size 
  * based on the highest non-zero word and adjusting the sign if the value is zero.
+ * The capacity is kept.
  * 
  * @param[out] dst Pointer to the `bigint` structure to be refined.
  * 
@@ -505,13 +1649,7 @@ msg bi_refine(OUT bigint* dst)
             break;                  //find zero word
         }
     }
-    if(dst->word_len != resize_len){
-        dst->word_len = resize_len;
-        dst->a = (word*)realloc(dst->a, sizeof(word)*resize_len);   //ReSize
-        if(dst->a == NULL){
-            fprintf(stderr, ERR_MEMORY_ALLOCATION);
-        }
-    }
+    dst->word_len = resize_len;     //trimmed words are zero, so the capacity invariant holds
 
     if((dst->word_len == 1) && (dst->a[0] == 0x00)){
         dst->sign = ZERO;
@@ -523,9 +1661,9 @@ msg bi_refine(OUT bigint* dst)
 /**
  * @brief Assigns the value of one bigint structure to another.
  * 
- * This function deletes the existing `bigint` structure pointed to by `dst` 
- * (if it is not NULL), creates a new `bigint` with the same word length as 
- * `src`, and copies the sign and array data from `src` to `dst`.
+ * This function copies the sign and array data from `src` to `dst`. If `dst`
+ * already holds a bigint, its array is reused (grown if needed); otherwise a
+ * new `bigint` with the same word length as `src` is created.
  * 
  * @param[out] dst Pointer to a double pointer of `bigint`, where the assigned 
  *                 bigint will be stored.
@@ -535,11 +1673,24 @@ msg bi_refine(OUT bigint* dst)
  */
 msg bi_assign(OUT bigint** dst, IN const bigint* src)
 {
-    if(*dst != NULL){
-        bi_delete(dst);
+    if(*dst == src){
+        return SUCCESS;
     }
-    
-    bi_new(dst, src->word_len);
+    if(*dst == NULL){
+        if(bi_new(dst, src->word_len) == FAILED){
+            return FAILED;
+        }
+    }
+    else{
+        if(bi_reserve(*dst, src->word_len) == FAILED){
+            return FAILED;
+        }
+        if((*dst)->word_len > src->word_len){
+            array_init((*dst)->a + src->word_len, (*dst)->word_len - src->word_len);
+        }
+        (*dst)->word_len = src->word_len;
+    }
+
     (*dst)->sign = src->sign;
     array_copy(((*dst)->a), src->a, src->word_len);
     
@@ -551,7 +1702,7 @@ msg bi_assign(OUT bigint** dst, IN const bigint* src)
  * @brief Fills the bigint structure with zeros and resizes it.
  * 
  * This function adjusts the size of the given `bigint` structure to the specified 
- * length (`src_len`), reallocates memory for the underlying array, and fills any 
+ * length (`src_len`), growing the capacity if needed, and fills any 
  * additional space with zeros.
  * 
  * @param[out] dst Pointer to the `bigint` structure to be modified.
@@ -562,33 +1713,25 @@ msg bi_assign(OUT bigint** dst, IN const bigint* src)
 msg bi_fillzero(OUT bigint* dst, IN int src_len, IN int toward){
 
     int origin_len = dst->word_len;
-    dst->word_len = src_len;
-    dst->a = (word*)realloc(dst->a, sizeof(word)*src_len);
-    
-    if(dst->a == NULL){
-        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+
+    if((toward != TOP) && (toward != BOTTOM)){
+        fprintf(stderr, ERR_NOT_CONDITION_FUNC);
+        return FAILED;
+    }
+    if(bi_reserve(dst, src_len) == FAILED){
+        return FAILED;
     }
+    dst->word_len = src_len;
+
     if(toward == TOP){
-        while(src_len > origin_len){
-            dst->a[src_len - 1] = 0;
-            src_len--;
+        if(src_len < origin_len){
+            array_init(dst->a + src_len, origin_len - src_len);     //truncated words
         }
     }
-    else if(toward == BOTTOM){
+    else if(src_len > origin_len){
         int diff_len = src_len - origin_len;
-        while(src_len > 0){
-            if(src_len > diff_len){
-                dst->a[src_len - 1] = dst->a[src_len - diff_len - 1];
-            }
-            else{
-                dst->a[src_len - 1] = 0;
-            }
-            src_len--;
-        }
-    }
-    else{
-        fprintf(stderr, ERR_NOT_CONDITION_FUNC);
-        return FAILED;
+        memmove(dst->a + diff_len, dst->a, sizeof(word) * origin_len);
+        array_init(dst->a, diff_len);
     }
     return SUCCESS;
 }
@@ -654,7 +1797,7 @@ msg bi_connect(OUT bigint** dst, IN bigint* src1, IN bigint* src2){
  * 
  * This function shifts the bits of a big integer (`dst`) to the right by a specified number of bits (`num_bits`). 
  * The resulting integer is zero-padded on the most significant bits (MSB) after the shift. The sign of the 
- * integer remains unchanged. 
+ * integer remains unchanged. The vacated words are cleared and the capacity is kept.
  * 
  * @param[out] dst Pointer to the `bigint` structure to be modified with the shifted value.
  * @param[in] num_bits The number of bits to shift to the right.
@@ -663,7 +1806,6 @@ msg bi_connect(OUT bigint** dst, IN bigint* src1, IN bigint* src2){
 msg bi_bit_rshift(OUT bigint* dst, IN int num_bits)
 {
     int num_shift_words = 0;
-    int num_shift_bits = 0;
     int dst_len = 0;
     
     if((dst == NULL) || (num_bits < 0)) 
@@ -678,68 +1820,63 @@ msg bi_bit_rshift(OUT bigint* dst, IN int num_bits)
     }
 
     dst_len = dst->word_len;
-    num_shift_words = num_bits / (sizeof(word) * 8);
-    num_shift_bits = num_bits % (sizeof(word) * 8);
+    num_shift_words = num_bits / SIZEOFWORD;
 
-    if(num_shift_words >= dst_len || ((dst_len - 1 == num_shift_words) && ((dst->a[dst_len - 1]) >> num_shift_bits == 0)))
+    if(num_shift_words >= dst_len)
     {
-#if ZERORIZE == 1
         array_init(dst->a, dst_len);
-#endif
-        dst->a = (word*)realloc(dst->a, sizeof(word) * 1);
-        if(dst->a == NULL)
-        {
-            fprintf(stderr, ERR_MEMORY_ALLOCATION);
-            return FAILED;
-        }
         dst->sign = ZERO;
         dst->word_len = 1;
         
         return SUCCESS;
     }
 
-    if(num_shift_words > 0)
-    {
-        for (int word_index = 0; word_index < dst_len - num_shift_words; word_index++)
-        {
-            dst->a[word_index] = dst->a[word_index + num_shift_words];
-        }
-#if ZERORIZE == 1
-            array_init(dst->a + dst_len - num_shift_words, num_shift_words);
-#endif
-        dst->a = (word*)realloc(dst->a, sizeof(word) * (dst_len - num_shift_words));
-        if(dst->a == NULL)
-        {
-            fprintf(stderr, ERR_MEMORY_ALLOCATION);
-            return FAILED;
-        }
-        dst->word_len -= num_shift_words;
+    array_rshift(dst->a, dst->a, dst_len, num_bits);
+    array_init(dst->a + dst_len - num_shift_words, num_shift_words);
+    dst->word_len = dst_len - num_shift_words;
+
+    return bi_refine(dst);
+}
+
+
+/**
+ * @brief Stores `src >> num_bits` in `dst`, leaving `src` unchanged.
+ * 
+ * The shifted words are written straight into the storage of `dst` (reused when it is large
+ * enough), instead of copying `src` first and shifting the copy. The sign is kept.
+ * 
+ * @param[out] dst Pointer to a double pointer of `bigint` for the result (may point to `src`).
+ * @param[in] src Pointer to the `bigint` structure to be shifted.
+ * @param[in] num_bits The number of bits to shift to the right.
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_bit_rshift_to(OUT bigint** dst, IN const bigint* src, IN int num_bits)
+{
+    int num_shift_words = 0;
 
-        dst_len = dst->word_len;
+    if((dst == NULL) || (src == NULL) || (src->a == NULL) || (num_bits < 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
     }
-    
-    if(num_shift_bits > 0)
+    if(*dst == src)
     {
-        for (int word_index = 0; word_index < dst_len - 1; word_index++)
-        {
-            dst->a[word_index] >>= num_shift_bits;
-            dst->a[word_index] ^= (dst->a[word_index + 1] << (sizeof(word) * 8 - num_shift_bits));
-        }
+        return bi_bit_rshift(*dst, num_bits);
+    }
 
-        dst->a[dst_len - 1] >>= num_shift_bits;
-        if(dst->a[dst_len - 1] == 0)
-        {
-            dst->a = (word*)realloc(dst->a, sizeof(word) * (dst_len - 1));
-            if(dst->a == NULL)
-            {
-                fprintf(stderr, ERR_MEMORY_ALLOCATION);
-                return FAILED;
-            }
-            dst->word_len--;
-        }
+    num_shift_words = num_bits / SIZEOFWORD;
+    if((src->sign == ZERO) || (num_shift_words >= src->word_len))
+    {
+        return bi_new(dst, 1);
     }
-    
-    return SUCCESS;
+    if(bi_new(dst, src->word_len - num_shift_words) == FAILED)
+    {
+        return FAILED;
+    }
+    array_rshift((*dst)->a, src->a, src->word_len, num_bits);
+    (*dst)->sign = src->sign;
+
+    return bi_refine(*dst);
 }
 
 
@@ -748,7 +1885,7 @@ msg bi_bit_rshift(OUT bigint* dst, IN int num_bits)
  * 
  * This function shifts the bits of a big integer (`dst`) to the left by a specified number of bits (`num_bits`). 
  * The resulting integer is zero-padded on the least significant bits (LSB) after the shift. The sign of the 
- * integer remains unchanged. 
+ * integer remains unchanged. The capacity grows geometrically when the result does not fit.
  * 
  * @param[out] dst Pointer to the `bigint` structure to be modified with the shifted value.
  * @param[in] num_bits The number of bits to shift to the left.
@@ -759,6 +1896,8 @@ msg bi_bit_lshift(OUT bigint* dst, IN int num_bits)
     int num_shift_words = 0;
     int num_shift_bits = 0;
     int dst_len = 0;
+    int carry_word = 0;
+    word carry = 0;
     
     if((dst == NULL) || (num_bits < 0)) 
     {
@@ -772,50 +1911,66 @@ msg bi_bit_lshift(OUT bigint* dst, IN int num_bits)
     }
 
     dst_len = dst->word_len;
-    num_shift_words = num_bits / (sizeof(word) * 8);
-    num_shift_bits = num_bits % (sizeof(word) * 8);
+    num_shift_words = num_bits / SIZEOFWORD;
+    num_shift_bits = num_bits % SIZEOFWORD;
 
-    if(num_shift_words > 0)
+    carry_word = (num_shift_bits > 0) && (((dst->a[dst_len - 1]) >> (SIZEOFWORD - num_shift_bits)) != 0);
+    if(bi_reserve(dst, dst_len + num_shift_words + carry_word) == FAILED)
     {
-        dst->a = (word*)realloc(dst->a, sizeof(word) * (dst_len + num_shift_words));
-        array_init(dst->a + dst_len, num_shift_words);
-        if(dst->a == NULL)
-        {
-            fprintf(stderr, ERR_MEMORY_ALLOCATION);
-            return FAILED;
-        }
-        for (int word_index = dst_len - 1; word_index >= 0; word_index--)
-        {
-            dst->a[word_index + num_shift_words] = dst->a[word_index];
-            dst->a[word_index] = 0;
-        }
-        dst->word_len += num_shift_words;
+        return FAILED;
     }
-    
-    
-    dst_len = dst->word_len;
-    if (num_shift_bits > 0)
+
+    carry = array_lshift(dst->a, dst->a, dst_len, num_bits);
+    if(carry_word)
     {
-        if(((dst->a[dst_len - 1]) >> (sizeof(word) * 8 - num_shift_bits)) != 0)
-        {
-            dst->a = (word*)realloc(dst->a, sizeof(word) * (dst_len + 1));
-            dst->a[dst_len] = 0;
-            if(dst->a == NULL)
-            {
-                fprintf(stderr, ERR_MEMORY_ALLOCATION);
-                return FAILED;
-            }
-            dst->word_len++;
-            dst_len++;
-        }
-        
-        for (int word_index = dst_len - 1; word_index > 0; word_index--)
-        {
-            dst->a[word_index] <<= num_shift_bits;
-            dst->a[word_index] ^= (dst->a[word_index - 1] >> (sizeof(word) * 8 - num_shift_bits));
-        }
-        dst->a[0] <<= num_shift_bits;
+        dst->a[dst_len + num_shift_words] = carry;
+    }
+    dst->word_len = dst_len + num_shift_words + carry_word;
+
+    return SUCCESS;
+}
+
+
+/**
+ * @brief Stores `src << num_bits` in `dst`, leaving `src` unchanged.
+ * 
+ * The shifted words are written straight into the storage of `dst` (reused when it is large
+ * enough), instead of copying `src` first and shifting the copy. The sign is kept.
+ * 
+ * @param[out] dst Pointer to a double pointer of `bigint` for the result (may point to `src`).
+ * @param[in] src Pointer to the `bigint` structure to be shifted.
+ * @param[in] num_bits The number of bits to shift to the left.
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_bit_lshift_to(OUT bigint** dst, IN const bigint* src, IN int num_bits)
+{
+    int num_shift_words = 0;
+    word carry = 0;
+
+    if((dst == NULL) || (src == NULL) || (src->a == NULL) || (num_bits < 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
     }
+    if(*dst == src)
+    {
+        return bi_bit_lshift(*dst, num_bits);
+    }
+    if(src->sign == ZERO)
+    {
+        return bi_new(dst, 1);
+    }
+
+    num_shift_words = num_bits / SIZEOFWORD;
+    if(bi_new(dst, src->word_len + num_shift_words + 1) == FAILED)
+    {
+        return FAILED;
+    }
+    carry = array_lshift((*dst)->a, src->a, src->word_len, num_bits);
+    (*dst)->a[src->word_len + num_shift_words] = carry;
+    (*dst)->word_len -= (carry == 0);
+    (*dst)->sign = src->sign;
+
     return SUCCESS;
 }
 
@@ -867,6 +2022,44 @@ int bi_compare(IN const bigint* A, IN const bigint* B){
 }
 
 
+/**
+ * @brief Compares the magnitudes of two bigint values, ignoring their signs.
+ * 
+ * @param[in] A Pointer to the first `bigint` structure to be compared.
+ * @param[in] B Pointer to the second `bigint` structure to be compared.
+ * 
+ * @return 
+ *   - 1 if `|A|` is greater than `|B|`,
+ *   - 0 if `|A|` is equal to `|B|`,
+ *   - -1 if `|A|` is less than `|B|`.
+ */
+int bi_compare_abs(IN const bigint* A, IN const bigint* B)
+{
+    int len_a = A->word_len;
+    int len_b = B->word_len;
+
+    while((len_a > 0) && (A->a[len_a - 1] == 0))
+    {
+        len_a--;
+    }
+    while((len_b > 0) && (B->a[len_b - 1] == 0))
+    {
+        len_b--;
+    }
+    if(len_a != len_b)
+    {
+        return (len_a > len_b) ? 1 : -1;
+    }
+    for(int index = len_a - 1; index >= 0; index--)
+    {
+        if(A->a[index] != B->a[index])
+        {
+            return (A->a[index] > B->a[index]) ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
 /***********************************************
  * Greatest Common Divisor (GCD)
  ***********************************************/
@@ -8,18 +8,45 @@ msg bi_set_from_array(OUT bigint** dst, IN int sign, IN int word_len, IN const w
 
 msg bi_set_from_string(OUT bigint** dst, IN const char* int_str, IN int base);
 
+msg bi_set_from_bytes(OUT bigint** dst, IN const byte* src, IN int byte_len, IN int order);
+
+msg bi_view_from_bytes(OUT bigint* dst, IN const byte* src, IN int byte_len);
+
+int bi_get_byte_len(IN const bigint* src);
+
+msg bi_get_bytes(OUT byte* dst, IN int byte_len, IN const bigint* src, IN int order);
+
 msg bi_get_random(OUT bigint** dst, IN int sign, IN int word_len);
 
 msg bi_get_random_within_range(OUT bigint** dst, IN bigint* lower_bound, IN bigint* upper_bound);
 
+msg bi_get_random_within_range_batch(OUT bigint** dst, IN int num, IN const bigint* lower_bound, IN const bigint* upper_bound);
+
+int bi_hex_encode(OUT char* dst, IN int dst_len, IN const bigint* src);
+
+int bi_dec_encode(OUT char* dst, IN int dst_len, IN const bigint* src);
+
+int bi_format_len(IN const bigint* src, IN int base);
+
+int bi_format(OUT char* dst, IN int dst_len, IN const bigint* src, IN int base);
+
 msg bi_print(IN const bigint* src, IN int base);
 
 msg bi_fprint(IN FILE* file, IN bigint* src);
 
 msg bi_new(OUT bigint** dst, IN int word_len);
 
+msg bi_fixed_init(OUT bigint* dst, IN word* a, IN int capacity);
+
+//sets up a bigint1024 ... bigint8192 (dtype.h) declared by the caller
+#define BI_FIXED_INIT(fixed)    bi_fixed_init(&(fixed).bi, (fixed).a, (int)(sizeof((fixed).a) / sizeof(word)))
+
 msg bi_delete(OUT bigint** dst);
 
+msg bi_reserve(INOUT bigint* dst, IN int capacity);
+
+msg bi_shrink(INOUT bigint* dst);
+
 msg bi_refine(OUT bigint* dst);
 
 msg bi_assign(OUT bigint** dst, IN const bigint* src);
@@ -30,10 +57,16 @@ msg bi_connect(OUT bigint** dst, IN bigint* src1, IN bigint* src2);
 
 msg bi_bit_rshift(OUT bigint* dst, IN int num_bits);
 
+msg bi_bit_rshift_to(OUT bigint** dst, IN const bigint* src, IN int num_bits);
+
 msg bi_bit_lshift(OUT bigint* dst, IN int num_bits);
 
+msg bi_bit_lshift_to(OUT bigint** dst, IN const bigint* src, IN int num_bits);
+
 int bi_compare(IN const bigint* A, IN const bigint* B);
 
+int bi_compare_abs(IN const bigint* A, IN const bigint* B);
+
 msg bi_gcd(OUT bigint** gcd, IN const bigint* src1, IN const bigint* src2);
 
 msg bi_EEA(OUT bigint** gcd, OUT bigint** x, OUT bigint** y, IN const bigint* src1, IN const bigint* src2);
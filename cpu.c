@@ -0,0 +1,153 @@
+#define _POSIX_C_SOURCE 200112L     //pthread under -std=c99
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "cpu.h"
+#include "arrayfun.h"
+#include "montgomery.h"
+#include "params.h"
+#include "errormsg.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <cpuid.h>
+    #define CPU_X86     1       //cpuid and xgetbv are available
+#else
+    #define CPU_X86     0
+#endif
+
+static pthread_once_t cpu_once = PTHREAD_ONCE_INIT;
+static int cpu_detected = 0;        //extensions of the CPU that the OS supports
+static int cpu_enabled = 0;         //cpu_detected capped by CPU_TIER_ENV
+static cpu_kernels cpu_table;
+
+/***********************************************
+ * Detection
+ ***********************************************/
+/**
+ * @brief Returns the extensions reported by cpuid, dropping vector ones whose registers the OS does not save.
+ */
+static int cpu_detect()
+{
+    int features = 0;
+
+#if CPU_X86
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    unsigned int xcr0 = 0;
+
+    if(__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_OSXSAVE))
+    {
+        unsigned int xcr0_hi = 0;
+
+        __asm__ volatile("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+    }
+    if(__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    {
+        features |= (ebx & bit_BMI2) ? CPU_BMI2 : 0;
+        features |= (ebx & bit_ADX) ? CPU_ADX : 0;
+        if((xcr0 & 0x06) == 0x06)       //XMM and YMM state
+        {
+            features |= (ebx & bit_AVX2) ? CPU_AVX2 : 0;
+            if((xcr0 & 0xe0) == 0xe0)   //opmask and ZMM state
+            {
+                features |= (ebx & bit_AVX512F) ? CPU_AVX512 : 0;
+            }
+        }
+    }
+#endif
+    return features;
+}
+
+/**
+ * @brief Returns the tier named by CPU_TIER_ENV, or CPU_TIER_AVX512 (no cap) when it is unset.
+ */
+static int cpu_env_tier()
+{
+    static const char* const names[] = {"generic", "bmi2", "adx", "avx2", "avx512"};
+    static const int tiers[] = {CPU_TIER_GENERIC, CPU_TIER_BMI2, CPU_TIER_ADX, CPU_TIER_AVX2, CPU_TIER_AVX512};
+    const char* value = getenv(CPU_TIER_ENV);
+
+    if(value == NULL)
+    {
+        return CPU_TIER_AVX512;
+    }
+    for(int i = 0; i < (int)(sizeof(tiers) / sizeof(tiers[0])); i++)
+    {
+        if(strcmp(value, names[i]) == 0)
+        {
+            return tiers[i];
+        }
+    }
+    fprintf(stderr, ERR_INVALID_INPUT);     //unknown tier name: no cap
+    return CPU_TIER_AVX512;
+}
+
+/**
+ * @brief Lets each module bind its kernels: word arrays first, then Montgomery multiplication, which builds on them.
+ */
+static void cpu_bind(OUT cpu_kernels* kernels, IN int features)
+{
+    array_kernels_bind(kernels, features);
+    mont_kernels_bind(kernels, features);
+}
+
+/**
+ * @brief Detects the CPU once and binds the shared kernel table.
+ */
+static void cpu_init()
+{
+    cpu_detected = cpu_detect();
+    cpu_enabled = cpu_detected & cpu_env_tier();
+    cpu_bind(&cpu_table, cpu_enabled);
+}
+
+/***********************************************
+ * Dispatch
+ ***********************************************/
+/**
+ * @brief Returns the instruction set extensions in use (`CPU_*` flags).
+ *
+ * The CPU is examined with cpuid on first use; AVX2 and AVX-512 also need the OS to save the
+ * vector registers. The environment variable CPU_TIER_ENV caps the result at a tier, so the
+ * slower paths can be tested on a fast machine; it is read once.
+ *
+ * @return The `CPU_*` flags of the extensions that the kernels may use.
+ */
+int cpu_features()
+{
+    pthread_once(&cpu_once, cpu_init);
+
+    return cpu_enabled;
+}
+
+/**
+ * @brief Fills a kernel table for the given extensions.
+ *
+ * Extensions that the CPU lacks are ignored, so any tier may be requested, also above the
+ * cap of CPU_TIER_ENV; tests use this to compare the variants of every kernel.
+ *
+ * @param[out] kernels Pointer to the table to be filled.
+ * @param[in] features The `CPU_*` flags (or a `CPU_TIER_*`) the kernels may use.
+ *
+ * @return void
+ */
+void cpu_kernels_init(OUT cpu_kernels* kernels, IN int features)
+{
+    pthread_once(&cpu_once, cpu_init);
+
+    cpu_bind(kernels, features & cpu_detected);
+}
+
+/**
+ * @brief Returns the kernel table bound for `cpu_features()`, filled on first use.
+ *
+ * @return Pointer to the shared, read-only table.
+ */
+const cpu_kernels* cpu_kernels_get()
+{
+    pthread_once(&cpu_once, cpu_init);
+
+    return &cpu_table;
+}
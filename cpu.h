@@ -0,0 +1,49 @@
+#ifndef CPU_H
+#define CPU_H
+
+#include "dtype.h"
+#include "montgomery.h"
+
+//instruction set extensions used by the kernels
+#define CPU_BMI2        0x01    //MULX
+#define CPU_ADX         0x02    //ADCX and ADOX
+#define CPU_AVX2        0x04    //256-bit integer vectors
+#define CPU_AVX512      0x08    //AVX-512 F, 512-bit integer vectors
+
+//tiers: the extensions a tier may use, each tier includes the ones below it
+#define CPU_TIER_GENERIC    0
+#define CPU_TIER_BMI2       (CPU_BMI2)
+#define CPU_TIER_ADX        (CPU_TIER_BMI2 | CPU_ADX)
+#define CPU_TIER_AVX2       (CPU_TIER_ADX | CPU_AVX2)
+#define CPU_TIER_AVX512     (CPU_TIER_AVX2 | CPU_AVX512)
+
+#define CPU_TIER_ENV    "BIGINT_CPU_TIER"   //generic, bmi2, adx, avx2 or avx512: caps the tier for testing
+
+/**
+ * @struct cpu_kernels
+ * @brief Low-level kernels bound for the instruction set extensions in use.
+ *
+ * Every variant of a kernel gives the same result, so a table can be swapped freely;
+ * `mont_mul` and `mont_sqr` serve the moduli without a fixed-size kernel.
+ */
+typedef struct {
+    word (*addmul_1)(word* dst, const word* src, int len, word w);                     /**< dst += src * w, returns the carry word. */
+    void (*mul_basecase)(word* dst, const word* src1, int len1, const word* src2, int len2); /**< dst = src1 * src2, len1 + len2 words. */
+    word (*lshift)(word* dst, const word* src, int src_len, int num_bits);             /**< As `array_lshift`. */
+    void (*rshift)(word* dst, const word* src, int src_len, int num_bits);             /**< As `array_rshift`. */
+    mont_mul_kernel mont_mul;       /**< Montgomery multiplication of any length. */
+    mont_sqr_kernel mont_sqr;       /**< Montgomery squaring of any length. */
+} cpu_kernels;
+
+int cpu_features();
+
+void cpu_kernels_init(OUT cpu_kernels* kernels, IN int features);
+
+const cpu_kernels* cpu_kernels_get();
+
+//each module binds its own variants into a table (arrayfun.c, montgomery.c)
+void array_kernels_bind(OUT cpu_kernels* kernels, IN int features);
+
+void mont_kernels_bind(OUT cpu_kernels* kernels, IN int features);
+
+#endif
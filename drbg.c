@@ -0,0 +1,384 @@
+#if defined(_WIN32)
+    #define _CRT_RAND_S
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux__)
+    #include <sys/random.h>
+#endif
+
+#include "drbg.h"
+#include "params.h"
+#include "dtype.h"
+#include "errormsg.h"
+
+#define DRBG_KEY_LEN        32                          //chacha20 key bytes
+#define DRBG_BLOCK_LEN      64                          //chacha20 block bytes
+#define DRBG_BUF_LEN        (16 * DRBG_BLOCK_LEN)       //keystream buffered per refill
+#define DRBG_RESEED_NUM     (1 << 14)                   //refills between OS reseeds
+
+#define DRBG_UNSEEDED       0
+#define DRBG_OS_SEEDED      1
+#define DRBG_FIXED_SEEDED   2
+
+/**
+ * @struct drbg_state
+ * @brief Per-thread state of the ChaCha20 DRBG.
+ *
+ * The generator runs ChaCha20 in counter mode under `key`. Every refill of `buf`
+ * immediately overwrites `key` with the first bytes of the new keystream, so a
+ * later compromise of the state does not reveal earlier outputs.
+ */
+typedef struct {
+    uint32_t key[DRBG_KEY_LEN / 4];  /**< Current ChaCha20 key. */
+    uint64_t counter;                /**< Block counter under the current key. */
+    byte buf[DRBG_BUF_LEN];          /**< Buffered keystream. */
+    int buf_pos;                     /**< Index of the next unused byte in `buf`. */
+    int mode;                        /**< DRBG_UNSEEDED, DRBG_OS_SEEDED or DRBG_FIXED_SEEDED. */
+    int refill_num;                  /**< Refills since the last OS reseed. */
+} drbg_state;
+
+static THREAD_LOCAL drbg_state drbg;
+
+#define ROTL32(x, n)  (((x) << (n)) | ((x) >> (32 - (n))))
+#define QUARTER_ROUND(a, b, c, d)                    \
+    a += b; d ^= a; d = ROTL32(d, 16);               \
+    c += d; b ^= c; b = ROTL32(b, 12);               \
+    a += b; d ^= a; d = ROTL32(d, 8);                \
+    c += d; b ^= c; b = ROTL32(b, 7);
+
+/**
+ * @brief Computes one ChaCha20 block (RFC 8439) with a zero nonce.
+ * 
+ * @param[out] dst Pointer to the 64 output bytes.
+ * @param[in] key Pointer to the 8-word key.
+ * @param[in] counter The 64-bit block counter.
+ * 
+ * @return void
+ */
+static void chacha20_block(OUT byte* dst, IN const uint32_t* key, IN uint64_t counter)
+{
+    uint32_t in[16];
+    uint32_t x[16];
+
+    in[0] = 0x61707865;
+    in[1] = 0x3320646e;
+    in[2] = 0x79622d32;
+    in[3] = 0x6b206574;
+    for(int i = 0; i < 8; i++)
+    {
+        in[4 + i] = key[i];
+    }
+    in[12] = (uint32_t)counter;
+    in[13] = (uint32_t)(counter >> 32);
+    in[14] = 0;
+    in[15] = 0;
+
+    for(int i = 0; i < 16; i++)
+    {
+        x[i] = in[i];
+    }
+    for(int round = 0; round < 10; round++)
+    {
+        QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+    }
+    for(int i = 0; i < 16; i++)
+    {
+        uint32_t v = x[i] + in[i];
+        dst[4 * i]     = (byte)v;
+        dst[4 * i + 1] = (byte)(v >> 8);
+        dst[4 * i + 2] = (byte)(v >> 16);
+        dst[4 * i + 3] = (byte)(v >> 24);
+    }
+#if ZERORIZE == 1
+    memset(x, 0, sizeof(x));
+    memset(in, 0, sizeof(in));
+#endif
+}
+
+/**
+ * @brief Reads seed material from the operating system.
+ * 
+ * @param[out] dst Pointer to the output buffer.
+ * @param[in] byte_len The number of bytes to read.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+static msg drbg_os_entropy(OUT byte* dst, IN int byte_len)
+{
+#if defined(_WIN32)
+    unsigned int v = 0;
+    for(int i = 0; i < byte_len; i += 4)
+    {
+        if(rand_s(&v) != 0)
+        {
+            fprintf(stderr, ERR_NOT_SUPPORT_OS);
+            return FAILED;
+        }
+        for(int j = 0; (j < 4) && (i + j < byte_len); j++)
+        {
+            dst[i + j] = (byte)(v >> (8 * j));
+        }
+    }
+    return SUCCESS;
+#else
+    int done = 0;
+    FILE* file = NULL;
+
+#if defined(__linux__)
+    while(done < byte_len)
+    {
+        long ret = (long)getrandom(dst + done, (size_t)(byte_len - done), 0);
+        if(ret <= 0)
+        {
+            break;
+        }
+        done += (int)ret;
+    }
+    if(done == byte_len)
+    {
+        return SUCCESS;
+    }
+#endif
+    file = fopen("/dev/urandom", "rb");
+    if(file == NULL)
+    {
+        fprintf(stderr, ERR_NOT_SUPPORT_OS);
+        return FAILED;
+    }
+    done += (int)fread(dst + done, 1, (size_t)(byte_len - done), file);
+    fclose(file);
+    if(done != byte_len)
+    {
+        fprintf(stderr, ERR_NOT_SUPPORT_OS);
+        return FAILED;
+    }
+    return SUCCESS;
+#endif
+}
+
+/**
+ * @brief Loads 32 bytes into the key, optionally xoring into the existing key.
+ */
+static void drbg_set_key(IN const byte* src, IN int mix)
+{
+    for(int i = 0; i < DRBG_KEY_LEN / 4; i++)
+    {
+        uint32_t v = (uint32_t)src[4 * i] | ((uint32_t)src[4 * i + 1] << 8) |
+                     ((uint32_t)src[4 * i + 2] << 16) | ((uint32_t)src[4 * i + 3] << 24);
+        drbg.key[i] = mix ? (drbg.key[i] ^ v) : v;
+    }
+}
+
+/**
+ * @brief Refills the keystream buffer and rekeys from its first bytes.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+static msg drbg_refill()
+{
+    byte seed[DRBG_KEY_LEN];
+
+    if((drbg.mode == DRBG_OS_SEEDED) && (drbg.refill_num >= DRBG_RESEED_NUM))
+    {
+        if(drbg_os_entropy(seed, DRBG_KEY_LEN) == FAILED)
+        {
+            return FAILED;
+        }
+        drbg_set_key(seed, 1);
+        drbg.refill_num = 0;
+#if ZERORIZE == 1
+        memset(seed, 0, sizeof(seed));
+#endif
+    }
+
+    for(int block = 0; block < DRBG_BUF_LEN / DRBG_BLOCK_LEN; block++)
+    {
+        chacha20_block(drbg.buf + block * DRBG_BLOCK_LEN, drbg.key, drbg.counter++);
+    }
+    drbg_set_key(drbg.buf, 0);
+    drbg.counter = 0;
+    memset(drbg.buf, 0, DRBG_KEY_LEN);
+    drbg.buf_pos = DRBG_KEY_LEN;
+    drbg.refill_num++;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Seeds the calling thread's generator from the operating system.
+ * 
+ * This function discards the current state of the calling thread's generator and
+ * reseeds it with fresh operating-system entropy (getrandom, /dev/urandom or rand_s).
+ * It also leaves the deterministic mode set by `drbg_seed`. Threads seed themselves
+ * automatically on first use, so calling this function is optional.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg drbg_reseed()
+{
+    byte seed[DRBG_KEY_LEN];
+
+    if(drbg_os_entropy(seed, DRBG_KEY_LEN) == FAILED)
+    {
+        return FAILED;
+    }
+    drbg_set_key(seed, 0);
+#if ZERORIZE == 1
+    memset(seed, 0, sizeof(seed));
+#endif
+    drbg.counter = 0;
+    drbg.mode = DRBG_OS_SEEDED;
+    drbg.refill_num = 0;
+
+    return drbg_refill();
+}
+
+/**
+ * @brief Seeds the calling thread's generator deterministically.
+ * 
+ * After this call the same sequence of requests on the calling thread returns the same
+ * bytes, which makes benchmarks and tests reproducible. The generator never mixes in
+ * operating-system entropy in this mode until `drbg_reseed` is called. Other threads
+ * are not affected.
+ * 
+ * @param[in] seed Pointer to the seed bytes.
+ * @param[in] seed_len The number of seed bytes (any length).
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg drbg_seed(IN const byte* seed, IN int seed_len)
+{
+    byte chunk[DRBG_KEY_LEN];
+    byte block[DRBG_BLOCK_LEN];
+    int offset = 0;
+
+    if((seed == NULL) || (seed_len < 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    memset(drbg.key, 0, sizeof(drbg.key));
+    drbg.counter = 0;
+    do{
+        int len = (seed_len - offset < DRBG_KEY_LEN) ? (seed_len - offset) : DRBG_KEY_LEN;
+
+        memset(chunk, 0, sizeof(chunk));
+        memcpy(chunk, seed + offset, (size_t)len);
+        drbg_set_key(chunk, 1);
+        chacha20_block(block, drbg.key, (uint64_t)seed_len);
+        drbg_set_key(block, 0);
+        offset += len;
+    }while(offset < seed_len);
+
+#if ZERORIZE == 1
+    memset(chunk, 0, sizeof(chunk));
+    memset(block, 0, sizeof(block));
+#endif
+    drbg.mode = DRBG_FIXED_SEEDED;
+    drbg.refill_num = 0;
+
+    return drbg_refill();
+}
+
+/**
+ * @brief Fills a buffer with random bytes from the calling thread's generator.
+ * 
+ * Requests longer than the internal buffer are generated directly into `dst` and
+ * followed by a rekey. Consumed keystream is erased from the internal buffer.
+ * 
+ * @param[out] dst Pointer to the output buffer.
+ * @param[in] byte_len The number of bytes to generate.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg drbg_bytes(OUT byte* dst, IN int byte_len)
+{
+    int len = 0;
+
+    if((dst == NULL) || (byte_len < 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    if(drbg.mode == DRBG_UNSEEDED)
+    {
+        if(drbg_reseed() == FAILED)
+        {
+            return FAILED;
+        }
+    }
+
+    if(byte_len >= DRBG_BUF_LEN)
+    {
+        while(byte_len >= DRBG_BLOCK_LEN)
+        {
+            chacha20_block(dst, drbg.key, drbg.counter++);
+            dst += DRBG_BLOCK_LEN;
+            byte_len -= DRBG_BLOCK_LEN;
+        }
+        if(drbg_refill() == FAILED)
+        {
+            return FAILED;
+        }
+    }
+
+    while(byte_len > 0)
+    {
+        if(drbg.buf_pos == DRBG_BUF_LEN)
+        {
+            if(drbg_refill() == FAILED)
+            {
+                return FAILED;
+            }
+        }
+        len = DRBG_BUF_LEN - drbg.buf_pos;
+        len = (len < byte_len) ? len : byte_len;
+        memcpy(dst, drbg.buf + drbg.buf_pos, (size_t)len);
+        memset(drbg.buf + drbg.buf_pos, 0, (size_t)len);
+        drbg.buf_pos += len;
+        dst += len;
+        byte_len -= len;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Fills an array of words with random values.
+ * 
+ * @param[out] dst Pointer to the array of `word` to be filled.
+ * @param[in] word_len The number of words to fill.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg drbg_words(OUT word* dst, IN int word_len)
+{
+    if(word_len < 0)
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    return drbg_bytes((byte*)dst, word_len * (int)sizeof(word));
+}
+
+/**
+ * @brief Erases the calling thread's generator state.
+ * 
+ * The next request reseeds the generator from the operating system.
+ * 
+ * @return void
+ */
+void drbg_clear()
+{
+    memset(&drbg, 0, sizeof(drbg));
+}
@@ -0,0 +1,16 @@
+#ifndef DRBG_H
+#define DRBG_H
+
+#include "dtype.h"
+
+msg drbg_seed(IN const byte* seed, IN int seed_len);
+
+msg drbg_reseed();
+
+msg drbg_bytes(OUT byte* dst, IN int byte_len);
+
+msg drbg_words(OUT word* dst, IN int word_len);
+
+void drbg_clear();
+
+#endif
@@ -9,6 +9,13 @@
 #define OUT
 #define INOUT
 
+//thread-local storage class
+#if defined(_MSC_VER)
+    #define THREAD_LOCAL __declspec(thread)
+#else
+    #define THREAD_LOCAL __thread
+#endif
+
 typedef int msg;        //return message
 typedef uint8_t byte;
 
@@ -26,6 +33,20 @@ typedef uint8_t byte;
     #define max_word (word)0xff;
 #endif
 
+//double-width word for single-word multiplication and division, when the compiler has one
+#if SIZEOFWORD == 32
+    typedef uint64_t dword;
+    #define HAVE_DWORD 1
+#elif (SIZEOFWORD == 64) && defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 dword;
+    #define HAVE_DWORD 1
+#elif SIZEOFWORD == 8
+    typedef uint16_t dword;
+    #define HAVE_DWORD 1
+#else
+    #define HAVE_DWORD 0
+#endif
+
 /**
  * @struct bigint
  * @brief A structure representing a big integer.
@@ -38,14 +59,39 @@ typedef uint8_t byte;
  *             A value of 1 represents a positive number, 
  *             and a value of -1 represents a negative number.
  * @param word_len The number of words used to represent the big integer.
+ * @param capacity The number of words allocated for `a`. Words from
+ *                 `word_len` up to `capacity` are always zero.
+ * @param flags Storage flags (`BI_FLAG_*`), 0 for storage from `bi_mem_alloc`.
  * @param a Pointer to an array of words (of type word) that stores
  *          the actual digits of the big integer.
  */
 typedef struct {
     int sign;      /**< The sign of the big integer. */
     int word_len;  /**< The number of words in the big integer. */
+    int capacity;  /**< The number of allocated words. */
+    int flags;     /**< Storage flags. */
     word* a;       /**< Pointer to the array of words representing the big integer. */
 } bigint;
 
+//bigint storage flags
+#define BI_FLAG_FIXED   0x01    //words live in caller storage and are never reallocated or freed
+#define BI_FLAG_VIEW    0x02    //words belong to a read-only caller buffer (bi_view_from_bytes)
+
+//words of a fixed-capacity bigint holding `bits` bits, plus one carry word
+#define BI_FIXED_WORDS(bits)    (((bits) + SIZEOFWORD - 1) / SIZEOFWORD + 1)
+
+/**
+ * @brief Fixed-capacity bigints with inline words.
+ *
+ * These can live on the stack or inside other structures. After `BI_FIXED_INIT`
+ * (bigintfun.h) the member `bi` is an ordinary bigint that every function accepts
+ * through a pointer to it, without heap allocation. A product of two n-bit values
+ * needs a 2n-bit bigint.
+ */
+typedef struct { bigint bi; word a[BI_FIXED_WORDS(1024)]; } bigint1024;
+typedef struct { bigint bi; word a[BI_FIXED_WORDS(2048)]; } bigint2048;
+typedef struct { bigint bi; word a[BI_FIXED_WORDS(4096)]; } bigint4096;
+typedef struct { bigint bi; word a[BI_FIXED_WORDS(8192)]; } bigint8192;
+
 
 #endif
\ No newline at end of file
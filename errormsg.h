@@ -11,5 +11,7 @@
 #define ERR_MEMORY_ALLOCATION  "Error: Memory allocation failed.\n"
 #define ERR_NOT_SUPPORT_OS     "Error: Not supported Os.\n"
 #define ERR_NOT_CONDITION_FUNC "Error: Function condition not satisfied.\n"
+#define ERR_FIXED_CAPACITY     "Error: Fixed bigint capacity exceeded.\n"
+#define ERR_DECRYPTION         "Error: Decryption error.\n"
 
 #endif
\ No newline at end of file
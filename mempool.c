@@ -0,0 +1,425 @@
+#define _POSIX_C_SOURCE 200112L     //pthread under -std=c99
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "mempool.h"
+#include "params.h"
+#include "dtype.h"
+#include "errormsg.h"
+
+#define POOL_MIN_SIZE       32                  //bytes of the smallest size class
+#define POOL_CLASS_NUM      12                  //size classes 32 B ... 64 KB, larger blocks use malloc
+#define POOL_MAX_BLOCKS     64                  //free blocks cached per class and thread
+#define ARENA_CHUNK_SIZE    (1 << 16)           //bytes requested from malloc per arena chunk
+#define ARENA_ALIGN         16
+
+/**
+ * @struct pool_state
+ * @brief Per-thread cache of free blocks, one singly linked list per size class.
+ *
+ * A free block stores the pointer to the next free block in its first bytes.
+ * With ZERORIZE the rest of a cached block is always zero.
+ */
+typedef struct {
+    void* free_list[POOL_CLASS_NUM];    /**< First free block of each class. */
+    int free_num[POOL_CLASS_NUM];       /**< Number of cached blocks of each class. */
+    int registered;                     /**< 1 once the thread-exit destructor knows this cache. */
+} pool_state;
+
+/**
+ * @struct arena_chunk
+ * @brief One malloc'ed chunk of an arena; allocations are carved from `data` in order.
+ */
+typedef struct arena_chunk {
+    struct arena_chunk* next;   /**< Previously filled chunk. */
+    size_t size;                /**< Usable bytes in `data`. */
+    size_t used;                /**< Bytes handed out so far. */
+    unsigned char* data;        /**< Start of the usable bytes (aligned). */
+} arena_chunk;
+
+/**
+ * @struct arena_state
+ * @brief Per-thread arena; `depth` counts nested bi_arena_begin calls.
+ */
+typedef struct {
+    int depth;              /**< 0 when no arena is active. */
+    arena_chunk* chunk;     /**< Current chunk, linked to the older ones. */
+} arena_state;
+
+static void* pool_alloc(void* ctx, size_t size);
+static void pool_release(void* ctx, void* ptr, size_t size);
+
+static bi_allocator allocator = {pool_alloc, pool_release, NULL};
+static THREAD_LOCAL pool_state pool;
+static THREAD_LOCAL arena_state arena;
+static pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t pool_key;
+static int pool_key_valid = 0;
+
+/***********************************************
+ * Size-Class Pool
+ ***********************************************/
+/**
+ * @brief Returns the size class of a block, or -1 if it is too large for the pool.
+ */
+static int pool_class(IN size_t size)
+{
+    int class_index = 0;
+    size_t class_size = POOL_MIN_SIZE;
+
+    while(class_size < size)
+    {
+        class_size <<= 1;
+        class_index++;
+    }
+    return (class_index < POOL_CLASS_NUM) ? class_index : -1;
+}
+
+/**
+ * @brief Frees the blocks cached in a pool.
+ */
+static void pool_free_blocks(INOUT pool_state* state)
+{
+    for(int class_index = 0; class_index < POOL_CLASS_NUM; class_index++)
+    {
+        while(state->free_list[class_index] != NULL)
+        {
+            void* block = state->free_list[class_index];
+            state->free_list[class_index] = *(void**)block;
+            free(block);
+        }
+        state->free_num[class_index] = 0;
+    }
+}
+
+/**
+ * @brief Thread-exit destructor of `pool_key`: frees the cache of a thread that did not call bi_pool_clear.
+ */
+static void pool_thread_exit(void* state)
+{
+    pool_free_blocks((pool_state*)state);
+    ((pool_state*)state)->registered = 0;   //a later release in another destructor registers again
+}
+
+static void pool_key_create()
+{
+    pool_key_valid = (pthread_key_create(&pool_key, pool_thread_exit) == 0);
+}
+
+/**
+ * @brief Hands the calling thread's cache to `pool_key`, so it is freed when the thread exits.
+ */
+static void pool_register()
+{
+    pthread_once(&pool_key_once, pool_key_create);
+    if(pool_key_valid && (pthread_setspecific(pool_key, &pool) == 0))
+    {
+        pool.registered = 1;
+    }
+}
+
+/**
+ * @brief Default allocator: takes a block from the calling thread's free list of its size class.
+ *
+ * Blocks are only ever handed between threads through bi_mem_free, so no locking is needed.
+ */
+static void* pool_alloc(void* ctx, size_t size)
+{
+    int class_index = pool_class(size);
+    void* block = NULL;
+
+    (void)ctx;
+    if(class_index < 0)
+    {
+        return calloc(1, size);
+    }
+
+    block = pool.free_list[class_index];
+    if(block == NULL)
+    {
+        return calloc(1, (size_t)POOL_MIN_SIZE << class_index);
+    }
+    pool.free_list[class_index] = *(void**)block;
+    pool.free_num[class_index]--;
+#if ZERORIZE == 1
+    *(void**)block = NULL;      //the rest was cleared on release
+#else
+    memset(block, 0, (size_t)POOL_MIN_SIZE << class_index);
+#endif
+
+    return block;
+}
+
+/**
+ * @brief Default allocator: caches the block on the calling thread, or frees it when the class is full.
+ */
+static void pool_release(void* ctx, void* ptr, size_t size)
+{
+    int class_index = pool_class(size);
+
+    (void)ctx;
+    if((class_index < 0) || (pool.free_num[class_index] >= POOL_MAX_BLOCKS))
+    {
+        free(ptr);
+        return;
+    }
+    if(pool.registered == 0)
+    {
+        pool_register();
+    }
+    *(void**)ptr = pool.free_list[class_index];
+    pool.free_list[class_index] = ptr;
+    pool.free_num[class_index]++;
+}
+
+/**
+ * @brief Frees the blocks cached by the calling thread.
+ *
+ * A thread's cache is also freed when the thread exits (through a pthread key destructor);
+ * call this to return the memory earlier, e.g. after a burst of large bigints.
+ *
+ * @return void
+ */
+void bi_pool_clear()
+{
+    pool_free_blocks(&pool);
+}
+
+/***********************************************
+ * Arena
+ ***********************************************/
+/**
+ * @brief Returns 1 if `ptr` was handed out by the calling thread's active arena.
+ */
+static int arena_owns(IN const void* ptr)
+{
+    for(arena_chunk* chunk = arena.chunk; chunk != NULL; chunk = chunk->next)
+    {
+        if(((const unsigned char*)ptr >= chunk->data) && ((const unsigned char*)ptr < chunk->data + chunk->size))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Carves `size` zeroed bytes from the current arena chunk, starting a new chunk if needed.
+ */
+static void* arena_alloc(IN size_t size)
+{
+    arena_chunk* chunk = arena.chunk;
+    void* ptr = NULL;
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if((chunk == NULL) || (chunk->size - chunk->used < size))
+    {
+        size_t chunk_size = (size > ARENA_CHUNK_SIZE) ? size : ARENA_CHUNK_SIZE;
+        size_t header_size = (sizeof(arena_chunk) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+        chunk = (arena_chunk*)calloc(1, header_size + chunk_size);
+        if(chunk == NULL)
+        {
+            return NULL;
+        }
+        chunk->next = arena.chunk;
+        chunk->size = chunk_size;
+        chunk->used = 0;
+        chunk->data = (unsigned char*)chunk + header_size;
+        arena.chunk = chunk;
+    }
+    ptr = chunk->data + chunk->used;
+    chunk->used += size;
+
+    return ptr;
+}
+
+/**
+ * @brief Starts (or nests) an arena on the calling thread.
+ *
+ * Until the matching `bi_arena_end`, bigint storage created on this thread is carved from
+ * large chunks and deleting it costs nothing; all of it is released at once by the outermost
+ * `bi_arena_end`. Arenas suit bounded batches of temporaries: memory is not reused inside an
+ * arena, so long loops should keep using the pool.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_arena_begin()
+{
+    arena.depth++;
+    return SUCCESS;
+}
+
+/**
+ * @brief Ends an arena; the outermost call clears and frees everything allocated in it.
+ *
+ * If `keep` points to a bigint, its structure and its words are first moved out of the arena
+ * (into normal storage) wherever they lie there, so a result computed inside the arena survives
+ * it. Bigints created before the arena stay valid: they never grow into arena memory (see
+ * `bi_mem_alloc_for`). Every other bigint created inside the arena is invalid afterwards.
+ *
+ * @param[inout] keep Pointer to a bigint to be kept, or NULL.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_arena_end(INOUT bigint** keep)
+{
+    msg error_msg = SUCCESS;
+
+    if(arena.depth <= 0)
+    {
+        fprintf(stderr, ERR_NOT_CONDITION_FUNC);
+        return FAILED;
+    }
+    if(--arena.depth > 0)
+    {
+        return SUCCESS;     //the outer arena is still alive
+    }
+
+    if((keep != NULL) && (*keep != NULL))
+    {
+        bigint* src = *keep;
+        int move_struct = arena_owns(src);
+        int move_words = !(src->flags & (BI_FLAG_FIXED | BI_FLAG_VIEW)) && arena_owns(src->a);
+        bigint* dst = move_struct ? (bigint*)bi_mem_alloc(sizeof(bigint)) : src;     //normal storage: depth is 0
+        word* a = move_words ? (word*)bi_mem_alloc(sizeof(word) * src->capacity) : src->a;
+
+        if((dst == NULL) || (a == NULL))
+        {
+            fprintf(stderr, ERR_MEMORY_ALLOCATION);
+            if(move_struct)
+            {
+                bi_mem_free(dst, sizeof(bigint));
+            }
+            if(move_words)
+            {
+                bi_mem_free(a, sizeof(word) * src->capacity);
+            }
+            error_msg = FAILED;
+        }
+        else
+        {
+            if(move_words)
+            {
+                memcpy(a, src->a, sizeof(word) * src->capacity);
+            }
+            *dst = *src;
+            dst->a = a;
+            *keep = dst;
+        }
+    }
+
+    while(arena.chunk != NULL)
+    {
+        arena_chunk* chunk = arena.chunk;
+        arena.chunk = chunk->next;
+#if ZERORIZE == 1
+        memset(chunk->data, 0, chunk->used);
+#endif
+        free(chunk);
+    }
+
+    return error_msg;
+}
+
+/***********************************************
+ * Allocation Interface
+ ***********************************************/
+/**
+ * @brief Replaces the allocator used for bigint storage.
+ *
+ * The allocator is process-wide and must be set before any bigint is created, since memory
+ * is always returned to the allocator that is active at release time.
+ *
+ * @param[in] new_allocator The allocator to use, or NULL for the default thread-local pool.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_set_allocator(IN const bi_allocator* new_allocator)
+{
+    if(new_allocator == NULL)
+    {
+        allocator.alloc = pool_alloc;
+        allocator.release = pool_release;
+        allocator.ctx = NULL;
+        return SUCCESS;
+    }
+    if((new_allocator->alloc == NULL) || (new_allocator->release == NULL))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    allocator = *new_allocator;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Allocates zeroed memory for bigint storage.
+ *
+ * The memory comes from the active arena of the calling thread if there is one, and from
+ * the configured allocator otherwise.
+ *
+ * @param[in] size The number of bytes.
+ *
+ * @return Pointer to the memory, or NULL on failure.
+ */
+void* bi_mem_alloc(IN size_t size)
+{
+    if(arena.depth > 0)
+    {
+        return arena_alloc(size);
+    }
+    return allocator.alloc(allocator.ctx, size);
+}
+
+/**
+ * @brief Allocates zeroed memory that lives as long as `owner`, e.g. the words of a bigint.
+ *
+ * The memory comes from the active arena only if `owner` was itself carved from it (or is
+ * NULL), and from the configured allocator otherwise; a bigint created before an arena thus
+ * never grows into memory that `bi_arena_end` frees under it.
+ *
+ * @param[in] owner Pointer to the memory that will hold the new block, or NULL.
+ * @param[in] size The number of bytes.
+ *
+ * @return Pointer to the memory, or NULL on failure.
+ */
+void* bi_mem_alloc_for(IN const void* owner, IN size_t size)
+{
+    if((arena.depth > 0) && ((owner == NULL) || arena_owns(owner)))
+    {
+        return arena_alloc(size);
+    }
+    return allocator.alloc(allocator.ctx, size);
+}
+
+/**
+ * @brief Releases memory obtained from `bi_mem_alloc` or `bi_mem_alloc_for`.
+ *
+ * The memory is cleared first when ZERORIZE is set. Memory of the active arena is only
+ * cleared; it is freed by `bi_arena_end`.
+ *
+ * @param[in] ptr Pointer to the memory (NULL is ignored).
+ * @param[in] size The size that was passed to `bi_mem_alloc`.
+ *
+ * @return void
+ */
+void bi_mem_free(IN void* ptr, IN size_t size)
+{
+    if(ptr == NULL)
+    {
+        return;
+    }
+#if ZERORIZE == 1
+    memset(ptr, 0, size);
+#endif
+    if((arena.depth > 0) && arena_owns(ptr))
+    {
+        return;
+    }
+    allocator.release(allocator.ctx, ptr, size);
+}
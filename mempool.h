@@ -0,0 +1,35 @@
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include <stddef.h>
+#include "dtype.h"
+
+/**
+ * @struct bi_allocator
+ * @brief Allocator used for bigint structures and their word arrays.
+ *
+ * `alloc` must return zeroed memory of at least `size` bytes (or NULL).
+ * `release` receives the same `size` that was passed to `alloc`; the memory
+ * has already been cleared when ZERORIZE is set.
+ */
+typedef struct {
+    void* (*alloc)(void* ctx, size_t size);               /**< Returns zeroed memory. */
+    void (*release)(void* ctx, void* ptr, size_t size);   /**< Takes back memory from `alloc`. */
+    void* ctx;                                            /**< Passed to both callbacks. */
+} bi_allocator;
+
+msg bi_set_allocator(IN const bi_allocator* allocator);
+
+void* bi_mem_alloc(IN size_t size);
+
+void* bi_mem_alloc_for(IN const void* owner, IN size_t size);
+
+void bi_mem_free(IN void* ptr, IN size_t size);
+
+msg bi_arena_begin();
+
+msg bi_arena_end(INOUT bigint** keep);
+
+void bi_pool_clear();
+
+#endif
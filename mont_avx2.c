@@ -0,0 +1,770 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mont_avx2.h"
+#include "cpu.h"
+#include "bigintfun.h"
+#include "operation.h"
+#include "arrayfun.h"
+#include "mempool.h"
+#include "params.h"
+#include "errormsg.h"
+
+#if MONT_AVX2
+    #include <immintrin.h>
+
+    #define MB_TARGET   __attribute__((target("avx2")))
+#endif
+
+#define MB_BITS     29      //bits per limb: a limb product has 58 bits and _mm256_mul_epu32 reads 32
+#define MB_MASK     (((uint64_t)1 << MB_BITS) - 1)
+#define MB_NORM     16      //rows between carry normalizations, 2 * 16 products of 58 bits fit in a 64-bit column
+
+/***********************************************
+ * CPU Detection
+ ***********************************************/
+/**
+ * @brief Returns 1 if the AVX2 engine is compiled in and AVX2 is in use (`cpu_features`), 0 otherwise.
+ */
+int mont_avx2_supported()
+{
+#if MONT_AVX2
+    return (cpu_features() & CPU_AVX2) ? 1 : 0;
+#else
+    return 0;
+#endif
+}
+
+/***********************************************
+ * Scalar Path
+ ***********************************************/
+/**
+ * @brief Runs items [begin, end) one after the other with the scalar Montgomery exponentiation.
+ */
+static msg mont_exp_scalar(OUT bigint** dsts, IN bigint* const* bases, IN const bigint* const* exps, IN const bi_mont_ctx* const* ctxs, IN int ctx_num, IN int begin, IN int end, IN int secure)
+{
+    for(int i = begin; i < end; i++)
+    {
+        const bi_mont_ctx* ctx = ctxs[(ctx_num == 1) ? 0 : i];
+        msg error_msg = secure ? bi_mont_exp(&dsts[i], bases[i], exps[i], ctx) : bi_mont_exp_public(&dsts[i], bases[i], exps[i], ctx);
+
+        if(error_msg == FAILED)
+        {
+            return FAILED;
+        }
+    }
+    return SUCCESS;
+}
+
+#if MONT_AVX2
+/***********************************************
+ * Limb Conversion
+ ***********************************************/
+/*
+ * The engine keeps values in radix 2^29, limb k of lane l at index MONT_LANES * k + l, so one
+ * 256-bit vector holds the same limb of every lane. With L limbs, R = 2^(29 L) > 4n: products of
+ * values below 2n then stay below 2n, and no final subtraction is needed between operations.
+ * A single large exponentiation uses one lane (stride 1) and L rounded up to a multiple of 4,
+ * so one vector holds four consecutive limbs of the same value.
+ */
+
+/**
+ * @brief Returns the number of limbs L for a modulus of `word_len` words.
+ */
+static int mb_limb_len(IN int word_len)
+{
+    return (word_len * SIZEOFWORD + 2 + MB_BITS - 1) / MB_BITS;
+}
+
+/**
+ * @brief Returns the number of limbs of the single-lane layout, L rounded up to whole vectors.
+ */
+static int mw_limb_len(IN int word_len)
+{
+    return (mb_limb_len(word_len) + 3) & ~3;
+}
+
+/**
+ * @brief Writes the `src_len`-word value `src` into lane `lane` of the limb array `dst` of `lanes` lanes.
+ */
+static void mb_load(OUT uint64_t* dst, IN int lanes, IN int lane, IN const word* src, IN int src_len, IN int limb_len)
+{
+    for(int k = 0; k < limb_len; k++)
+    {
+        int index = (k * MB_BITS) / SIZEOFWORD;
+        int offset = (k * MB_BITS) % SIZEOFWORD;
+        uint64_t limb = 0;
+
+        if(index < src_len)
+        {
+            limb = (uint64_t)(src[index] >> offset);
+            if((offset > SIZEOFWORD - MB_BITS) && (index + 1 < src_len))
+            {
+                limb |= (uint64_t)src[index + 1] << (SIZEOFWORD - offset);
+            }
+        }
+        dst[(size_t)lanes * k + lane] = limb & MB_MASK;
+    }
+}
+
+/**
+ * @brief Reads lane `lane` of the limb array `src` of `lanes` lanes, a value of at most n, into `dst` reduced modulo n.
+ */
+static msg mb_store(OUT bigint** dst, IN const uint64_t* src, IN int lanes, IN int lane, IN int limb_len, IN const bigint* modulus)
+{
+    int word_len = modulus->word_len;
+    word diff = 0;
+    word keep;
+
+    if(bi_new(dst, word_len) == FAILED)
+    {
+        return FAILED;
+    }
+    array_init((*dst)->a, word_len);
+    for(int k = 0; k < limb_len; k++)
+    {
+        uint64_t limb = src[(size_t)lanes * k + lane];
+        int index = (k * MB_BITS) / SIZEOFWORD;
+        int offset = (k * MB_BITS) % SIZEOFWORD;
+
+        if(index < word_len)
+        {
+            (*dst)->a[index] |= (word)(limb << offset);
+        }
+        if((offset > SIZEOFWORD - MB_BITS) && (index + 1 < word_len))
+        {
+            (*dst)->a[index + 1] |= (word)(limb >> (SIZEOFWORD - offset));
+        }
+    }
+
+    //n stands for 0; clear it without a data-dependent branch
+    for(int j = 0; j < word_len; j++)
+    {
+        diff |= (*dst)->a[j] ^ modulus->a[j];
+    }
+    keep = (word)0 - ((diff | ((word)0 - diff)) >> (SIZEOFWORD - 1));
+    for(int j = 0; j < word_len; j++)
+    {
+        (*dst)->a[j] &= keep;
+    }
+    (*dst)->sign = POSITIVE;
+    bi_refine(*dst);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Sets `view` to a read-only bigint over the modulus words of a context.
+ */
+static void mb_modulus(OUT bigint* view, IN const bi_mont_ctx* ctx)
+{
+    view->sign = POSITIVE;
+    view->word_len = ctx->word_len;
+    view->capacity = ctx->word_len;
+    view->flags = BI_FLAG_FIXED | BI_FLAG_VIEW;
+    view->a = ctx->n;
+}
+
+/**
+ * @brief Computes R^2 mod n for R = 2^(29 L); it differs from the `rr` of the context.
+ */
+static msg mb_rr(OUT bigint** rr, IN const bi_mont_ctx* ctx, IN int limb_len)
+{
+    int bits = 2 * MB_BITS * limb_len;
+    bigint modulus;
+    bigint* power = NULL;
+    bigint* quotient = NULL;
+    msg error_msg;
+
+    mb_modulus(&modulus, ctx);
+    if(bi_new(&power, bits / SIZEOFWORD + 1) == FAILED)
+    {
+        return FAILED;
+    }
+    power->sign = POSITIVE;
+    power->a[bits / SIZEOFWORD] = (word)1 << (bits % SIZEOFWORD);
+    error_msg = bi_word_division(&quotient, rr, power, &modulus);
+    bi_delete(&power);
+    bi_delete(&quotient);
+
+    return error_msg;
+}
+
+/***********************************************
+ * AVX2 Kernels
+ ***********************************************/
+/**
+ * @brief Four Montgomery multiplications `r = a * b / R mod n`, one per lane, for inputs below 2n.
+ *
+ * Operand scanning with 64-bit column accumulators and deferred carries: each row adds
+ * `a_i * b + q_i * n` and only pushes the carry of its lowest column, and the live columns are
+ * normalized every MB_NORM rows. Two rows share a pass over the columns, which halves the
+ * accumulator loads and stores. `acc` needs 2 * L + 2 vectors; `r` may alias `a` or `b`.
+ */
+MB_TARGET static void mb_mul(OUT uint64_t* r, IN const uint64_t* a, IN const uint64_t* b, IN const uint64_t* n, IN const uint64_t* n0, IN int limb_len, uint64_t* acc)
+{
+    const __m256i mask = _mm256_set1_epi64x((long long)MB_MASK);
+    const __m256i inv = _mm256_load_si256((const __m256i*)n0);
+    const __m256i* av = (const __m256i*)a;
+    const __m256i* bv = (const __m256i*)b;
+    const __m256i* nv = (const __m256i*)n;
+    __m256i* cv = (__m256i*)acc;
+    __m256i carry = _mm256_setzero_si256();
+    int i = 0;
+
+    for(int k = 0; k < 2 * limb_len + 2; k++)
+    {
+        cv[k] = _mm256_setzero_si256();
+    }
+
+    for(; i + 1 < limb_len; i += 2)
+    {
+        __m256i* c = cv + i;
+        __m256i a0 = av[i];
+        __m256i a1 = av[i + 1];
+        __m256i t0 = _mm256_add_epi64(c[0], _mm256_mul_epu32(a0, bv[0]));
+        __m256i q0 = _mm256_and_si256(_mm256_mul_epu32(t0, inv), mask);
+        __m256i t1, q1, b_prev, n_prev;
+
+        // column i gives q0, column i + 1 (with row i) gives q1
+        t0 = _mm256_add_epi64(t0, _mm256_mul_epu32(q0, nv[0]));
+        t1 = _mm256_add_epi64(c[1], _mm256_srli_epi64(t0, MB_BITS));
+        t1 = _mm256_add_epi64(t1, _mm256_add_epi64(_mm256_mul_epu32(a0, bv[1]), _mm256_mul_epu32(q0, nv[1])));
+        t1 = _mm256_add_epi64(t1, _mm256_mul_epu32(a1, bv[0]));
+        q1 = _mm256_and_si256(_mm256_mul_epu32(t1, inv), mask);
+        t1 = _mm256_add_epi64(t1, _mm256_mul_epu32(q1, nv[0]));
+        c[2] = _mm256_add_epi64(c[2], _mm256_srli_epi64(t1, MB_BITS));
+
+        b_prev = bv[1];
+        n_prev = nv[1];
+        for(int j = 2; j < limb_len; j++)
+        {
+            __m256i bj = bv[j];
+            __m256i nj = nv[j];
+            __m256i s0 = _mm256_add_epi64(_mm256_mul_epu32(a0, bj), _mm256_mul_epu32(q0, nj));
+            __m256i s1 = _mm256_add_epi64(_mm256_mul_epu32(a1, b_prev), _mm256_mul_epu32(q1, n_prev));
+
+            c[j] = _mm256_add_epi64(c[j], _mm256_add_epi64(s0, s1));
+            b_prev = bj;
+            n_prev = nj;
+        }
+        c[limb_len] = _mm256_add_epi64(c[limb_len], _mm256_add_epi64(_mm256_mul_epu32(a1, b_prev), _mm256_mul_epu32(q1, n_prev)));
+
+        if((i + 2) % MB_NORM == 0)
+        {
+            for(int k = i + 2; k < i + 2 + limb_len; k++)
+            {
+                cv[k + 1] = _mm256_add_epi64(cv[k + 1], _mm256_srli_epi64(cv[k], MB_BITS));
+                cv[k] = _mm256_and_si256(cv[k], mask);
+            }
+        }
+    }
+    for(; i < limb_len; i++)
+    {
+        __m256i* c = cv + i;
+        __m256i a0 = av[i];
+        __m256i t0 = _mm256_add_epi64(c[0], _mm256_mul_epu32(a0, bv[0]));
+        __m256i q0 = _mm256_and_si256(_mm256_mul_epu32(t0, inv), mask);
+
+        t0 = _mm256_add_epi64(t0, _mm256_mul_epu32(q0, nv[0]));
+        c[1] = _mm256_add_epi64(c[1], _mm256_srli_epi64(t0, MB_BITS));
+        for(int j = 1; j < limb_len; j++)
+        {
+            c[j] = _mm256_add_epi64(c[j], _mm256_add_epi64(_mm256_mul_epu32(a0, bv[j]), _mm256_mul_epu32(q0, nv[j])));
+        }
+    }
+
+    // the result is below 2n < R, so it fits in the upper L columns once the carries are propagated
+    for(int k = 0; k < limb_len; k++)
+    {
+        __m256i v = _mm256_add_epi64(cv[limb_len + k], carry);
+
+        carry = _mm256_srli_epi64(v, MB_BITS);
+        _mm256_store_si256((__m256i*)r + k, _mm256_and_si256(v, mask));
+    }
+}
+
+/**
+ * @brief Carries every column of `c[0 .. 4 * vec_num)` into the next one, keeping its low MB_BITS bits.
+ *
+ * The carries of a vector are rotated up by one lane, and the top one enters the next vector,
+ * so a pass is one shift, mask, permute and blend per vector. The top column of the range must
+ * be free of carries out.
+ */
+MB_TARGET static void mw_normalize(INOUT uint64_t* c, IN int vec_num)
+{
+    const __m256i mask = _mm256_set1_epi64x((long long)MB_MASK);
+    __m256i prev = _mm256_setzero_si256();
+
+    for(int k = 0; k < vec_num; k++)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(c + 4 * k));
+        __m256i high = _mm256_permute4x64_epi64(_mm256_srli_epi64(v, MB_BITS), _MM_SHUFFLE(2, 1, 0, 3));
+
+        v = _mm256_add_epi64(_mm256_and_si256(v, mask), _mm256_blend_epi32(high, prev, 0x03));
+        _mm256_storeu_si256((__m256i*)(c + 4 * k), v);
+        prev = high;
+    }
+}
+
+/**
+ * @brief One Montgomery multiplication `r = a * b / R mod n` on a large modulus, for inputs below 2n.
+ *
+ * Single-lane layout: a vector holds four consecutive limbs. Rows go in pairs: the two quotient
+ * digits are found in scalar code from the two lowest live columns, then one pass adds
+ * `a_i * b + q_i * n` and, through copies of b and n shifted up by one limb, the next row too,
+ * four columns at a time. The live columns are normalized every MB_NORM rows. `limb_len` is a
+ * multiple of 4, `acc` needs 4 * L + 16 words and `r` may alias `a` or `b`.
+ */
+MB_TARGET static void mw_mul(OUT uint64_t* r, IN const uint64_t* a, IN const uint64_t* b, IN const uint64_t* n, IN const uint64_t* n0, IN int limb_len, uint64_t* acc)
+{
+    uint64_t* bs = acc + 2 * limb_len + 16;
+    uint64_t* ns = bs + limb_len;
+    const __m256i* bv = (const __m256i*)b;
+    const __m256i* nv = (const __m256i*)n;
+    const __m256i* bsv = (const __m256i*)bs;
+    const __m256i* nsv = (const __m256i*)ns;
+    int vec_num = limb_len / 4;
+    uint64_t carry = 0;
+
+    memset(acc, 0, sizeof(uint64_t) * (2 * limb_len + 16));
+    bs[0] = 0;
+    ns[0] = 0;
+    memcpy(bs + 1, b, sizeof(uint64_t) * (limb_len - 1));
+    memcpy(ns + 1, n, sizeof(uint64_t) * (limb_len - 1));
+    for(int i = 0; i < limb_len; i += 2)
+    {
+        uint64_t* c = acc + i;
+        uint64_t t0 = c[0] + a[i] * b[0];
+        uint64_t q0 = (t0 * n0[0]) & MB_MASK;
+        uint64_t t1 = c[1] + ((t0 + q0 * n[0]) >> MB_BITS) + a[i] * b[1] + q0 * n[1] + a[i + 1] * b[0];
+        uint64_t q1 = (t1 * n0[0]) & MB_MASK;
+        __m256i a0 = _mm256_set1_epi64x((long long)a[i]);
+        __m256i a1 = _mm256_set1_epi64x((long long)a[i + 1]);
+        __m256i m0 = _mm256_set1_epi64x((long long)q0);
+        __m256i m1 = _mm256_set1_epi64x((long long)q1);
+
+        for(int k = 0; k < vec_num; k++)
+        {
+            __m256i ck = _mm256_loadu_si256((const __m256i*)(c + 4 * k));
+            __m256i s0 = _mm256_add_epi64(_mm256_mul_epu32(a0, bv[k]), _mm256_mul_epu32(m0, nv[k]));
+            __m256i s1 = _mm256_add_epi64(_mm256_mul_epu32(a1, bsv[k]), _mm256_mul_epu32(m1, nsv[k]));
+
+            _mm256_storeu_si256((__m256i*)(c + 4 * k), _mm256_add_epi64(ck, _mm256_add_epi64(s0, s1)));
+        }
+        c[limb_len] += a[i + 1] * b[limb_len - 1] + q1 * n[limb_len - 1];
+        c[1] += c[0] >> MB_BITS;        //the low MB_BITS bits of columns i and i + 1 are zero now
+        c[2] += c[1] >> MB_BITS;
+
+        if((i + 2) % MB_NORM == 0)
+        {
+            mw_normalize(c + 2, vec_num + 1);
+        }
+    }
+
+    // the result is below 2n < R, so it fits in the upper L columns once the carries are propagated
+    for(int k = 0; k < limb_len; k++)
+    {
+        uint64_t v = acc[limb_len + k] + carry;
+
+        carry = v >> MB_BITS;
+        r[k] = v & MB_MASK;
+    }
+}
+
+/**
+ * @brief Copies entry `digits[l]` of the table into lane l of `dst`, reading every entry so the access pattern is fixed.
+ *
+ * Each entry is `vec_num` vectors. In the single-lane layout the digit is repeated in every lane.
+ */
+MB_TARGET static void mb_select(OUT uint64_t* dst, IN const uint64_t* table, IN int table_num, IN int vec_num, IN const uint64_t* digits)
+{
+    const __m256i index = _mm256_load_si256((const __m256i*)digits);
+    __m256i* d = (__m256i*)dst;
+
+    for(int k = 0; k < vec_num; k++)
+    {
+        d[k] = _mm256_setzero_si256();
+    }
+    for(int i = 0; i < table_num; i++)
+    {
+        const __m256i* entry = (const __m256i*)(table + (size_t)i * 4 * vec_num);
+        __m256i mask = _mm256_cmpeq_epi64(index, _mm256_set1_epi64x(i));
+
+        for(int k = 0; k < vec_num; k++)
+        {
+            d[k] = _mm256_or_si256(d[k], _mm256_and_si256(entry[k], mask));
+        }
+    }
+}
+
+/***********************************************
+ * Multi-Buffer Exponentiation
+ ***********************************************/
+/**
+ * @brief Returns `window` bits of `exp` starting at bit `pos`; bits past the exponent are zero.
+ */
+static uint64_t mb_digit(IN const bigint* exp, IN int pos, IN int window)
+{
+    uint64_t digit = 0;
+
+    for(int k = window - 1; k >= 0; k--)
+    {
+        int index = (pos + k) / SIZEOFWORD;
+
+        digit <<= 1;
+        if(index < exp->word_len)
+        {
+            digit |= (uint64_t)((exp->a[index] >> ((pos + k) % SIZEOFWORD)) & 1);
+        }
+    }
+    return digit;
+}
+
+/**
+ * @brief Fixed-window exponentiation of up to MONT_LANES items of the same word length in lockstep.
+ *
+ * Mirrors `mont_exp` lane by lane: every lane has its own modulus, base and exponent, and the
+ * exponents are scanned over the longest one. With `secure` every window performs a
+ * multiplication with a masked table lookup, so nothing depends on the exponent bits;
+ * otherwise leading zero bits are skipped and windows that are zero in all lanes cost no
+ * multiplication. Lanes past `lane_num` repeat lane 0 and are discarded.
+ *
+ * With `lanes` 1 the single item runs in the single-lane layout on `mw_mul`, with MONT_LANES
+ * on `mb_mul`; `rrs` must hold R^2 mod n for the matching limb count.
+ */
+static msg mb_exp_group(OUT bigint** dsts, IN bigint* const* bases, IN const bigint* const* exps, IN const bi_mont_ctx* const* ctxs, IN const bigint* const* rrs, IN int lane_num, IN int lanes, IN int secure)
+{
+    void (*mul)(uint64_t*, const uint64_t*, const uint64_t*, const uint64_t*, const uint64_t*, int, uint64_t*) = (lanes == 1) ? mw_mul : mb_mul;
+    int word_len = ctxs[0]->word_len;
+    int limb_len = (lanes == 1) ? mw_limb_len(word_len) : mb_limb_len(word_len);
+    int bits = 0;
+
+    for(int l = 0; l < lane_num; l++)
+    {
+        int lane_bits = exps[l]->word_len * SIZEOFWORD;
+
+        while(!secure && (lane_bits > 0) && (((exps[l]->a[(lane_bits - 1) / SIZEOFWORD] >> ((lane_bits - 1) % SIZEOFWORD)) & 1) == 0))
+        {
+            lane_bits--;
+        }
+        bits = (lane_bits > bits) ? lane_bits : bits;
+    }
+
+    int window = bi_mont_window(bits);
+    int table_num = 1 << window;
+    size_t vec_len = (size_t)lanes * limb_len;
+    int vec_num = (int)(vec_len / 4);
+    size_t buf_len = (size_t)(9 + table_num) * vec_len + 16 + 2 * MONT_LANES + 4;
+    word* raw = (word*)bi_mem_alloc(sizeof(uint64_t) * buf_len);
+    uint64_t* buf = (uint64_t*)(((uintptr_t)raw + 31) & ~(uintptr_t)31);     //32-byte aligned vectors
+    uint64_t* n = buf;
+    uint64_t* rr = n + vec_len;
+    uint64_t* one = rr + vec_len;
+    uint64_t* acc = one + vec_len;
+    uint64_t* sel = acc + vec_len;
+    uint64_t* t = sel + vec_len;                            //4 * vec_len + 16
+    uint64_t* n0 = t + 4 * vec_len + 16;
+    uint64_t* digits = n0 + MONT_LANES;
+    uint64_t* table = digits + MONT_LANES;
+    int pos = ((bits + window - 1) / window - 1) * window;
+    msg error_msg = SUCCESS;
+
+    if(raw == NULL)
+    {
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        return FAILED;
+    }
+
+    for(int l = 0; l < MONT_LANES; l++)
+    {
+        int src = (l < lane_num) ? l : 0;
+        const bi_mont_ctx* ctx = ctxs[src];
+        const bigint* base = bases[src];
+        bigint modulus;
+        bigint* reduced = NULL;
+        bigint* quotient = NULL;
+
+        mb_modulus(&modulus, ctx);
+        if(bi_compare(base, &modulus) >= 0)
+        {
+            bi_word_division(&quotient, &reduced, base, &modulus);
+            base = reduced;
+        }
+        if(l < lanes)
+        {
+            mb_load(n, lanes, l, ctx->n, word_len, limb_len);
+            mb_load(rr, lanes, l, rrs[src]->a, rrs[src]->word_len, limb_len);
+            mb_load(acc, lanes, l, base->a, base->word_len, limb_len);
+            one[l] = 1;
+        }
+        n0[l] = (uint64_t)ctx->n0 & MB_MASK;
+        bi_delete(&reduced);
+        bi_delete(&quotient);
+    }
+
+    //table[i] = base^i * R mod n, lane by lane
+    mul(table, one, rr, n, n0, limb_len, t);
+    mul(table + vec_len, acc, rr, n, n0, limb_len, t);
+    for(int i = 2; i < table_num; i++)
+    {
+        mul(table + i * vec_len, table + (i - 1) * vec_len, table + vec_len, n, n0, limb_len, t);
+    }
+
+    if(secure || (bits == 0))
+    {
+        memcpy(acc, table, sizeof(uint64_t) * vec_len);
+    }
+    else
+    {
+        for(int l = 0; l < MONT_LANES; l++)
+        {
+            digits[l] = mb_digit(exps[(l < lane_num) ? l : 0], pos, window);
+        }
+        mb_select(acc, table, table_num, vec_num, digits);
+        pos -= window;
+    }
+    for(; pos >= 0; pos -= window)
+    {
+        uint64_t any = 0;
+
+        for(int l = 0; l < MONT_LANES; l++)
+        {
+            digits[l] = mb_digit(exps[(l < lane_num) ? l : 0], pos, window);
+            any |= digits[l];
+        }
+        for(int k = 0; k < window; k++)
+        {
+            mul(acc, acc, acc, n, n0, limb_len, t);
+        }
+        if(secure || (any != 0))
+        {
+            mb_select(sel, table, table_num, vec_num, digits);
+            mul(acc, acc, sel, n, n0, limb_len, t);
+        }
+    }
+    mul(acc, acc, one, n, n0, limb_len, t);        //leave the Montgomery domain, the result is at most n
+
+    for(int l = 0; (error_msg == SUCCESS) && (l < lane_num); l++)
+    {
+        bigint modulus;
+
+        mb_modulus(&modulus, ctxs[l]);
+        error_msg = mb_store(&dsts[l], acc, lanes, l, limb_len, &modulus);
+    }
+    bi_mem_free(raw, sizeof(uint64_t) * buf_len);
+
+    return error_msg;
+}
+
+/**
+ * @brief Runs the items in groups of MONT_LANES on the AVX2 engine.
+ *
+ * R^2 mod n for the engine's R is computed once for a shared context and once per lane
+ * otherwise. Groups whose moduli have different word lengths run on the scalar path.
+ */
+static msg mont_exp_avx2(OUT bigint** dsts, IN bigint* const* bases, IN const bigint* const* exps, IN const bi_mont_ctx* const* ctxs, IN int ctx_num, IN int num, IN int secure)
+{
+    bigint* rr[MONT_LANES] = {NULL};
+    msg error_msg = SUCCESS;
+
+    for(int i = 0; (error_msg == SUCCESS) && (i < num); i += MONT_LANES)
+    {
+        int lane_num = (num - i < MONT_LANES) ? num - i : MONT_LANES;
+        const bi_mont_ctx* lane_ctxs[MONT_LANES];
+        const bigint* lane_rrs[MONT_LANES];
+        int same_len = 1;
+
+        for(int l = 0; l < lane_num; l++)
+        {
+            lane_ctxs[l] = ctxs[(ctx_num == 1) ? 0 : i + l];
+            same_len &= (lane_ctxs[l]->word_len == lane_ctxs[0]->word_len);
+        }
+        if(!same_len)
+        {
+            error_msg = mont_exp_scalar(dsts, bases, exps, ctxs, ctx_num, i, i + lane_num, secure);
+            continue;
+        }
+
+        int limb_len = mb_limb_len(lane_ctxs[0]->word_len);
+
+        for(int l = 0; (error_msg == SUCCESS) && (l < lane_num); l++)
+        {
+            if((ctx_num == 1) && (rr[0] != NULL))
+            {
+                lane_rrs[l] = rr[0];
+            }
+            else if((l > 0) && (lane_ctxs[l] == lane_ctxs[l - 1]))
+            {
+                lane_rrs[l] = lane_rrs[l - 1];
+            }
+            else
+            {
+                error_msg = mb_rr(&rr[l], lane_ctxs[l], limb_len);
+                lane_rrs[l] = rr[l];
+            }
+        }
+        if(error_msg == SUCCESS)
+        {
+            error_msg = mb_exp_group(dsts + i, bases + i, exps + i, lane_ctxs, lane_rrs, lane_num, MONT_LANES, secure);
+        }
+    }
+
+    for(int l = 0; l < MONT_LANES; l++)
+    {
+        bi_delete(&rr[l]);
+    }
+    return error_msg;
+}
+#endif
+
+/**
+ * @brief Computes R^2 mod n for the single-lane layout of `mont_avx2_exp`, with R = 2^(29 L).
+ *
+ * `bi_mont_init` stores it in the context as `avx2_rr`, so an exponentiation needs no division.
+ *
+ * @param[out] rr The result, `ctx->word_len` words.
+ * @param[in] ctx The Montgomery context of n; `n` and `word_len` are set.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg mont_avx2_rr(OUT word* rr, IN const bi_mont_ctx* ctx)
+{
+#if MONT_AVX2
+    bigint* value = NULL;
+
+    if(mb_rr(&value, ctx, mw_limb_len(ctx->word_len)) == FAILED)
+    {
+        return FAILED;
+    }
+    array_init(rr, ctx->word_len);
+    array_copy(rr, value->a, value->word_len);
+    bi_delete(&value);
+
+    return SUCCESS;
+#else
+    (void)rr;
+    (void)ctx;
+    fprintf(stderr, ERR_INVALID_INPUT);
+    return FAILED;
+#endif
+}
+
+/**
+ * @brief Single modular exponentiation `dst = base^exp mod n` on the AVX2 engine, for large moduli.
+ *
+ * Runs the lockstep exponentiation with one lane in the single-lane layout, where every vector
+ * operation works on four limbs of the same value. `bi_mont_exp` calls it for contexts with an
+ * `avx2_rr`, i.e. moduli of MONT_AVX2_WIDE bits or more; the arguments are already checked there.
+ *
+ * @param[out] dst The result bigint (may be `base`).
+ * @param[in] base The non-negative base (reduced modulo n first if needed).
+ * @param[in] exp The non-negative exponent.
+ * @param[in] ctx The Montgomery context of n.
+ * @param[in] secure 1 for the exponent-independent operation sequence of SECURE_SCA, 0 for a public exponent.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg mont_avx2_exp(OUT bigint** dst, IN const bigint* base, IN const bigint* exp, IN const bi_mont_ctx* ctx, IN int secure)
+{
+#if MONT_AVX2
+    bigint* const bases[1] = {(bigint*)base};      //only read
+    const bigint* const exps[1] = {exp};
+    const bi_mont_ctx* ctxs[1] = {ctx};
+    const bigint* rrs[1];
+    bigint rr;
+
+    if(ctx->avx2_rr == NULL)
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    mb_modulus(&rr, ctx);       //a view of the cached R^2 of the engine, as long as n
+    rr.a = ctx->avx2_rr;
+    rrs[0] = &rr;
+
+    return mb_exp_group(dst, bases, exps, ctxs, rrs, 1, 1, secure);
+#else
+    (void)dst;
+    (void)base;
+    (void)exp;
+    (void)ctx;
+    (void)secure;
+    fprintf(stderr, ERR_INVALID_INPUT);
+    return FAILED;
+#endif
+}
+
+/**
+ * @brief Checks the arguments of the multi-buffer exponentiations and runs them.
+ */
+static msg mont_exp_multi(OUT bigint** dsts, IN bigint* const* bases, IN const bigint* const* exps, IN const bi_mont_ctx* const* ctxs, IN int ctx_num, IN int num, IN int secure)
+{
+    if((dsts == NULL) || (bases == NULL) || (exps == NULL) || (ctxs == NULL) || (num < 0) || ((ctx_num != 1) && (ctx_num != num)))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    for(int i = 0; i < num; i++)
+    {
+        const bi_mont_ctx* ctx = ctxs[(ctx_num == 1) ? 0 : i];
+
+        if((ctx == NULL) || (ctx->n == NULL) || (bases[i] == NULL) || (bases[i]->a == NULL) || (bases[i]->sign == NEGATIVE) ||
+            (exps[i] == NULL) || (exps[i]->a == NULL) || (exps[i]->sign == NEGATIVE))
+        {
+            fprintf(stderr, ERR_INVALID_INPUT);
+            return FAILED;
+        }
+    }
+
+#if MONT_AVX2
+    if(mont_avx2_supported())
+    {
+        return mont_exp_avx2(dsts, bases, exps, ctxs, ctx_num, num, secure);
+    }
+#endif
+    return mont_exp_scalar(dsts, bases, exps, ctxs, ctx_num, 0, num, secure);
+}
+
+/**
+ * @brief Multi-buffer modular exponentiation: `dsts[i] = bases[i]^exps[i] mod n_i`.
+ *
+ * On CPUs with AVX2 the items run MONT_LANES at a time, one per 64-bit vector lane, in radix
+ * 2^29; otherwise, and for groups whose moduli differ in length, they run one by one with
+ * `bi_mont_exp`. With SECURE_SCA the operation sequence and memory accesses do not depend on
+ * the exponent bits, as in `bi_mont_exp`.
+ *
+ * @param[out] dsts Array of `num` result bigints; an entry may be NULL or reused (`dsts[i]` may be `bases[i]`).
+ * @param[in] bases Array of `num` non-negative bases (reduced modulo n first if needed).
+ * @param[in] exps Array of `num` non-negative exponents.
+ * @param[in] ctxs Array of `ctx_num` Montgomery contexts.
+ * @param[in] ctx_num 1 to use `ctxs[0]` for every item, or `num` for one modulus per item.
+ * @param[in] num The number of items.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_mont_exp_multi(OUT bigint** dsts, IN bigint* const* bases, IN const bigint* const* exps, IN const bi_mont_ctx* const* ctxs, IN int ctx_num, IN int num)
+{
+    return mont_exp_multi(dsts, bases, exps, ctxs, ctx_num, num, SECURE_SCA == 1);
+}
+
+/**
+ * @brief Multi-buffer modular exponentiation for public exponents, always variable time.
+ *
+ * Same as `bi_mont_exp_multi`, but leading zero bits are skipped and windows that are zero in
+ * every lane of a group cost no multiplication. Never use it with a secret exponent.
+ *
+ * @param[out] dsts Array of `num` result bigints; an entry may be NULL or reused (`dsts[i]` may be `bases[i]`).
+ * @param[in] bases Array of `num` non-negative bases (reduced modulo n first if needed).
+ * @param[in] exps Array of `num` non-negative public exponents.
+ * @param[in] ctxs Array of `ctx_num` Montgomery contexts.
+ * @param[in] ctx_num 1 to use `ctxs[0]` for every item, or `num` for one modulus per item.
+ * @param[in] num The number of items.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_mont_exp_public_multi(OUT bigint** dsts, IN bigint* const* bases, IN const bigint* const* exps, IN const bi_mont_ctx* const* ctxs, IN int ctx_num, IN int num)
+{
+    return mont_exp_multi(dsts, bases, exps, ctxs, ctx_num, num, 0);
+}
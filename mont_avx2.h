@@ -0,0 +1,25 @@
+#ifndef MONT_AVX2_H
+#define MONT_AVX2_H
+
+#include "dtype.h"
+#include "montgomery.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define MONT_AVX2   1       //the AVX2 engine is compiled in; it runs only if the CPU has AVX2
+#else
+    #define MONT_AVX2   0
+#endif
+
+#define MONT_LANES      4       //exponentiations run in lockstep by the AVX2 engine
+
+int mont_avx2_supported();
+
+msg mont_avx2_rr(OUT word* rr, IN const bi_mont_ctx* ctx);
+
+msg mont_avx2_exp(OUT bigint** dst, IN const bigint* base, IN const bigint* exp, IN const bi_mont_ctx* ctx, IN int secure);
+
+msg bi_mont_exp_multi(OUT bigint** dsts, IN bigint* const* bases, IN const bigint* const* exps, IN const bi_mont_ctx* const* ctxs, IN int ctx_num, IN int num);
+
+msg bi_mont_exp_public_multi(OUT bigint** dsts, IN bigint* const* bases, IN const bigint* const* exps, IN const bi_mont_ctx* const* ctxs, IN int ctx_num, IN int num);
+
+#endif
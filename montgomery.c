@@ -0,0 +1,780 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "montgomery.h"
+#include "mont_avx2.h"
+#include "cpu.h"
+#include "operation.h"
+#include "bigintfun.h"
+#include "arrayfun.h"
+#include "wordfun.h"
+#include "mempool.h"
+#include "params.h"
+#include "errormsg.h"
+
+//kernels are written once and expanded with a constant word_len for each fixed size
+#if defined(__GNUC__)
+    #define MONT_INLINE static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+    #define MONT_INLINE static __forceinline
+#else
+    #define MONT_INLINE static inline
+#endif
+
+//unroll hint for the inner loops; their trip count depends on the column, so this is partial unrolling
+#if defined(__clang__)
+    #define MONT_UNROLL _Pragma("unroll 64")
+#elif defined(__GNUC__) && (__GNUC__ >= 8)
+    #define MONT_UNROLL _Pragma("GCC unroll 64")
+#else
+    #define MONT_UNROLL
+#endif
+
+/***********************************************
+ * Word Arithmetic
+ ***********************************************/
+/**
+ * @brief Adds `x * y` to the three-word column accumulator (c0, c1, c2).
+ */
+MONT_INLINE void mont_acc(word* c0, word* c1, word* c2, word x, word y)
+{
+#if HAVE_DWORD
+    dword p = (dword)x * y;
+    dword sum = (((dword)*c1 << SIZEOFWORD) | *c0) + p;
+
+    *c2 += (sum < p);
+    *c0 = (word)sum;
+    *c1 = (word)(sum >> SIZEOFWORD);
+#else
+    word hi;
+    word lo = word_mul_add(&hi, x, y, *c0, 0);
+
+    *c0 = lo;
+    *c1 += hi;
+    *c2 += (*c1 < hi);
+#endif
+}
+
+/**
+ * @brief Adds twice the accumulator (d0, d1, d2) to the accumulator (c0, c1, c2).
+ */
+MONT_INLINE void mont_acc_twice(word* c0, word* c1, word* c2, word d0, word d1, word d2)
+{
+    word carry;
+
+    d2 = (d2 << 1) | (d1 >> (SIZEOFWORD - 1));
+    d1 = (d1 << 1) | (d0 >> (SIZEOFWORD - 1));
+    d0 <<= 1;
+    *c0 += d0;
+    carry = (*c0 < d0);
+    d1 += carry;
+    carry = (d1 < carry);
+    *c1 += d1;
+    carry += (*c1 < d1);
+    *c2 += d2 + carry;
+}
+
+/**
+ * @brief Stores `t mod n` in `r` for `t < 2n`, where `t` is `word_len` words plus the bit `top`.
+ *
+ * Always subtracts and then selects with a mask, so the timing does not depend on `t`.
+ */
+MONT_INLINE void mont_final_sub(word* r, const word* t, word top, const word* n, int word_len)
+{
+    word borrow = 0;
+    word keep;
+
+    MONT_UNROLL
+    for(int j = 0; j < word_len; j++)
+    {
+        word diff = t[j] - n[j];
+        word next = (t[j] < n[j]);
+
+        next |= (diff < borrow);
+        r[j] = diff - borrow;
+        borrow = next;
+    }
+    keep = (word)0 - (word)(top < borrow);      //t < n: keep t
+    MONT_UNROLL
+    for(int j = 0; j < word_len; j++)
+    {
+        r[j] = (t[j] & keep) | (r[j] & ~keep);
+    }
+}
+
+/***********************************************
+ * Montgomery Kernels
+ ***********************************************/
+/**
+ * @brief Montgomery multiplication, finely integrated product scanning (FIPS).
+ *
+ * Each result column sums its products of `a * b` and `m * n` in a three-word accumulator,
+ * so the inner loops only read memory. The quotient words `m` and the result go to `t`,
+ * which needs 2 * word_len words.
+ */
+MONT_INLINE void mont_mul_core(word* r, const word* a, const word* b, const word* n, word n0, int word_len, word* t)
+{
+    word c0 = 0, c1 = 0, c2 = 0;
+    word* m = t;
+    word* u = t + word_len;
+
+    for(int i = 0; i < word_len; i++)
+    {
+        MONT_UNROLL
+        for(int j = 0; j < i; j++)
+        {
+            mont_acc(&c0, &c1, &c2, a[j], b[i - j]);
+            mont_acc(&c0, &c1, &c2, m[j], n[i - j]);
+        }
+        mont_acc(&c0, &c1, &c2, a[i], b[0]);
+        m[i] = c0 * n0;
+        mont_acc(&c0, &c1, &c2, m[i], n[0]);     //the low word becomes zero
+        c0 = c1;
+        c1 = c2;
+        c2 = 0;
+    }
+    for(int i = word_len; i < 2 * word_len - 1; i++)
+    {
+        MONT_UNROLL
+        for(int j = i - word_len + 1; j < word_len; j++)
+        {
+            mont_acc(&c0, &c1, &c2, a[j], b[i - j]);
+            mont_acc(&c0, &c1, &c2, m[j], n[i - j]);
+        }
+        u[i - word_len] = c0;
+        c0 = c1;
+        c1 = c2;
+        c2 = 0;
+    }
+    u[word_len - 1] = c0;
+    mont_final_sub(r, u, c1, n, word_len);
+}
+
+/**
+ * @brief Montgomery squaring with FIPS, computing each cross product once.
+ *
+ * The cross products of a column are summed in a second accumulator that is added twice.
+ * `t` needs 2 * word_len words.
+ */
+MONT_INLINE void mont_sqr_core(word* r, const word* a, const word* n, word n0, int word_len, word* t)
+{
+    word c0 = 0, c1 = 0, c2 = 0;
+    word* m = t;
+    word* u = t + word_len;
+
+    for(int i = 0; i < word_len; i++)
+    {
+        word d0 = 0, d1 = 0, d2 = 0;
+
+        MONT_UNROLL
+        for(int j = 0; j < i - j; j++)
+        {
+            mont_acc(&d0, &d1, &d2, a[j], a[i - j]);
+        }
+        mont_acc_twice(&c0, &c1, &c2, d0, d1, d2);
+        if((i & 1) == 0)
+        {
+            mont_acc(&c0, &c1, &c2, a[i / 2], a[i / 2]);
+        }
+        MONT_UNROLL
+        for(int j = 0; j < i; j++)
+        {
+            mont_acc(&c0, &c1, &c2, m[j], n[i - j]);
+        }
+        m[i] = c0 * n0;
+        mont_acc(&c0, &c1, &c2, m[i], n[0]);
+        c0 = c1;
+        c1 = c2;
+        c2 = 0;
+    }
+    for(int i = word_len; i < 2 * word_len - 1; i++)
+    {
+        word d0 = 0, d1 = 0, d2 = 0;
+
+        MONT_UNROLL
+        for(int j = i - word_len + 1; j < i - j; j++)
+        {
+            mont_acc(&d0, &d1, &d2, a[j], a[i - j]);
+        }
+        mont_acc_twice(&c0, &c1, &c2, d0, d1, d2);
+        if((i & 1) == 0)
+        {
+            mont_acc(&c0, &c1, &c2, a[i / 2], a[i / 2]);
+        }
+        MONT_UNROLL
+        for(int j = i - word_len + 1; j < word_len; j++)
+        {
+            mont_acc(&c0, &c1, &c2, m[j], n[i - j]);
+        }
+        u[i - word_len] = c0;
+        c0 = c1;
+        c1 = c2;
+        c2 = 0;
+    }
+    u[word_len - 1] = c0;
+    mont_final_sub(r, u, c1, n, word_len);
+}
+
+static void mont_mul_generic(word* r, const word* a, const word* b, const word* n, word n0, int word_len, word* t)
+{
+    mont_mul_core(r, a, b, n, n0, word_len, t);
+}
+
+static void mont_sqr_generic(word* r, const word* a, const word* n, word n0, int word_len, word* t)
+{
+    mont_sqr_core(r, a, n, n0, word_len, t);
+}
+
+/**
+ * @brief Montgomery reduction of the 2 * word_len-word product in `t` by rows of `array_addmul_1`.
+ *
+ * Each row adds `m * n` to zero the lowest live word; the carry of a row meets the product word
+ * above it, and the bit that overflows is kept for the next row and finally in `top`.
+ */
+static void mont_redc_rows(word* r, word* t, const word* n, word n0, int word_len)
+{
+    word top = 0;
+
+    for(int i = 0; i < word_len; i++)
+    {
+        word carry = array_addmul_1(t + i, n, word_len, t[i] * n0);
+
+        t[i + word_len] = word_add_c(&top, t[i + word_len], carry, top);
+    }
+    mont_final_sub(r, t + word_len, top, n, word_len);
+}
+
+/**
+ * @brief Montgomery multiplication, separated operand scanning: the product and the reduction
+ * are each a row of `array_addmul_1` per word, so a MULX/ADCX/ADOX `addmul_1` carries it.
+ */
+static void mont_mul_rows(word* r, const word* a, const word* b, const word* n, word n0, int word_len, word* t)
+{
+    array_init(t, word_len);
+    for(int i = 0; i < word_len; i++)
+    {
+        t[i + word_len] = array_addmul_1(t + i, b, word_len, a[i]);
+    }
+    mont_redc_rows(r, t, n, n0, word_len);
+}
+
+/**
+ * @brief Montgomery squaring with separated operand scanning: the cross products by rows,
+ * doubled with one shift, then the squares of the words on the diagonal.
+ */
+static void mont_sqr_rows(word* r, const word* a, const word* n, word n0, int word_len, word* t)
+{
+    word carry = 0;
+
+    array_init(t, 2 * word_len);
+    for(int i = 0; i + 1 < word_len; i++)
+    {
+        t[i + word_len] = array_addmul_1(t + 2 * i + 1, a + i + 1, word_len - 1 - i, a[i]);
+    }
+    array_lshift(t, t, 2 * word_len, 1);        //the cross products are below W^(2 word_len) / 2
+    for(int i = 0; i < word_len; i++)
+    {
+        word hi;
+        word lo = word_mul(&hi, a[i], a[i]);
+
+        t[2 * i] = word_add_c(&carry, t[2 * i], lo, carry);
+        t[2 * i + 1] = word_add_c(&carry, t[2 * i + 1], hi, carry);
+    }
+    mont_redc_rows(r, t, n, n0, word_len);
+}
+
+//kernels for a compile-time word length: the loop bounds and offsets are constants, the loops stay loops
+#define MONT_FIXED_KERNELS(N)                                                                                   \
+    static void mont_mul_##N(word* r, const word* a, const word* b, const word* n, word n0, int word_len, word* t) \
+    {                                                                                                           \
+        (void)word_len;                                                                                         \
+        mont_mul_core(r, a, b, n, n0, N, t);                                                                    \
+    }                                                                                                           \
+    static void mont_sqr_##N(word* r, const word* a, const word* n, word n0, int word_len, word* t)             \
+    {                                                                                                           \
+        (void)word_len;                                                                                         \
+        mont_sqr_core(r, a, n, n0, N, t);                                                                       \
+    }
+
+#if SIZEOFWORD == 64
+MONT_FIXED_KERNELS(16)      //1024 bits
+MONT_FIXED_KERNELS(22)      //1366 bits, primes of 3-prime 4096-bit keys
+MONT_FIXED_KERNELS(32)      //2048 bits
+MONT_FIXED_KERNELS(48)      //3072 bits
+MONT_FIXED_KERNELS(60)      //3840 bits, primes of 4-prime 15360-bit keys
+MONT_FIXED_KERNELS(64)      //4096 bits
+MONT_FIXED_KERNELS(80)      //5120 bits, primes of 3-prime 15360-bit keys
+#endif
+
+/**
+ * @brief Binds the Montgomery kernels of a `cpu_kernels` table for the given extensions.
+ *
+ * The table serves the moduli without a fixed-size kernel. With MULX/ADCX/ADOX the row kernels
+ * beat the generic product scanning kernels, but not the fixed-size ones, which stay in use.
+ *
+ * @param[out] kernels Pointer to the table.
+ * @param[in] features The `CPU_*` flags the kernels may use, all supported by the CPU.
+ *
+ * @return void
+ */
+void mont_kernels_bind(OUT cpu_kernels* kernels, IN int features)
+{
+    if((features & CPU_TIER_ADX) == CPU_TIER_ADX)
+    {
+        kernels->mont_mul = mont_mul_rows;
+        kernels->mont_sqr = mont_sqr_rows;
+    }
+    else
+    {
+        kernels->mont_mul = mont_mul_generic;
+        kernels->mont_sqr = mont_sqr_generic;
+    }
+}
+
+/***********************************************
+ * Montgomery Context
+ ***********************************************/
+/**
+ * @brief Initializes a Montgomery context for an odd modulus.
+ *
+ * Computes -n^(-1) mod W by Newton iteration and R^2 mod n by one division, and selects
+ * the fixed-size kernels when the modulus has 1024, 2048, 3072 or 4096 bits, or the prime sizes of
+ * 3- and 4-prime 4096- and 15360-bit keys (64-bit words). For a modulus of MONT_AVX2_WIDE bits
+ * or more on a CPU with AVX2, the R^2 mod n of the AVX2 engine is computed here as well.
+ * Release the context with `bi_mont_clear`.
+ *
+ * @param[out] ctx Pointer to the context to be initialized.
+ * @param[in] mod The odd, positive modulus.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_mont_init(OUT bi_mont_ctx* ctx, IN const bigint* mod)
+{
+    if((ctx == NULL) || (mod == NULL) || (mod->a == NULL) || (mod->sign != POSITIVE) || ((mod->a[0] & 1) == 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    int word_len = mod->word_len;
+    int avx2 = (word_len * SIZEOFWORD >= MONT_AVX2_WIDE) && mont_avx2_supported();
+    word inv = mod->a[0];       //correct to 3 bits for odd n
+    bigint* r2 = NULL;
+    bigint* quotient = NULL;
+    bigint* remainder = NULL;
+
+    for(int bits = 3; bits < SIZEOFWORD; bits *= 2)
+    {
+        inv *= 2 - mod->a[0] * inv;
+    }
+
+    ctx->word_len = word_len;
+    ctx->n0 = (word)0 - inv;
+    ctx->n = (word*)bi_mem_alloc(sizeof(word) * (avx2 ? 3 : 2) * word_len);
+    if(ctx->n == NULL)
+    {
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        return FAILED;
+    }
+    ctx->rr = ctx->n + word_len;
+    ctx->avx2_rr = NULL;
+    array_copy(ctx->n, mod->a, word_len);
+
+    if(bi_new(&r2, 2 * word_len + 1) == FAILED)
+    {
+        bi_mont_clear(ctx);
+        return FAILED;
+    }
+    r2->sign = POSITIVE;
+    r2->a[2 * word_len] = 1;
+    if(bi_word_division(&quotient, &remainder, r2, mod) == FAILED)
+    {
+        bi_delete(&r2);
+        bi_mont_clear(ctx);
+        return FAILED;
+    }
+    array_copy(ctx->rr, remainder->a, remainder->word_len);     //the rest stays zero
+    bi_delete(&remainder);
+    bi_delete(&quotient);
+    bi_delete(&r2);
+    if(avx2)
+    {
+        ctx->avx2_rr = ctx->rr + word_len;
+        if(mont_avx2_rr(ctx->avx2_rr, ctx) == FAILED)
+        {
+            bi_mont_clear(ctx);
+            return FAILED;
+        }
+    }
+
+    switch(word_len)
+    {
+#if SIZEOFWORD == 64
+    case 16: ctx->mul = mont_mul_16; ctx->sqr = mont_sqr_16; break;
+    case 22: ctx->mul = mont_mul_22; ctx->sqr = mont_sqr_22; break;
+    case 32: ctx->mul = mont_mul_32; ctx->sqr = mont_sqr_32; break;
+    case 48: ctx->mul = mont_mul_48; ctx->sqr = mont_sqr_48; break;
+    case 60: ctx->mul = mont_mul_60; ctx->sqr = mont_sqr_60; break;
+    case 64: ctx->mul = mont_mul_64; ctx->sqr = mont_sqr_64; break;
+    case 80: ctx->mul = mont_mul_80; ctx->sqr = mont_sqr_80; break;
+#endif
+    default: ctx->mul = cpu_kernels_get()->mont_mul; ctx->sqr = cpu_kernels_get()->mont_sqr; break;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Releases the memory of a Montgomery context (cleared with ZERORIZE).
+ *
+ * @param[inout] ctx Pointer to the context.
+ *
+ * @return void
+ */
+void bi_mont_clear(INOUT bi_mont_ctx* ctx)
+{
+    if(ctx == NULL)
+    {
+        return;
+    }
+    bi_mem_free(ctx->n, sizeof(word) * ((ctx->avx2_rr != NULL) ? 3 : 2) * ctx->word_len);
+    memset(ctx, 0, sizeof(bi_mont_ctx));
+}
+
+/***********************************************
+ * Montgomery Multiplication
+ ***********************************************/
+/**
+ * @brief Stores `a * b / R mod n` in `dst`; `b` is a word array of `b_len` words.
+ */
+static msg mont_mul_words(OUT bigint** dst, IN const bigint* a, IN const word* b, IN int b_len, IN const bi_mont_ctx* ctx)
+{
+    int word_len = ctx->word_len;
+    size_t buf_len = (size_t)4 * word_len + 2;
+    word* buf = NULL;
+
+    if((a == NULL) || (a->a == NULL) || (a->sign == NEGATIVE) || (a->word_len > word_len) || (b_len > word_len))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    buf = (word*)bi_mem_alloc(sizeof(word) * buf_len);
+    if(buf == NULL)
+    {
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        return FAILED;
+    }
+
+    //the operands are copied first, so `dst` may be `a`
+    array_copy(buf, a->a, a->word_len);
+    array_copy(buf + word_len, b, b_len);
+    ctx->mul(buf, buf, buf + word_len, ctx->n, ctx->n0, word_len, buf + 2 * word_len);
+
+    if(bi_new(dst, word_len) == FAILED)
+    {
+        bi_mem_free(buf, sizeof(word) * buf_len);
+        return FAILED;
+    }
+    array_copy((*dst)->a, buf, word_len);
+    (*dst)->sign = POSITIVE;
+    bi_refine(*dst);
+    bi_mem_free(buf, sizeof(word) * buf_len);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Montgomery multiplication: `dst = a * b / R mod n`.
+ *
+ * With one operand in Montgomery form (x * R mod n) the result is the plain product
+ * `a * x mod n`; with both in Montgomery form it stays in Montgomery form.
+ *
+ * @param[out] dst Pointer to the result bigint (may be `a` or `b`).
+ * @param[in] a, b The non-negative operands, smaller than n.
+ * @param[in] ctx The Montgomery context of the modulus.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_mont_mul(OUT bigint** dst, IN const bigint* a, IN const bigint* b, IN const bi_mont_ctx* ctx)
+{
+    if((ctx == NULL) || (b == NULL) || (b->a == NULL) || (b->sign == NEGATIVE))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    return mont_mul_words(dst, a, b->a, b->word_len, ctx);
+}
+
+/**
+ * @brief Converts to Montgomery form: `dst = src * R mod n`.
+ *
+ * @param[out] dst Pointer to the result bigint (may be `src`).
+ * @param[in] src The non-negative value, smaller than n.
+ * @param[in] ctx The Montgomery context of the modulus.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_mont_to(OUT bigint** dst, IN const bigint* src, IN const bi_mont_ctx* ctx)
+{
+    if(ctx == NULL)
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    return mont_mul_words(dst, src, ctx->rr, ctx->word_len, ctx);
+}
+
+/***********************************************
+ * Montgomery Exponentiation
+ ***********************************************/
+/**
+ * @brief Returns the window size for an exponent of `bits` bits, at most MONT_WINDOW.
+ *
+ * @param[in] bits The number of exponent bits that are processed.
+ *
+ * @return The window size in bits.
+ */
+int bi_mont_window(IN int bits)
+{
+    int window = (bits > 671) ? 6 : (bits > 239) ? 5 : (bits > 79) ? 4 : (bits > 23) ? 3 : 1;
+
+    return (window < MONT_WINDOW) ? window : MONT_WINDOW;
+}
+
+/**
+ * @brief Returns `window` bits of `exp` starting at bit `pos`; bits past the exponent are zero.
+ */
+static int mont_exp_bits(IN const bigint* exp, IN int pos, IN int window)
+{
+    int digit = 0;
+
+    for(int k = window - 1; k >= 0; k--)
+    {
+        int word_index = (pos + k) / SIZEOFWORD;
+        int bit = 0;
+
+        if(word_index < exp->word_len)
+        {
+            bit = (int)((exp->a[word_index] >> ((pos + k) % SIZEOFWORD)) & 1);
+        }
+        digit = (digit << 1) | bit;
+    }
+    return digit;
+}
+
+/**
+ * @brief Copies table entry `index` to `dst`, reading every entry so the access pattern is fixed.
+ */
+static void mont_select(OUT word* dst, IN const word* table, IN int table_num, IN int word_len, IN int index)
+{
+    for(int j = 0; j < word_len; j++)
+    {
+        dst[j] = 0;
+    }
+    for(int i = 0; i < table_num; i++)
+    {
+        word diff = (word)(i ^ index);
+        word mask = ((diff | ((word)0 - diff)) >> (SIZEOFWORD - 1)) - 1;   //all ones iff i == index
+
+        for(int j = 0; j < word_len; j++)
+        {
+            dst[j] |= table[i * word_len + j] & mask;
+        }
+    }
+}
+
+/**
+ * @brief Fixed-window exponentiation in the Montgomery domain, shared by the secret and public paths.
+ *
+ * Computes `base^exp mod n` with powers base^0 ... base^(2^w - 1) precomputed in Montgomery
+ * form. With `secure` the exponent is processed over its full word length, every window
+ * performs a multiplication and table entries are read with `mont_select`, so the sequence of
+ * operations and memory accesses does not depend on the exponent bits. Otherwise leading zero
+ * bits are skipped, the accumulator starts from the top window's table entry and zero windows
+ * cost no multiplication; for e = 65537 that is 16 squarings and one multiplication.
+ */
+static msg mont_exp(OUT bigint** dst, IN const bigint* base, IN const bigint* exp, IN const bi_mont_ctx* ctx, IN int secure)
+{
+    if((base == NULL) || (exp == NULL) || (ctx == NULL) || (ctx->n == NULL) || (base->a == NULL) || (exp->a == NULL) ||
+        (base->sign == NEGATIVE) || (exp->sign == NEGATIVE))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    if(ctx->avx2_rr != NULL)
+    {
+        return mont_avx2_exp(dst, base, exp, ctx, secure);     //four limbs per vector instruction
+    }
+
+    int word_len = ctx->word_len;
+    int bits = exp->word_len * SIZEOFWORD;
+
+    while(!secure && (bits > 0) && (((exp->a[(bits - 1) / SIZEOFWORD] >> ((bits - 1) % SIZEOFWORD)) & 1) == 0))
+    {
+        bits--;     //skip leading zero bits, the exponent is public
+    }
+    int window = bi_mont_window(bits);
+    int table_num = 1 << window;
+    size_t buf_len = (size_t)(table_num + 3) * word_len + 2 * word_len + 2;
+    word* buf = (word*)bi_mem_alloc(sizeof(word) * buf_len);
+    word* table = buf;
+    word* acc = table + (size_t)table_num * word_len;
+    word* sel = acc + word_len;
+    word* one = sel + word_len;
+    word* t = one + word_len;
+    bigint modulus;
+    bigint* reduced = NULL;
+    bigint* quotient = NULL;
+    const bigint* src = base;
+    int pos = ((bits + window - 1) / window - 1) * window;
+
+    if(buf == NULL)
+    {
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        return FAILED;
+    }
+
+    modulus.sign = POSITIVE;
+    modulus.word_len = word_len;
+    modulus.capacity = word_len;
+    modulus.flags = BI_FLAG_FIXED | BI_FLAG_VIEW;
+    modulus.a = ctx->n;
+    if(bi_compare(base, &modulus) >= 0)
+    {
+        bi_word_division(&quotient, &reduced, base, &modulus);
+        src = reduced;
+    }
+
+    //table[i] = base^i * R mod n
+    one[0] = 1;
+    array_copy(acc, src->a, src->word_len);
+    ctx->mul(table, one, ctx->rr, ctx->n, ctx->n0, word_len, t);
+    ctx->mul(table + word_len, acc, ctx->rr, ctx->n, ctx->n0, word_len, t);
+    for(int i = 2; i < table_num; i++)
+    {
+        ctx->mul(table + (size_t)i * word_len, table + (size_t)(i - 1) * word_len, table + word_len, ctx->n, ctx->n0, word_len, t);
+    }
+    bi_delete(&reduced);
+    bi_delete(&quotient);
+
+    if(secure || (bits == 0))
+    {
+        array_copy(acc, table, word_len);
+    }
+    else
+    {
+        array_copy(acc, table + (size_t)mont_exp_bits(exp, pos, window) * word_len, word_len);
+        pos -= window;
+    }
+    for(; pos >= 0; pos -= window)
+    {
+        int digit = mont_exp_bits(exp, pos, window);
+
+        for(int k = 0; k < window; k++)
+        {
+            ctx->sqr(acc, acc, ctx->n, ctx->n0, word_len, t);
+        }
+        if(secure)
+        {
+            mont_select(sel, table, table_num, word_len, digit);
+            ctx->mul(acc, acc, sel, ctx->n, ctx->n0, word_len, t);
+        }
+        else if(digit != 0)
+        {
+            ctx->mul(acc, acc, table + (size_t)digit * word_len, ctx->n, ctx->n0, word_len, t);
+        }
+    }
+    ctx->mul(acc, acc, one, ctx->n, ctx->n0, word_len, t);     //leave the Montgomery domain
+
+    if(bi_new(dst, word_len) == FAILED)
+    {
+        bi_mem_free(buf, sizeof(word) * buf_len);
+        return FAILED;
+    }
+    array_copy((*dst)->a, acc, word_len);
+    (*dst)->sign = POSITIVE;
+    bi_refine(*dst);
+    bi_mem_free(buf, sizeof(word) * buf_len);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Modular exponentiation with a Montgomery context and a fixed window.
+ *
+ * Computes `base^exp mod n`. With SECURE_SCA the operation sequence and memory accesses do
+ * not depend on the exponent bits (see `mont_exp`), which is what secret exponents need.
+ *
+ * @param[out] dst Pointer to the result bigint.
+ * @param[in] base The non-negative base (reduced modulo n first if needed).
+ * @param[in] exp The non-negative exponent.
+ * @param[in] ctx The Montgomery context of the modulus.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_mont_exp(OUT bigint** dst, IN const bigint* base, IN const bigint* exp, IN const bi_mont_ctx* ctx)
+{
+    return mont_exp(dst, base, exp, ctx, SECURE_SCA == 1);
+}
+
+/**
+ * @brief Modular exponentiation for public exponents, always variable time.
+ *
+ * Leading zero bits are skipped and only set bits cost a multiplication, so short exponents
+ * such as e = 3 or e = 65537 take a handful of operations. Never use it with a secret exponent.
+ *
+ * @param[out] dst Pointer to the result bigint.
+ * @param[in] base The non-negative base (reduced modulo n first if needed).
+ * @param[in] exp The non-negative public exponent.
+ * @param[in] ctx The Montgomery context of the modulus.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_mont_exp_public(OUT bigint** dst, IN const bigint* base, IN const bigint* exp, IN const bi_mont_ctx* ctx)
+{
+    return mont_exp(dst, base, exp, ctx, 0);
+}
+
+/**
+ * @brief Modular exponentiation, using Montgomery multiplication for odd moduli.
+ *
+ * Sets up a context for `mod`, runs `bi_mont_exp` and releases the context. Even moduli
+ * fall back to the square-and-multiply routines of operation.c.
+ *
+ * @param[out] dst Pointer to the result bigint.
+ * @param[in] base The base big integer.
+ * @param[in] exp The exponent big integer.
+ * @param[in] mod The modulus big integer.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_mod_exp_mont(OUT bigint** dst, IN const bigint* base, IN const bigint* exp, IN const bigint* mod)
+{
+    if((base == NULL) || (exp == NULL) || (mod == NULL) || (base->a == NULL) || (exp->a == NULL) || (mod->a == NULL) ||
+        (base->sign != POSITIVE) || (exp->sign != POSITIVE) || (mod->sign != POSITIVE))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    if((mod->a[0] & 1) == 0)
+    {
+#if SECURE_SCA == 1
+        return bi_mod_exp_MaS(dst, base, exp, mod);
+#else
+        return bi_mod_exp_l2r(dst, base, exp, mod);
+#endif
+    }
+
+    bi_mont_ctx ctx;
+    msg error_msg;
+
+    if(bi_mont_init(&ctx, mod) == FAILED)
+    {
+        return FAILED;
+    }
+    error_msg = bi_mont_exp(dst, base, exp, &ctx);
+    bi_mont_clear(&ctx);
+
+    return error_msg;
+}
@@ -0,0 +1,50 @@
+#ifndef MONTGOMERY_H
+#define MONTGOMERY_H
+
+#include "dtype.h"
+
+/**
+ * @brief Montgomery multiplication kernel: `r = a * b / R mod n` on `word_len`-word arrays.
+ *
+ * `t` is scratch space of at least 2 * word_len + 2 words. `r` may alias `a` or `b`.
+ */
+typedef void (*mont_mul_kernel)(word* r, const word* a, const word* b, const word* n, word n0, int word_len, word* t);
+
+/**
+ * @brief Montgomery squaring kernel: `r = a * a / R mod n`, same conventions as `mont_mul_kernel`.
+ */
+typedef void (*mont_sqr_kernel)(word* r, const word* a, const word* n, word n0, int word_len, word* t);
+
+/**
+ * @struct bi_mont_ctx
+ * @brief Precomputed values for Montgomery arithmetic modulo an odd `n`, with R = W^word_len.
+ *
+ * A context is read-only after `bi_mont_init`, so one context can be shared by threads.
+ */
+typedef struct {
+    int word_len;           /**< Number of words of the modulus. */
+    word n0;                /**< -n^(-1) mod W. */
+    word* n;                /**< The modulus, `word_len` words. */
+    word* rr;               /**< R^2 mod n, `word_len` words. */
+    word* avx2_rr;          /**< R^2 mod n for the AVX2 engine's radix (`mont_avx2_rr`), or NULL if it does not serve n. */
+    mont_mul_kernel mul;    /**< Multiplication kernel for this size. */
+    mont_sqr_kernel sqr;    /**< Squaring kernel for this size. */
+} bi_mont_ctx;
+
+msg bi_mont_init(OUT bi_mont_ctx* ctx, IN const bigint* mod);
+
+void bi_mont_clear(INOUT bi_mont_ctx* ctx);
+
+msg bi_mont_mul(OUT bigint** dst, IN const bigint* a, IN const bigint* b, IN const bi_mont_ctx* ctx);
+
+msg bi_mont_to(OUT bigint** dst, IN const bigint* src, IN const bi_mont_ctx* ctx);
+
+int bi_mont_window(IN int bits);
+
+msg bi_mont_exp(OUT bigint** dst, IN const bigint* base, IN const bigint* exp, IN const bi_mont_ctx* ctx);
+
+msg bi_mont_exp_public(OUT bigint** dst, IN const bigint* base, IN const bigint* exp, IN const bi_mont_ctx* ctx);
+
+msg bi_mod_exp_mont(OUT bigint** dst, IN const bigint* base, IN const bigint* exp, IN const bigint* mod);
+
+#endif
@@ -5,96 +5,94 @@
 #include "bigintfun.h"
 #include "params.h"
 #include "errormsg.h"
+#include "arrayfun.h"
+#include "wordfun.h"
 
-/***********************************************
- * Addition
- ***********************************************/
 /**
- * @brief Adds two bigint values.
- * 
- * This function performs the addition of two `bigint` structures (`src1` and `src2`),
- * taking into account their signs. It handles cases where either or both of the 
- * `bigint` values are zero, as well as cases where the values have different signs. 
- * The result is stored in a newly allocated `bigint` structure pointed to by `dst`.
+ * @brief Returns 1 if all words of `src` are zero.
  * 
- * @param[out] dst Pointer to a pointer of the resulting `bigint` after addition.
- * @param[in] src1 Pointer to the first `bigint` to be added.
- * @param[in] src2 Pointer to the second `bigint` to be added. 
- * 
- * @return Returns 1 on success, -1 on failure.
+ * Every word is read, so the check takes the same time for every value of a given length.
  */
-msg bi_add(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
+static int is_zero(IN const bigint* src)
 {
-    msg error_msg = FAILED;
+    word acc = 0;
 
-    bigint* temp_src1 = NULL;       
-    bigint* temp_src2 = NULL;
-    
-    word temp1 = 0;
-    word temp2 = 0;
-
-    //src1, src2 -> temp_src1, temp_src2
-    error_msg = bi_assign(&temp_src1, src1);
-    if(error_msg == FAILED){
-        return FAILED;
-    }
-    error_msg = bi_assign(&temp_src2, src2);
-    if(error_msg == FAILED){
-        return FAILED;
+    for(int index = 0; index < src->word_len; index++)
+    {
+        acc |= src->a[index];
     }
+    return acc == 0;
+}
+
+/**
+ * @brief Stores `src1 + sign2 * |src2|` in `dst`, the common part of addition and subtraction.
+ * 
+ * Same signs add the magnitudes; different signs subtract the smaller magnitude from the
+ * larger one. `dst` may be `src1` or `src2`; the operands are never copied.
+ */
+static msg add_signed(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2, IN int sign2)
+{
+    msg error_msg = FAILED;
+    int cmp = 0;
 
     //check ZERO satisfy constant time
-    for(int index = 0; index < temp_src1->word_len; index++)
+    if(is_zero(src2))
     {
-        temp1 |= temp_src1->a[index];
+        return bi_assign(dst, src1);
     }
-    for(int index = 0; index < temp_src2->word_len; index++)
+    if(is_zero(src1))
     {
-        temp2 |= temp_src2->a[index];
+        error_msg = bi_assign(dst, src2);
+        if(error_msg == SUCCESS)
+        {
+            (*dst)->sign = sign2;
+        }
+        return error_msg;
     }
 
-    if(temp1 == 0){
-        error_msg = bi_assign(dst, temp_src2);
+    if(src1->sign == sign2)
+    {
+        return add_same_sign(dst, src1, src2);
     }
 
-    else if(temp2 == 0){
-        error_msg = bi_assign(dst, temp_src1);
-    }
-    else if((temp_src1->sign == POSITIVE) && (temp_src2->sign == NEGATIVE)){
-        temp_src2->sign = POSITIVE;
-        error_msg = bi_sub(dst, temp_src1, temp_src2);
-    }
-    else if((temp_src1->sign ==  NEGATIVE) && (temp_src2->sign ==  POSITIVE)){
-        temp_src1->sign = POSITIVE;
-        error_msg = bi_sub(dst, temp_src2, temp_src1);
-    }
-    else if ((bi_compare(temp_src1, temp_src2) == 1) || (bi_compare(temp_src1, temp_src2) == 0)){
-        error_msg = add_same_sign(dst, temp_src1, temp_src2);
-    }
-    else{   
-        error_msg = add_same_sign(dst, temp_src2, temp_src1);
+    cmp = bi_compare_abs(src1, src2);
+    if(cmp == 0)
+    {
+        return bi_new(dst, 1);
     }
-
-    error_msg = bi_delete(&temp_src1);
-    if(error_msg == FAILED)
+    if(cmp > 0)
     {
-        return FAILED;
+        int sign = src1->sign;
+
+        error_msg = bi_subc(dst, src1, src2);
+        if(error_msg == SUCCESS)
+        {
+            (*dst)->sign = sign;
+        }
     }
-    error_msg = bi_delete(&temp_src2);
-    if(error_msg == FAILED)
+    else
     {
-        return FAILED;
+        error_msg = bi_subc(dst, src2, src1);
+        if(error_msg == SUCCESS)
+        {
+            (*dst)->sign = sign2;
+        }
     }
-    return SUCCESS;
+
+    return error_msg;
 }
 
+/***********************************************
+ * Addition
+ ***********************************************/
 /**
- * @brief Adds two bigint values and stores operator.
+ * @brief Adds two bigint values.
  * 
  * This function performs the addition of two `bigint` structures (`src1` and `src2`),
  * taking into account their signs. It handles cases where either or both of the 
  * `bigint` values are zero, as well as cases where the values have different signs. 
- * The result is stored in a newly allocated `bigint` structure pointed to by `dst`.
+ * `dst` may be `src1` or `src2` (for example `bi_add(&x, x, y)`); the sum is then computed
+ * in place, growing `dst` only when the carry needs another word.
  * 
  * @param[out] dst Pointer to a pointer of the resulting `bigint` after addition.
  * @param[in] src1 Pointer to the first `bigint` to be added.
@@ -102,69 +100,36 @@ msg bi_add(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
  * 
  * @return Returns 1 on success, -1 on failure.
  */
-msg bi_add_replace(INOUT bigint** dst, IN const bigint* src1)
+msg bi_add(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
 {
-    msg error_msg = FAILED;
-
-    bigint* temp_src1 = NULL;
-    bigint* temp_dst = NULL;           
-
-    word sum_dst = 0;
-    word sum_temp1 = 0;
-
-    error_msg = bi_assign(&temp_src1, src1);
-    if(error_msg == FAILED){
-        return FAILED;
-    }
-    error_msg = bi_assign(&temp_dst, *dst);
-    if(error_msg == FAILED){
-        return FAILED;
-    }
-
-    for(int index = 0; index < temp_src1->word_len; index++)
+    if((dst == NULL) || (src1 == NULL) || (src2 == NULL))
     {
-        sum_temp1 |= temp_src1->a[index];
-    }
-    for(int index = 0; index < temp_dst->word_len; index++)
-    {
-        sum_dst |= temp_dst->a[index];
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
     }
 
-    if(sum_temp1 == 0){
-        error_msg = SUCCESS;
-    }
-    else if(sum_dst == 0){
-        error_msg = bi_assign(dst, temp_src1);
-    }
-    else if((temp_src1->sign == POSITIVE) && (temp_dst->sign == NEGATIVE)){
-        temp_dst->sign = POSITIVE;
-        error_msg = bi_sub(dst, temp_src1, temp_dst);
-    }
-    else if((temp_src1->sign ==  NEGATIVE) && (temp_dst->sign ==  POSITIVE)){
-        temp_src1->sign = POSITIVE;
-        error_msg = bi_sub(dst, temp_dst, temp_src1);
-    }
-    else if ((bi_compare(temp_src1, temp_dst) == 1) || (bi_compare(temp_src1, temp_dst) == 0)){
-        error_msg = add_same_sign_replace(&temp_dst, temp_src1);
-        bi_assign(dst, temp_dst);
-    }
-    else{   
-        error_msg = add_same_sign_replace(&temp_src1, temp_dst);
-        bi_assign(dst, temp_src1);
-    }
+    return add_signed(dst, src1, src2, src2->sign);
+}
 
-    error_msg = bi_delete(&temp_src1);
-    if(error_msg == FAILED)
-    {
-        return FAILED;
-    }
-    error_msg = bi_delete(&temp_dst);
-    if(error_msg == FAILED)
+/**
+ * @brief Adds a bigint to `dst` in place.
+ * 
+ * Same as `bi_add(dst, *dst, src1)`.
+ * 
+ * @param[inout] dst Pointer to a pointer of the `bigint` to be added to and to hold the sum.
+ * @param[in] src1 Pointer to the `bigint` to be added.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_add_replace(INOUT bigint** dst, IN const bigint* src1)
+{
+    if(dst == NULL)
     {
+        fprintf(stderr, ERR_INVALID_INPUT);
         return FAILED;
     }
 
-    return SUCCESS;
+    return bi_add(dst, *dst, src1);
 }
 
 /***********************************************
@@ -174,8 +139,9 @@ msg bi_add_replace(INOUT bigint** dst, IN const bigint* src1)
  * @brief Subtracts one bigint from another.
  * 
  * This function performs the subtraction of two big integers (`src1` and `src2`),
- * considering their signs and magnitude. The result is stored in a newly allocated bigint
- * pointed to by `dst`. If `src1` is less than `src2`, the result will have a negative sign.
+ * considering their signs and magnitude. If `src1` is less than `src2`, the result will
+ * have a negative sign. `dst` may be `src1` or `src2` (for example `bi_sub(&r, r, n)`);
+ * the difference is then computed in place.
  * 
  * @param[out] dst Pointer to the result bigint that will hold the result of the subtraction.
  * @param[in] src1 The minuend (the bigint from which `src2` will be subtracted).
@@ -185,94 +151,37 @@ msg bi_add_replace(INOUT bigint** dst, IN const bigint* src1)
  */
 msg bi_sub(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
 {
-    msg error_msg = FAILED;
-
-    bigint* temp_src1 = NULL;
-    bigint* temp_src2 = NULL;
-    word temp1 = 0;
-    word temp2 = 0;
-
-    error_msg = bi_assign(&temp_src1, src1);
-    if(error_msg == FAILED)
-    {
-        return FAILED;
-    }
-    error_msg = bi_assign(&temp_src2, src2);
-    if(error_msg == FAILED)
+    if((dst == NULL) || (src1 == NULL) || (src2 == NULL))
     {
+        fprintf(stderr, ERR_INVALID_INPUT);
         return FAILED;
     }
 
-    for(int index = 0; index < temp_src1->word_len; index++)
-    {
-        temp1 |= temp_src1->a[index];
-    }
-    for(int index = 0; index < temp_src2->word_len; index++)
-    {
-        temp2 |= temp_src2->a[index];
-    }
-    if(temp1 == 0)
-    {
-        if(temp_src2->sign != ZERO)
-        {
-            temp_src2->sign = (temp_src2->sign == POSITIVE) ? NEGATIVE : POSITIVE;
-        }
-        error_msg = bi_assign(dst, temp_src2);
-    }
-    else if(temp2 == 0)
-    {
-        error_msg = bi_assign(dst, temp_src1);
-    }
-    else if(bi_compare(temp_src1, temp_src2) == 0)
-    {
-        error_msg = bi_new(dst, 1);
-    }
-    else if((bi_compare(temp_src1, temp_src2) == 1) && (temp_src2->sign == POSITIVE))
-    {
-        error_msg = bi_subc(dst, temp_src1, temp_src2);
-    }
-    else if((bi_compare(temp_src1, temp_src2) == -1) && (temp_src1->sign == POSITIVE))
-    {
-        error_msg = bi_subc(dst, temp_src2, temp_src1);
-        (*dst)->sign = NEGATIVE;
-    }
-    else if((bi_compare(temp_src1, temp_src2) == 1) && (temp_src1->sign == NEGATIVE))
-    {
-        temp_src1->sign = temp_src2->sign = POSITIVE;
-        error_msg = bi_subc(dst, temp_src2, temp_src1);
-    }
-    else if((bi_compare(temp_src1, temp_src2) == -1) && (temp_src2->sign == NEGATIVE))
-    {
-        temp_src1->sign = temp_src2->sign = POSITIVE;
-        error_msg = bi_subc(dst, temp_src1, temp_src2);
-        (*dst)->sign = NEGATIVE;
-    }
-    else if((temp_src1->sign == POSITIVE) && (temp_src2->sign == NEGATIVE))
-    {
-        temp_src2->sign = POSITIVE;
-        error_msg = bi_add(dst, temp_src1, temp_src2);
-    }
-    else
-    {
-        temp_src1->sign = POSITIVE;
-        error_msg = bi_add(dst, temp_src1, temp_src2);
-        (*dst)->sign = ((*dst)->sign == POSITIVE) ? NEGATIVE : POSITIVE;
-    }
+    return add_signed(dst, src1, src2, -(src2->sign));
+}
 
-    if(error_msg == FAILED)
-    {
-        return FAILED;
-    }
-    error_msg = bi_delete(&temp_src1);
-    if(error_msg == FAILED)
+/**
+ * @brief Negates a bigint.
+ * 
+ * `dst` may be `src`, in which case only the sign is flipped.
+ * 
+ * @param[out] dst Pointer to the result bigint, `-src`.
+ * @param[in] src The bigint to be negated.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_neg(OUT bigint** dst, IN const bigint* src)
+{
+    if((dst == NULL) || (src == NULL))
     {
+        fprintf(stderr, ERR_INVALID_INPUT);
         return FAILED;
     }
-    error_msg = bi_delete(&temp_src2);
-    if(error_msg == FAILED)
+    if(bi_assign(dst, src) == FAILED)
     {
         return FAILED;
     }
+    (*dst)->sign = -((*dst)->sign);
 
     return SUCCESS;
 }
@@ -286,6 +195,7 @@ msg bi_sub(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
  * This function performs the Multiplication of two big integers (`src1` and `src2`), 
  * This Multiplication performs multiplication by Improved Multiplication.
  * Consider sign of two integers, as the result of the muliplication with two negative integers is negative.
+ * `dst` may be `src1` or `src2`.
  * 
  * @param[out] dst Pointer to the result bigint that will hold the result of the multiplication.
  * @param[in] src1 The first big integer for the multiplication.
@@ -296,58 +206,91 @@ msg bi_sub(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
 msg bi_mul(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
 {
     msg error_msg = FAILED;
+    int sign = 0;
 
-    bigint* temp_src1 = NULL;
-    bigint* temp_src2 = NULL;
-
-    error_msg = bi_assign(&temp_src1, src1);
-    if(error_msg == FAILED)
-    {
-        return FAILED;
-    }
-    error_msg = bi_assign(&temp_src2, src2);
-    if(error_msg == FAILED)
+    if((dst == NULL) || (src1 == NULL) || (src2 == NULL))
     {
+        fprintf(stderr, ERR_INVALID_INPUT);
         return FAILED;
     }
 
-    if((temp_src1->sign == ZERO) || (temp_src2->sign == ZERO))
+    if((src1->sign == ZERO) || (src2->sign == ZERO))
     {
-        error_msg = bi_new(dst, 1);
-        if(((*dst)->word_len != 1) || ((*dst)->a[0] != 0)){
-            fprintf(stderr, ERR_MEMORY_ALLOCATION);
-        }
+        return bi_new(dst, 1);
     }
-    else if((temp_src1->word_len == 1) && (temp_src1->a[0] == 1))
+
+    sign = (src1->sign == src2->sign) ? POSITIVE : NEGATIVE;
+    if((src1->word_len == 1) && (src1->a[0] == 1))
     {
-        error_msg = bi_assign(dst, temp_src2);
-        (*dst)->sign = ((temp_src1->sign) == (temp_src2->sign)) ? POSITIVE : NEGATIVE;
+        error_msg = bi_assign(dst, src2);
     }
-    else if((temp_src2->word_len == 1) && (temp_src2->a[0] == 1))
+    else if((src2->word_len == 1) && (src2->a[0] == 1))
     {
-        error_msg = bi_assign(dst, temp_src1);
-        (*dst)->sign = ((temp_src1->sign) == (temp_src2->sign)) ? POSITIVE : NEGATIVE;
+        error_msg = bi_assign(dst, src1);
     }
     else
     {
-        error_msg = bi_mulc(dst, temp_src1, temp_src2);
-        (*dst)->sign = ((temp_src1->sign) == (temp_src2->sign)) ? POSITIVE : NEGATIVE;
+        error_msg = bi_mulc(dst, src1, src2);
     }
-
     if(error_msg == FAILED)
     {
         return FAILED;
     }
-    error_msg = bi_delete(&temp_src1);
-    if(error_msg == FAILED)
+    (*dst)->sign = sign;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Multiplies a bigint by a single word.
+ * 
+ * One pass of word multiply-adds. `dst` may be `src`; the product is then computed in place,
+ * growing `dst` by one word only when the top carry is non-zero.
+ * 
+ * @param[out] dst Pointer to the result bigint, `src * w`.
+ * @param[in] src The bigint to be multiplied.
+ * @param[in] w The word multiplier.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg bi_mul_word(OUT bigint** dst, IN const bigint* src, IN word w)
+{
+    int len = 0;
+    int sign = 0;
+    word carry = 0;
+    word* r = NULL;
+
+    if((dst == NULL) || (src == NULL))
     {
+        fprintf(stderr, ERR_INVALID_INPUT);
         return FAILED;
     }
-    error_msg = bi_delete(&temp_src2);
-    if(error_msg == FAILED)
+    if((src->sign == ZERO) || (w == 0))
+    {
+        return bi_new(dst, 1);
+    }
+
+    len = src->word_len;
+    sign = src->sign;
+    if(*dst == src)
+    {
+        if(bi_reserve(*dst, len + 1) == FAILED)
+        {
+            return FAILED;
+        }
+    }
+    else if(bi_new(dst, len + 1) == FAILED)
     {
         return FAILED;
     }
+    r = (*dst)->a;
+    for(int index = 0; index < len; index++)
+    {
+        r[index] = word_mul_add(&carry, src->a[index], w, carry, 0);
+    }
+    r[len] = carry;
+    (*dst)->word_len = len + (carry != 0);
+    (*dst)->sign = sign;
 
     return SUCCESS;
 }
@@ -367,7 +310,9 @@ msg bi_mul(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
  */
 msg bi_mul_kara(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
 {
-    bi_mul_k(dst,src1,src2);
+    if (bi_mul_k(dst,src1,src2) == FAILED) {
+        return FAILED;
+    }
     if (src1->sign == ZERO || src2->sign == ZERO){
         (*dst)->sign= ZERO;
     }
@@ -711,58 +656,67 @@ msg bi_naive_division(OUT bigint** quotient, OUT bigint** remainder, IN const bi
  * 
  * This function performs Squaring of big int (`src1`)
  * The sign of the result is always POSITIVE.
- * It's like to multiplication of two same bigint.
- * By multiply 2 after the multiplication same single word, and connect the result of single word squaring.
+ * Each cross product a[i] * a[j] (i < j) is computed once and the sum is doubled with a shift,
+ * then the squares a[i]^2 are added, so it needs about half the word multiplications of `bi_mul`.
+ * `dst` may be `src1`.
  * 
  * @param[out] dst Pointer to the result bigint that squared by src1.
- * @param[in] src1 The single word for the squaring.
+ * @param[in] src1 The bigint for the squaring.
  * 
  * @return Returns 1 on success, -1 on failure.
  */
 msg bi_squ(OUT bigint** dst, IN const bigint* src1)
 {
-    bigint* C1 = NULL;
-    bigint* C2 = NULL;
-    bigint* T1 = NULL;
-    bigint* T2 = NULL;
-    bigint* temp_src1 = NULL;
+    bigint* result = NULL;
+    bigint** out = (*dst == src1) ? &result : dst;
+    int n = 0;
+    word* r = NULL;
+    word carry = 0;
 
     if(src1->sign == ZERO)
     {
-        bi_new(dst, 1);
-
-        if(dst == NULL){
-            return FAILED;
-        }
-        return SUCCESS;
+        return bi_new(dst, 1);
     }
 
-    bi_assign(&temp_src1, src1);
-    bi_new(&C2, 1);
-    bi_new(&C1, 1);
+    n = src1->word_len;
+    if(bi_new(out, 2 * n) == FAILED)
+    {
+        return FAILED;
+    }
+    r = (*out)->a;
 
-    for(int idx1 = 0; idx1 < temp_src1->word_len; idx1++)
+    //cross products a[i] * a[j] (i < j) once, then doubled
+    for(int idx1 = 0; idx1 < n - 1; idx1++)
     {
-        bi_squc(&T1, temp_src1->a[idx1]);
-        bi_bit_lshift(T1, 2 * idx1 * SIZEOFWORD);
-        bi_add_replace(&C1, T1);
-        for(int idx2 = idx1 + 1; idx2 < temp_src1->word_len; idx2++)
+        carry = 0;
+        for(int idx2 = idx1 + 1; idx2 < n; idx2++)
         {
-            bi_smul(&T2, temp_src1->a[idx1], temp_src1->a[idx2]);
-
-            bi_bit_lshift(T2, (idx1 + idx2) * SIZEOFWORD);
-            bi_add_replace(&C2, T2);
-            bi_delete(&T2);
+            r[idx1 + idx2] = word_mul_add(&carry, src1->a[idx1], src1->a[idx2], r[idx1 + idx2], carry);
         }
-        bi_delete(&T1);
+        r[idx1 + n] = carry;
     }
+    array_lshift(r, r, 2 * n, 1);
 
-    bi_bit_lshift(C2, 1);
-    bi_add(dst, C1, C2);
-    
-    bi_delete(&temp_src1);
-    bi_delete(&C1);
-    bi_delete(&C2);
+    //add the squares a[i]^2
+    carry = 0;
+    for(int idx1 = 0; idx1 < n; idx1++)
+    {
+        word hi = 0;
+
+        r[2 * idx1] = word_mul_add(&hi, src1->a[idx1], src1->a[idx1], r[2 * idx1], carry);
+        r[2 * idx1 + 1] += hi;
+        carry = (r[2 * idx1 + 1] < hi);
+    }
+    (*out)->sign = POSITIVE;
+    bi_refine(*out);
+
+    if(out == &result)
+    {
+        msg error_msg = bi_assign(dst, result);
+
+        bi_delete(&result);
+        return error_msg;
+    }
     return SUCCESS;
 }
 
@@ -779,14 +733,12 @@ msg bi_squ(OUT bigint** dst, IN const bigint* src1)
 msg bi_squ_kara(OUT bigint** dst, IN const bigint* src)
 {
     if (src->sign == ZERO){
-        bi_new(dst,1);
-        return SUCCESS;
+        return bi_new(dst,1);
     }
     int n = src->word_len;
 
     if (KARA_FLAG_SQU >= n) {
-        bi_squ(dst,src);
-        return SUCCESS;
+        return bi_squ(dst,src);
     }
 
     bigint* a1 = NULL;
@@ -803,8 +755,7 @@ msg bi_squ_kara(OUT bigint** dst, IN const bigint* src)
     int l = (n + 1) >> 1;
     int lw = l*SIZEOFWORD;
     // a >> lw
-    bi_assign(&a1, temp_src);
-    bi_bit_rshift(a1,lw);
+    bi_bit_rshift_to(&a1, temp_src, lw);
     //a mod 
     bi_assign(&a0, temp_src);
     bi_delete(&temp_src);
@@ -828,12 +779,14 @@ msg bi_squ_kara(OUT bigint** dst, IN const bigint* src)
     bi_delete(&a0);
 
     bi_bit_lshift(s, (lw+1));
-    bi_add(dst,r,s);
-    (*dst)->sign = POSITIVE;
+    msg error_msg = bi_add(dst,r,s);    //fails if dst is fixed and too small
+    if (error_msg == SUCCESS) {
+        (*dst)->sign = POSITIVE;
+    }
     bi_delete(&s);
     bi_delete(&r);
 
-    return SUCCESS;
+    return error_msg;
 }
 
 /***********************************************
@@ -844,6 +797,7 @@ msg bi_squ_kara(OUT bigint** dst, IN const bigint* src)
  * 
  * This function computes the modular exponentiation (`base^exp % mod`) 
  * using the left-to-right binary method. The result is stored in `dst`. 
+ * Leading zero bits of the exponent are skipped; the exponent length is not hidden.
  * 
  * @param[out] dst Pointer to the output big integer result.
  * @param[in] base The base big integer.
@@ -868,18 +822,22 @@ msg bi_mod_exp_l2r(OUT bigint** dst, IN const bigint* base, IN const bigint* exp
     (*dst)->sign = POSITIVE;
     (*dst)->a[0] = 1;
 
-    for(int word_index = exp->word_len - 1; word_index >= 0; word_index--)
+    //leading zero bits would only square 1, skip them
+    int bits = exp->word_len * SIZEOFWORD;
+
+    while((bits > 0) && (((exp->a[(bits - 1) / SIZEOFWORD] >> ((bits - 1) % SIZEOFWORD)) & 0x01) == 0))
     {
-        for(int bit_index = sizeof(word) * 8 - 1; bit_index >= 0; bit_index--)
+        bits--;
+    }
+
+    for(int bit_index = bits - 1; bit_index >= 0; bit_index--)
+    {
+        bi_squ_kara(&temp, *dst);
+        bi_word_division(&quotient_buf, dst, temp, mod);
+        if((exp->a[bit_index / SIZEOFWORD] >> (bit_index % SIZEOFWORD)) & 0x01)
         {
-            bi_squ_kara(&temp, *dst);
-            bi_assign(dst, temp);
-            bi_word_division(&quotient_buf, dst, *dst, mod);
-            if((exp->a[word_index] >> bit_index) & 0x01)
-            {
-                bi_mul_k(dst, *dst, base);
-                bi_word_division(&quotient_buf, dst, *dst, mod);
-            }
+            bi_mul_k(&temp, *dst, base);
+            bi_word_division(&quotient_buf, dst, temp, mod);
         }
     }
 
@@ -964,8 +922,24 @@ msg bi_mod_exp_MaS(OUT bigint** dst, IN const bigint* base, IN const bigint* exp
         return FAILED;
     }
 
+    //products of two values up to 4096 bits: 2n words and the carry word of each factor
+    typedef struct { bigint bi; word a[2 * BI_FIXED_WORDS(4096)]; } bigint_MaS;
+    bigint_MaS t_fixed[2];
+    bigint_MaS quotient_fixed;
     bigint* quotient_buf = NULL;
     bigint* t[2] = {NULL,NULL};
+    int max_len = (base->word_len > mod->word_len) ? base->word_len : mod->word_len;
+
+    if(2 * max_len + 2 <= (int)(sizeof(t_fixed[0].a) / sizeof(word)))
+    {
+        //keep the secret-dependent temporaries of moduli up to 4096 bits off the heap
+        BI_FIXED_INIT(t_fixed[0]);
+        BI_FIXED_INIT(t_fixed[1]);
+        BI_FIXED_INIT(quotient_fixed);
+        t[0] = &t_fixed[0].bi;
+        t[1] = &t_fixed[1].bi;
+        quotient_buf = &quotient_fixed.bi;
+    }
 
     bi_new(&t[0], 1);
     t[0]->sign = POSITIVE;
@@ -1023,9 +997,7 @@ msg bi_bar_redu(OUT bigint** dst, IN const bigint* A, IN const bigint* T, IN con
     bigint* temp = NULL;
     int n = N->word_len;
 
-    bi_assign(&quotient_buf,A);
-
-    bi_bit_rshift(quotient_buf,(n-1)*SIZEOFWORD);
+    bi_bit_rshift_to(&quotient_buf, A, (n-1)*SIZEOFWORD);
     bi_mul_k(&quotient_buf,quotient_buf,T);
 
     bi_bit_rshift(quotient_buf,(n+1)*SIZEOFWORD);
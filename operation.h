@@ -10,8 +10,12 @@ msg bi_add_replace(INOUT bigint** dst, IN const bigint* src1);
 
 msg bi_sub(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2);
 
+msg bi_neg(OUT bigint** dst, IN const bigint* src);
+
 msg bi_mul(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2);
 
+msg bi_mul_word(OUT bigint** dst, IN const bigint* src, IN word w);
+
 msg bi_binary_division(OUT bigint** quotient, OUT bigint** remainder, IN const bigint* src1, IN const bigint* src2);
 
 msg bi_mul_kara(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2);
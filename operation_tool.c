@@ -6,50 +6,53 @@
 #include "errormsg.h"
 #include "operation_tool.h"
 #include "operation.h"
+#include "arrayfun.h"
+#include "wordfun.h"
+
 //(min) return smaller a and b
 //(max) return bigger  a and b
 #define min(a,b)  ((a) <= (b) ? (a) : (b))
 #define max(a,b)  ((a) >= (b) ? (a) : (b))
 
-/***********************************************
- * Addition
- ***********************************************/
 /**
- * @brief Adds two words with a carry value.
+ * @brief Prepares `dst` for a `word_len`-word result of an operation on `dst` itself.
  * 
- * This function computes the sum of two `word` values (`src1` and `src2`) along 
- * with a carry value. It returns the result of the addition and updates the carry 
- * pointer to reflect any overflow.
+ * A destination that is also an operand keeps its words, grown to `word_len` if needed; the
+ * add/sub kernels read and write every word at the same index, so they then run in place.
+ * Any other destination is simply cleared.
  * 
- * @param[in] src1 The first `word` to be added.
- * @param[in] src2 The second `word` to be added.
- * @param[in,out] c Pointer to an integer representing the carry. This value 
- *                  is updated to reflect any overflow after the addition.
+ * @param[inout] dst Pointer to the destination bigint.
+ * @param[in] in_place 1 if `*dst` is one of the operands.
+ * @param[in] word_len The number of words of the result.
  * 
- * @return The result of the addition of `src1`, `src2`, and the carry.
+ * @return Returns 1 on success, -1 on failure.
  */
-word add_c(IN word src1, IN word src2, IN int* c)
+static msg dst_prepare(INOUT bigint** dst, IN int in_place, IN int word_len)
 {
-    word result = src1 + src2;
-    int cout = 0;
-    if (result < src1){
-        cout = 1;
+    if(!in_place)
+    {
+        return bi_new(dst, word_len);
     }
-    result += *c;
-    if(result < (word)*c){
-        cout += 1;
+    if(bi_reserve(*dst, word_len) == FAILED)
+    {
+        return FAILED;
     }
-    *c = cout;
-    return result;
+    (*dst)->word_len = word_len;
+
+    return SUCCESS;
 }
 
+/***********************************************
+ * Addition
+ ***********************************************/
 /**
  * @brief Adds two bigint values with the same sign.
  * 
  * This function adds two `bigint` structures (`src1` and `src2`) that are both
- * either positive or negative. The result is stored in a newly allocated `bigint`
- * structure pointed to by `dst`. The function ensures that the resulting bigint
- * has the appropriate length and sign.
+ * either positive or negative. The magnitudes are added with one carry chain over the
+ * common words (`array_add_n`) and the carry is then run into the rest of the longer
+ * operand (`array_add_1`). The inputs are not modified; `dst` may be `src1` or `src2`, in which
+ * case the sum is computed in place.
  * 
  * @param[out] dst Pointer to a pointer of the resulting `bigint` after addition.
  * @param[in] src1 Pointer to the first `bigint` to be added.
@@ -57,193 +60,55 @@ word add_c(IN word src1, IN word src2, IN int* c)
  * 
  * @return Returns 1 on success, -1 on failure.
  */
-msg add_same_sign(OUT bigint** dst, IN bigint* src1, IN bigint* src2)
+msg add_same_sign(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
 {
-    msg error_msg = 0;
-    word result;
-    int max_len;
-    int c = 0;
-    
-    if((*dst) != NULL)
-    {
-        error_msg = bi_delete(dst);
-        if(error_msg == FAILED )
-        {
-            return FAILED;
-        }
-    }
-
-    if(src1->sign == POSITIVE){     //dst->word_len = longer bigint(not bigger)-> word_len  
-        max_len = src1->word_len;
-        error_msg = bi_new(dst, max_len + 1);
-        if(error_msg == FAILED)
-        {
-            return FAILED;
-        }
-        (*dst)->sign = POSITIVE;
-    }
-    else{
-        max_len = src2->word_len;
-        error_msg = bi_new(dst, max_len + 1);
-        if(error_msg == FAILED)
-        {
-            return FAILED;
-        }
-        (*dst)->sign = NEGATIVE;          
-    }
-
-    if((src1->word_len) > (src2->word_len)){
-        error_msg = bi_fillzero(src2, src1->word_len, TOP);
-        if(error_msg == FAILED)
-        {
-            return FAILED;
-        }
-    }
-    else{
-        error_msg = bi_fillzero(src1, src2->word_len, TOP);
-        if(error_msg == FAILED)
-        {
-            return FAILED;
-        }
-    }
-
-    for(int idx = 0; idx < max_len; idx++){    
-        result = add_c(src1->a[idx], src2->a[idx], &c);
-        (*dst)->a[idx] = result;
-    }
-    if(c == 1){
-        (*dst)->a[max_len] = 1;     //If carry = 1, word_len += 1
-    }
-    else{
-        error_msg = bi_refine(*dst);
-    }
-    if(error_msg == FAILED)
+    const bigint* long_src = (src1->word_len >= src2->word_len) ? src1 : src2;
+    const bigint* short_src = (long_src == src1) ? src2 : src1;
+    int long_len = long_src->word_len;
+    int short_len = short_src->word_len;
+    int sign = src1->sign;
+    word* r = NULL;
+    word carry = 0;
+
+    if(dst_prepare(dst, (*dst == src1) || (*dst == src2), long_len + 1) == FAILED)
     {
         return FAILED;
     }
+    r = (*dst)->a;
+    carry = array_add_n(r, long_src->a, short_src->a, short_len);
+    carry = array_add_1(r + short_len, long_src->a + short_len, long_len - short_len, carry);
+    r[long_len] = carry;
+    (*dst)->sign = sign;
 
-    return SUCCESS;
+    return bi_refine(*dst);
 }
 
 /**
  * @brief Adds two bigint values with the same sign and stores value to operator.
  * 
- * This function adds two `bigint` structures (`src1` and `src2`) that are both
- * either positive or negative. The result is stored in a newly allocated `bigint`
- * structure pointed to by `dst`. The function ensures that the resulting bigint
- * has the appropriate length and sign.
+ * This function adds `src1` to `dst`, both either positive or negative, and stores the
+ * sum in `dst` (see `add_same_sign`).
  * 
- * @param[out] dst Pointer Pointer to the first `bigint` to be added and stored result
+ * @param[inout] dst Pointer Pointer to the first `bigint` to be added and stored result
  * @param[in] src1 Pointer to the second `bigint` to be added.
  * 
  * @return Returns 1 on success, -1 on failure.
  */
-msg add_same_sign_replace(INOUT bigint** dst, IN bigint* src1)
+msg add_same_sign_replace(INOUT bigint** dst, IN const bigint* src1)
 {
-    msg error_msg = 0;
-    word result;
-    int max_len;
-    int c = 0;
-    
-    bigint *temp_dst = NULL;
-    
-    bi_assign(&temp_dst, *dst);     //dst copy
-
-    if(src1->sign == POSITIVE){   
-        max_len = src1->word_len;
-        error_msg = bi_new(dst, max_len + 1);
-        if(error_msg == FAILED)
-        {
-            return FAILED;
-        }
-        (*dst)->sign = POSITIVE;
-    }
-    else{
-        max_len = temp_dst->word_len;
-        error_msg = bi_new(dst, max_len + 1);
-        if(error_msg == FAILED)
-        {
-            return FAILED;
-        }
-        (*dst)->sign = NEGATIVE;
-    }
-
-    if((src1->word_len) > (temp_dst->word_len)){
-        error_msg = bi_fillzero(temp_dst, src1->word_len, TOP);
-        if(error_msg == FAILED)
-        {
-            return FAILED;
-        }
-    }
-    else{
-        error_msg = bi_fillzero(src1, temp_dst->word_len, TOP);
-        if(error_msg == FAILED)
-        {
-            return FAILED;
-        }
-    }
-
-    for(int idx = 0; idx < max_len; idx++){    
-        result = add_c(src1->a[idx], temp_dst->a[idx], &c);
-        (*dst)->a[idx] = result;
-    }
-    if(c == 1){
-        (*dst)->a[max_len] = 1;
-    }
-    else{
-        error_msg = bi_refine(*dst);
-    }
-    if(error_msg == FAILED)
-    {
-        return FAILED;
-    }
-    bi_delete(&temp_dst);
-    return SUCCESS;
+    return add_same_sign(dst, *dst, src1);
 }
 
 /***********************************************
  * Subtraction
  ***********************************************/
-/**
- * @brief Subtracts two words with borrow handling.
- * 
- * This function performs the subtraction of two words, `A` and `B`, taking into 
- * account a borrow value. It updates the borrow status and returns the result of 
- * the subtraction.
- * 
- * @param[in] A The first word from which the borrow-adjusted `B` will be subtracted.
- * @param[in,out] borrow A pointer to the current borrow value, which will be updated.
- * @param[in] B The second word to be subtracted from `A` after adjusting for borrow.
- * 
- * @return The result of the subtraction of `B` from `A`, adjusted for borrow.
- */
-word sub_adb(IN word A, IN char* borrow, IN word B)
-{
-    char borrow_buf = 0;
-    word C = A - (*borrow);
-
-    if(A < (word)*borrow)
-    {
-        borrow_buf = 1;
-    }
-
-    if(C < B)
-    {
-        borrow_buf += 1;
-    }
-
-    C = C - B;
-
-    *borrow = borrow_buf;
-    return C;
-}
-
 /**
  * @brief Subtracts one bigint from another with borrow handling.
  * 
- * This function performs the subtraction of two big integers (`src1` and `src2`), 
- * taking into account any borrows that occur during the subtraction process. 
- * The result is stored in a newly allocated bigint pointed to by `dst`.
+ * This function subtracts the magnitude of `src2` from the magnitude of `src1`, which must
+ * not be smaller. The borrow runs through the common words in one chain (`array_sub_n`)
+ * and then into the rest of `src1` (`array_sub_1`). The result is POSITIVE (or ZERO);
+ * `dst` may be `src1` or `src2`, in which case the difference is computed in place.
  * 
  * @param[out] dst Pointer to the result bigint that will hold the result of the subtraction.
  * @param[in] src1 The minuend (the bigint from which `src2` will be subtracted).
@@ -251,38 +116,22 @@ word sub_adb(IN word A, IN char* borrow, IN word B)
  * 
  * @return Returns 1 on success, -1 on failure.
  */
-msg bi_subc(OUT bigint** dst, IN bigint* src1, IN bigint* src2)
+msg bi_subc(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
 {
-    msg error_msg = 0;
-    error_msg = bi_fillzero(src2, src1->word_len, TOP);
-    if(error_msg == FAILED)
-    {
-        return FAILED;
-    }
-    
-    if((*dst) != NULL)
-    {
-        error_msg = bi_delete(dst);
-        if(error_msg == FAILED )
-        {
-            return FAILED;
-        }
-    }
+    int len1 = src1->word_len;
+    int len2 = (src2->word_len < len1) ? src2->word_len : len1;
+    word* r = NULL;
+    word borrow = 0;
 
-    error_msg = bi_new(dst, src1->word_len);
-    if(error_msg == FAILED)
+    if(dst_prepare(dst, (*dst == src1) || (*dst == src2), len1) == FAILED)
     {
         return FAILED;
     }
+    r = (*dst)->a;
+    borrow = array_sub_n(r, src1->a, src2->a, len2);
+    array_sub_1(r + len2, src1->a + len2, len1 - len2, borrow);
     (*dst)->sign = POSITIVE;
-    
-    char borrow = 0;
 
-    for (int index = 0; index<(src2->word_len); index++)
-    {
-        (*dst)->a[index] = sub_adb(src1->a[index], &borrow, src2->a[index]);
-    }
-    
     return bi_refine(*dst);
 }
 
@@ -293,8 +142,8 @@ msg bi_subc(OUT bigint** dst, IN bigint* src1, IN bigint* src2)
  * @brief Multiplication two single words
  * 
  * This function performs multiplication between two words (`src1` and `src2`) and 
- * stores the result in a bigint structure pointed to by `dst`. It handles the multiplication
- * by dividing each word into half-word, then products and adds each others.
+ * stores the result in a bigint structure pointed to by `dst`. The double-word product
+ * comes from `word_mul`.
  * 
  * @param[out] dst Pointer to the result bigint that will store the result of the multiplication.
  *                 The function allocates memory for this bigint and initializes its elements.
@@ -314,60 +163,17 @@ msg bi_smul(OUT bigint** dst, IN word src1, IN word src2)
         return FAILED;
     }
     (*dst)->sign = POSITIVE;
+    (*dst)->a[0] = word_mul(&(*dst)->a[1], src1, src2);
 
-    #if SIZEOFWORD == 8
-        word A1 = 0, A0 = 0, B1 = 0, B0 = 0;
-        word temp, temp1 = 0, temp0 = 0;
-        A1 = src1 >> (SIZEOFWORD / 2);
-        A0 = src1 & (((word)1 << (SIZEOFWORD / 2)) - 1);
-        
-        B1 = src2 >> (SIZEOFWORD / 2);
-        B0 = src2 & (((word)1 << (SIZEOFWORD / 2)) - 1);
-
-        temp1 = (word)A1 * (word)B0;
-        temp0 = (word)A0 * (word)B1;
-        temp0 += temp1;
-        temp1 = (temp0 < temp1);
-
-        (*dst)->a[1] = (word)A1 * (word)B1;
-        temp = (*dst)->a[0] = (word)A0 * (word)B0;
-        
-        (*dst)->a[0] += temp0 << (SIZEOFWORD / 2);
-        (*dst)->a[1] += (temp1 << (SIZEOFWORD / 2)) + (temp0 >> (SIZEOFWORD / 2)) + ((*dst)->a[0] < temp);
-        
-        return SUCCESS;
-
-    #else
-        half_word A1 = 0, A0 = 0, B1 = 0, B0 = 0;
-        word temp, temp1 = 0, temp0 = 0;
-
-        A1 = src1 >> (sizeof(half_word) * 8);
-        A0 = src1 & (((word)1 << (sizeof(half_word) * 8)) - 1);
-
-        B1 = src2 >> (sizeof(half_word) * 8);
-        B0 = src2 & (((word)1 << (sizeof(half_word) * 8)) - 1);
-
-        temp1 = (word)A1 * (word)B0;
-        temp0 = (word)A0 * (word)B1;
-        temp0 += temp1;
-        temp1 = (temp0 < temp1);
-
-        (*dst)->a[1] = (word)A1 * (word)B1;
-        temp = (*dst)->a[0] = (word)A0 * (word)B0;
-        
-        (*dst)->a[0] += temp0 << (sizeof(half_word) * 8);
-        (*dst)->a[1] += (temp1 << (sizeof(half_word) * 8)) + (temp0 >> (sizeof(half_word) * 8)) + ((*dst)->a[0] < temp);
-        
-        return SUCCESS;
-    #endif
+    return SUCCESS;
 }
 
 /**
  * @brief Multiplication two multi-word size integers with the non-negative integer
  * 
- * This function performs the Multiplication of two big non-negative integers (`src1` and `src2`), 
- * This Improved Multiplication performs single words mul by smul and connects result of smul.
- * The result is addtion of the results connected sigle words mul with shifting and zero padding.
+ * This function performs the Multiplication of two big non-negative integers (`src1` and `src2`) 
+ * by schoolbook multiplication: each row `src1->a[i] * src2` is accumulated into the result 
+ * words, carrying one word along the row (`array_mul_basecase`, with the kernel for the CPU).
  * 
  * @param[out] dst Pointer to the result bigint that will hold the result of the non-negative multiplication.
  * @param[in] src1 The first operand for the multiplication.
@@ -375,98 +181,26 @@ msg bi_smul(OUT bigint** dst, IN word src1, IN word src2)
  * 
  * @return Returns 1 on success, -1 on failure.
  */
-msg bi_mulc(OUT bigint** dst, IN bigint* src1, IN bigint* src2)
+msg bi_mulc(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
 {   
-    int error_msg = 0;
-    bigint* temp0 = NULL;
-    bigint* temp1 = NULL;
-    bigint* temp = NULL;
-    bigint* tempC = NULL;
-    bigint* tempC_result = NULL;
-    bigint* tempT0 = NULL;
-    bigint* tempT1 = NULL;
-    bigint* tempT0_result = NULL;
-    bigint* tempT1_result = NULL;
+    bigint* result = NULL;
+    bigint** out = ((*dst == src1) || (*dst == src2)) ? &result : dst;
+    int n = src1->word_len;
+    int m = src2->word_len;
 
-    if(error_msg == FAILED)
+    if(bi_new(out, n + m) == FAILED)
     {
         return FAILED;
     }
+    array_mul_basecase((*out)->a, src1->a, n, src2->a, m);
+    (*out)->sign = POSITIVE;
+    bi_refine(*out);
 
-    if((*dst) != NULL)
-    {
-        error_msg = bi_delete(dst);
-        if(error_msg == FAILED)
-        {
-            return FAILED;
-        }
-    }
-
-    error_msg = bi_new(&tempC, 1);
-    tempC->sign = POSITIVE;
-
-    if((src1->word_len) % 2 == 1)
-    {
-        error_msg = bi_fillzero(src1, src1->word_len + 1, TOP);
-        if(error_msg == FAILED)
-        {
-            return FAILED;
-        }   
-    }
-    if((src2->word_len) % 2 == 1)
+    if(out == &result)
     {
-        error_msg = bi_fillzero(src2, src2->word_len + 1, TOP);
-        if(error_msg == FAILED)
-        {
-            return FAILED;
-        }
+        bi_assign(dst, result);
+        bi_delete(&result);
     }
-    for(int idx2 = 0; idx2 < src2->word_len; idx2++){
-        bi_new(&tempT1, 1);
-        tempT0 = NULL;
-        for(int idx1 = 0; idx1 < (src1->word_len)/ 2; idx1++){
-            bi_smul(&temp0, src1->a[2*idx1], src2->a[idx2]);
-            bi_smul(&temp1, src1->a[2*idx1 + 1], src2->a[idx2]);
-            bi_connect(&tempT0_result, temp0, tempT0);
-            bi_connect(&tempT1_result, temp1, tempT1);
-            bi_assign(&tempT0, tempT0_result);
-            bi_assign(&tempT1, tempT1_result);
-
-            bi_delete(&tempT0_result);
-            bi_delete(&tempT1_result);
-            bi_delete(&temp0);
-            bi_delete(&temp1);
-        }
-        if (bi_compare(tempT1, tempT0) == 1){
-            add_same_sign(&temp, tempT1, tempT0);
-
-            bi_delete(&tempT1);
-            bi_delete(&tempT0);
-        }
-        else{
-            add_same_sign(&temp, tempT0, tempT1);
-
-            bi_delete(&tempT1);
-            bi_delete(&tempT0);
-        }
-        bi_fillzero(temp, temp->word_len + idx2, BOTTOM);
-        if (bi_compare(temp, tempC) == 1){
-            add_same_sign(&tempC_result, temp, tempC);
-        }
-        else
-        {
-            add_same_sign(&tempC_result, tempC, temp);
-        }
-        bi_assign(&tempC, tempC_result);
-    }
-
-
-    bi_assign(dst, tempC);
-    bi_delete(&tempC);
-    bi_delete(&temp);
-    bi_delete(&tempC_result);
-    bi_delete(&tempT0);
-    bi_delete(&tempT1);
     return SUCCESS;
 }
 
@@ -485,22 +219,17 @@ msg bi_mulc(OUT bigint** dst, IN bigint* src1, IN bigint* src2)
  */
 msg bi_mul_k(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
 {
-    bigint* temp_src1 = NULL;
-    bigint* temp_src2 = NULL;
-    
-    bi_assign(&temp_src1, src1);
-    bi_assign(&temp_src2, src2);
-    temp_src1->sign = POSITIVE;
-    temp_src2->sign = POSITIVE;
-
     int n = src1->word_len;
     int m = src2->word_len;
 
     //flag
     if (KARA_FLAG_MUL >= min(n,m)) {
-        bi_mul(dst,temp_src1,temp_src2);
-        bi_delete(&temp_src1);
-        bi_delete(&temp_src2);
+        if (bi_mul(dst,src1,src2) == FAILED) {
+            return FAILED;
+        }
+        if ((*dst)->sign != ZERO) {
+            (*dst)->sign = POSITIVE;
+        }
         return SUCCESS;
     }
 
@@ -520,10 +249,9 @@ msg bi_mul_k(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
     int l = (max(n,m) + 1) >> 1;
     int lw = l*SIZEOFWORD;
     // a >> lw
-    bi_assign(&a1, temp_src1);
-    bi_bit_rshift(a1,lw);
+    bi_bit_rshift_to(&a1, src1, lw);
     //a mod 
-    bi_assign(&a0, temp_src1);
+    bi_assign(&a0, src1);
     if (a0->word_len > l){
         for (int i = l; i < a0->word_len; i++)
         {
@@ -531,31 +259,31 @@ msg bi_mul_k(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
         }
     }
     
-    bi_delete(&temp_src1);
-    
     // b >> lw
-    bi_assign(&b1, temp_src2);
-    bi_bit_rshift(b1,lw);
+    bi_bit_rshift_to(&b1, src2, lw);
     //b mod 
-    bi_assign(&b0, temp_src2);
+    bi_assign(&b0, src2);
     if (b0->word_len > l){
         for (int i = l; i < b0->word_len; i++)
         {
             b0->a[i] = 0;
         }
     }
-    bi_delete(&temp_src2);
     bi_refine(a0);
     bi_refine(b0);
     bi_refine(a1);
     bi_refine(b1);
+    //the halves are magnitudes (the operands are not copied to drop their signs)
+    a0->sign = (a0->sign == ZERO) ? ZERO : POSITIVE;
+    b0->sign = (b0->sign == ZERO) ? ZERO : POSITIVE;
+    a1->sign = (a1->sign == ZERO) ? ZERO : POSITIVE;
+    b1->sign = (b1->sign == ZERO) ? ZERO : POSITIVE;
     // t1, t0
     bi_mul_k(&t1, a1, b1);
     bi_mul_k(&t0, a0, b0);
     
     // r = (t1 << 2*lw) + t0
-    bi_assign(&temp, t1);
-    bi_bit_lshift(temp,2*lw);
+    bi_bit_lshift_to(&temp, t1, 2*lw);
     bi_add(&r, temp, t0);
     
     // s1 = a0 - a1
@@ -592,11 +320,11 @@ msg bi_mul_k(OUT bigint** dst, IN const bigint* src1, IN const bigint* src2)
     bi_delete(&t0);
     //s = s << lw
     bi_bit_lshift(sum_s,lw);
-    bi_add(dst,r,sum_s);
+    msg error_msg = bi_add(dst,r,sum_s);    //fails if dst is fixed and too small
     bi_delete(&sum_s);
     bi_delete(&r);
 
-    return SUCCESS;
+    return error_msg;
 }
 
 /***********************************************
@@ -700,49 +428,14 @@ msg bi_binary_long_division(OUT bigint** quotient, OUT bigint** remainder, IN co
  */
 msg bi_squc(OUT bigint** dst, IN const word src1)
 {   
-    int error_msg = 0;
-    word A1 = 0, A0 = 0;
-    bigint* T = NULL;
-    bigint* C = NULL;
-
-    if((*dst) != NULL)
-    {
-        error_msg = bi_delete(dst);
-    }
-    
-    error_msg = bi_new(dst, 2);
-    error_msg = bi_new(&C, 2);
-
-    C->sign = POSITIVE;
-
-    error_msg = bi_new(&T, 1);
-
-    T->sign = POSITIVE;
-
-    #if SIZEOFWORD == 8
-        A1 = src1 >> (SIZEOFWORD/2);
-        A0 = src1 & (((word)1 << (SIZEOFWORD/2)) - 1);
-    #else
-        A1 = src1 >> (sizeof(half_word) * 8);
-        A0 = src1 & (((word)1 << (sizeof(half_word) * 8)) - 1);
-    #endif
-
-    C->a[1] = (A1*A1);
-    C->a[0] = (A0*A0);
-    T->a[0] = A0*A1;
-    error_msg = bi_bit_lshift(T, SIZEOFWORD/2 + 1);
-
-    error_msg = add_same_sign(dst, C, T);
-
-    bi_delete(&C);
-    bi_delete(&T);
-
-    if(error_msg == FAILED )
+    if(bi_new(dst, 2) == FAILED)
     {
         return FAILED;
     }
+    (*dst)->sign = POSITIVE;
+    (*dst)->a[0] = word_mul(&(*dst)->a[1], src1, src1);
 
-    return SUCCESS;
+    return bi_refine(*dst);
 }
 
 
@@ -10,8 +10,16 @@
 #define ENDIAN          0    // Little endian: 0, Big endian: 1
 #define SIZEOFWORD      64   //bitsize of word
 
-#define KARA_FLAG_SQU   10   //karatsuba word_len flag
-#define KARA_FLAG_MUL   10
+#define BYTES_LITTLE    0    //byte string order: least significant byte first
+#define BYTES_BIG       1    //byte string order: most significant byte first (I2OSP/OS2IP)
+
+#define KARA_FLAG_SQU   256  //karatsuba word_len flag
+#define KARA_FLAG_MUL   64
+
+#define MONT_WINDOW     5    //maximum window bits of Montgomery exponentiation
+#define MONT_AVX2_WIDE  3072 //modulus bits from which a single exponentiation runs on the AVX2 engine
+
+#define DEC_DC_FLAG     512     //divide and conquer decimal conversion word_len flag
 
 #define TOP             1    //zero padding to msb
 #define BOTTOM         -1    //zero padding to lsb
@@ -19,7 +27,15 @@
 #define PROBABLY_PRIME  2
 #define COMPOSITE      -2
 
+#define SIGN_VALID      3    //rsa_verify: signature matches
+#define SIGN_INVALID   -3
+
+#define BLINDING_REFRESH 32  //blinded operations per random r, the pair is squared in between
+
+#define RSA_PRIME_MAX   4    //primes of a multi-prime RSA key (RFC 8017)
+
 #define MILLER_NUM      10
+#define SMALL_PRIME_NUM 13   //number of fixed witnesses for numbers up to 128 bits
 
 #define SECURE_SCA      1    //SCA_SECURE: 1, SCA_UNSECURE: 0
 
@@ -0,0 +1,460 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pkcs1.h"
+#include "sha256.h"
+#include "rsa.h"
+#include "drbg.h"
+#include "bigintfun.h"
+#include "params.h"
+#include "dtype.h"
+#include "errormsg.h"
+
+
+/***********************************************
+ * Helpers
+ ***********************************************/
+/**
+ * @brief Returns all ones if `x` is 0 and 0 otherwise, without a branch (x < 2^31).
+ */
+static unsigned int ct_is_zero(IN unsigned int x)
+{
+    return 0u - ((x - 1u) >> 31);
+}
+
+/**
+ * @brief Returns the bit length of a positive bigint.
+ */
+static int pkcs1_bit_len(IN const bigint* n)
+{
+    word top = n->a[n->word_len - 1];
+    int bits = (n->word_len - 1) * SIZEOFWORD;
+
+    while(top != 0)
+    {
+        top >>= 1;
+        bits++;
+    }
+    return bits;
+}
+
+/**
+ * @brief Xors MGF1-SHA256(seed, dst_len) into `dst`; the mask is never stored on its own.
+ */
+static void mgf1_xor(INOUT byte* dst, IN int dst_len, IN const byte* seed, IN int seed_len)
+{
+    byte digest[PKCS1_HASH_LEN];
+    byte counter[4];
+    sha256_ctx ctx;
+
+    for(uint32_t block = 0; dst_len > 0; block++)
+    {
+        int len = (dst_len < PKCS1_HASH_LEN) ? dst_len : PKCS1_HASH_LEN;
+
+        counter[0] = (byte)(block >> 24);
+        counter[1] = (byte)(block >> 16);
+        counter[2] = (byte)(block >> 8);
+        counter[3] = (byte)block;
+        sha256_init(&ctx);
+        sha256_update(&ctx, seed, (size_t)seed_len);
+        sha256_update(&ctx, counter, sizeof(counter));
+        sha256_final(digest, &ctx);
+        for(int i = 0; i < len; i++)
+        {
+            dst[i] ^= digest[i];
+        }
+        dst += len;
+        dst_len -= len;
+    }
+#if ZERORIZE == 1
+    memset(digest, 0, sizeof(digest));
+#endif
+}
+
+/**
+ * @brief Generates a mask with MGF1 (RFC 8017 B.2.1) over SHA-256.
+ *
+ * @param[out] mask Pointer to the `mask_len` output bytes.
+ * @param[in] mask_len The length of the mask.
+ * @param[in] seed Pointer to the seed bytes.
+ * @param[in] seed_len The length of the seed.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg pkcs1_mgf1(OUT byte* mask, IN int mask_len, IN const byte* seed, IN int seed_len)
+{
+    if((mask == NULL) || (mask_len < 0) || ((seed == NULL) && (seed_len > 0)) || (seed_len < 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    memset(mask, 0, (size_t)mask_len);
+    mgf1_xor(mask, mask_len, seed, seed_len);
+
+    return SUCCESS;
+}
+
+
+/***********************************************
+ * RSAES-OAEP
+ ***********************************************/
+/**
+ * @brief Encrypts a message with RSAES-OAEP (RFC 8017 7.1.1), SHA-256 and MGF1-SHA256.
+ *
+ * The encoded message 0x00 || maskedSeed || maskedDB is built in place in `ciphertext`,
+ * read into a bigint, encrypted with (e, n) and written back over it.
+ *
+ * @param[out] ciphertext Pointer to the output buffer of k bytes, k being the byte length of n.
+ * @param[in] message Pointer to the message bytes (must not overlap `ciphertext`).
+ * @param[in] message_len The message length, at most k - 2 * PKCS1_HASH_LEN - 2.
+ * @param[in] label Pointer to the label bytes, or NULL for the empty label.
+ * @param[in] label_len The length of the label.
+ * @param[in] e The public exponent bigint.
+ * @param[in] n The modulus bigint.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg rsa_oaep_encrypt(OUT byte* ciphertext, IN const byte* message, IN int message_len, IN const byte* label, IN int label_len, IN const bigint* e, IN const bigint* n)
+{
+    int k = 0;
+    int db_len = 0;
+    byte* seed = NULL;
+    byte* db = NULL;
+    bigint* m = NULL;
+    bigint* c = NULL;
+    int error_msg = SUCCESS;
+
+    if((ciphertext == NULL) || ((message == NULL) && (message_len > 0)) || (message_len < 0) ||
+        ((label == NULL) && (label_len > 0)) || (label_len < 0) || (e == NULL) || (n == NULL) || (n->sign != POSITIVE))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    k = bi_get_byte_len(n);
+    if(message_len > k - 2 * PKCS1_HASH_LEN - 2)
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);     //message too long
+        return FAILED;
+    }
+
+    // DB = lHash || PS || 0x01 || M
+    ciphertext[0] = 0;
+    seed = ciphertext + 1;
+    db = seed + PKCS1_HASH_LEN;
+    db_len = k - PKCS1_HASH_LEN - 1;
+    sha256(db, label, (size_t)label_len);
+    memset(db + PKCS1_HASH_LEN, 0, (size_t)(db_len - PKCS1_HASH_LEN - message_len - 1));
+    db[db_len - message_len - 1] = 0x01;
+    if(message_len > 0)
+    {
+        memcpy(db + db_len - message_len, message, (size_t)message_len);
+    }
+
+    // maskedDB = DB ^ MGF(seed), maskedSeed = seed ^ MGF(maskedDB)
+    if(drbg_bytes(seed, PKCS1_HASH_LEN) == FAILED)
+    {
+        return FAILED;
+    }
+    mgf1_xor(db, db_len, seed, PKCS1_HASH_LEN);
+    mgf1_xor(seed, PKCS1_HASH_LEN, db, db_len);
+
+    error_msg = bi_set_from_bytes(&m, ciphertext, k, BYTES_BIG);
+    if(error_msg == SUCCESS)
+    {
+        error_msg = rsa_encryption(&c, m, e, n);
+    }
+    if(error_msg == SUCCESS)
+    {
+        error_msg = bi_get_bytes(ciphertext, k, c, BYTES_BIG);
+    }
+
+    bi_delete(&m);
+    bi_delete(&c);
+
+    return error_msg;
+}
+
+/**
+ * @brief Decrypts an RSAES-OAEP ciphertext (RFC 8017 7.1.2), SHA-256 and MGF1-SHA256.
+ *
+ * The checks of the decoded message (leading zero byte, label hash, the 0x01 separator) are
+ * combined without branches, and every failure after the RSA operation is reported the same
+ * way, so a caller cannot be used as a padding oracle.
+ *
+ * @param[out] message Pointer to the output buffer of at least k - 2 * PKCS1_HASH_LEN - 2 bytes.
+ * @param[out] message_len Pointer to the length of the decrypted message.
+ * @param[in] ciphertext Pointer to the k ciphertext bytes, k being the byte length of n.
+ * @param[in] label Pointer to the label bytes, or NULL for the empty label.
+ * @param[in] label_len The length of the label.
+ * @param[in] d The private exponent bigint.
+ * @param[in] n The modulus bigint.
+ *
+ * @return Returns 1 on success, -1 on failure (invalid input or decryption error).
+ */
+msg rsa_oaep_decrypt(OUT byte* message, OUT int* message_len, IN const byte* ciphertext, IN const byte* label, IN int label_len, IN const bigint* d, IN const bigint* n)
+{
+    int k = 0;
+    int db_len = 0;
+    byte l_hash[PKCS1_HASH_LEN];
+    byte* em = NULL;
+    byte* seed = NULL;
+    byte* db = NULL;
+    bigint* c = NULL;
+    bigint* m = NULL;
+    unsigned int good = 0, found = 0, bad = 0, diff = 0, index = 0;
+
+    if((message == NULL) || (message_len == NULL) || (ciphertext == NULL) || ((label == NULL) && (label_len > 0)) ||
+        (label_len < 0) || (d == NULL) || (n == NULL) || (n->sign != POSITIVE))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    k = bi_get_byte_len(n);
+    if(k < 2 * PKCS1_HASH_LEN + 2)
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    em = (byte*)malloc((size_t)k);
+    if(em == NULL)
+    {
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        return FAILED;
+    }
+    if((bi_set_from_bytes(&c, ciphertext, k, BYTES_BIG) == FAILED) || (c->sign == ZERO) || (bi_compare(c, n) >= 0) ||
+        (rsa_decryption(&m, c, d, n) == FAILED) || (bi_get_bytes(em, k, m, BYTES_BIG) == FAILED))
+    {
+        fprintf(stderr, ERR_DECRYPTION);
+        bi_delete(&c);
+        bi_delete(&m);
+        free(em);
+        return FAILED;
+    }
+
+    // seed = maskedSeed ^ MGF(maskedDB), DB = maskedDB ^ MGF(seed)
+    seed = em + 1;
+    db = seed + PKCS1_HASH_LEN;
+    db_len = k - PKCS1_HASH_LEN - 1;
+    mgf1_xor(seed, PKCS1_HASH_LEN, db, db_len);
+    mgf1_xor(db, db_len, seed, PKCS1_HASH_LEN);
+
+    // Y == 0, lHash' == lHash, then PS (zeros) and 0x01 before M
+    sha256(l_hash, label, (size_t)label_len);
+    good = ct_is_zero(em[0]);
+    for(int i = 0; i < PKCS1_HASH_LEN; i++)
+    {
+        diff |= (unsigned int)(db[i] ^ l_hash[i]);
+    }
+    good &= ct_is_zero(diff);
+    for(int i = PKCS1_HASH_LEN; i < db_len; i++)
+    {
+        unsigned int is_one = ct_is_zero(db[i] ^ 0x01u);
+        unsigned int is_zero = ct_is_zero(db[i]);
+
+        index |= ~found & is_one & (unsigned int)i;
+        bad |= ~found & ~is_zero & ~is_one;
+        found |= is_one;
+    }
+    good &= found & ~bad;
+
+    if(good)
+    {
+        *message_len = db_len - (int)index - 1;
+        memcpy(message, db + index + 1, (size_t)*message_len);
+    }
+    else
+    {
+        fprintf(stderr, ERR_DECRYPTION);
+    }
+
+    memset(em, 0, (size_t)k);
+    free(em);
+    bi_delete(&c);
+    bi_delete(&m);
+
+    return good ? SUCCESS : FAILED;
+}
+
+
+/***********************************************
+ * RSASSA-PSS
+ ***********************************************/
+/**
+ * @brief Computes H = SHA-256(0x00 * 8 || SHA-256(message) || salt) for EMSA-PSS.
+ */
+static void pss_hash(OUT byte* h, IN const byte* message, IN int message_len, IN const byte* salt)
+{
+    static const byte zeros[8] = {0};
+    byte m_hash[PKCS1_HASH_LEN];
+    sha256_ctx ctx;
+
+    sha256(m_hash, message, (size_t)message_len);
+    sha256_init(&ctx);
+    sha256_update(&ctx, zeros, sizeof(zeros));
+    sha256_update(&ctx, m_hash, PKCS1_HASH_LEN);
+    sha256_update(&ctx, salt, PKCS1_SALT_LEN);
+    sha256_final(h, &ctx);
+}
+
+/**
+ * @brief Signs a message with RSASSA-PSS (RFC 8017 8.1.1), SHA-256, MGF1-SHA256 and a 32-byte salt.
+ *
+ * The encoded message maskedDB || H || 0xbc is built in place in `signature`, read into a
+ * bigint, exponentiated with (d, n) and written back over it.
+ *
+ * @param[out] signature Pointer to the output buffer of k bytes, k being the byte length of n.
+ * @param[in] message Pointer to the message bytes.
+ * @param[in] message_len The message length.
+ * @param[in] d The private exponent bigint.
+ * @param[in] n The modulus bigint.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg rsa_pss_sign(OUT byte* signature, IN const byte* message, IN int message_len, IN const bigint* d, IN const bigint* n)
+{
+    int k = 0;
+    int em_bits = 0;
+    int em_len = 0;
+    int db_len = 0;
+    byte salt[PKCS1_SALT_LEN];
+    byte* em = NULL;
+    bigint* m = NULL;
+    bigint* s = NULL;
+    int error_msg = SUCCESS;
+
+    if((signature == NULL) || ((message == NULL) && (message_len > 0)) || (message_len < 0) || (d == NULL) ||
+        (n == NULL) || (n->sign != POSITIVE))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    k = bi_get_byte_len(n);
+    em_bits = pkcs1_bit_len(n) - 1;
+    em_len = (em_bits + 7) / 8;
+    if(em_len < PKCS1_HASH_LEN + PKCS1_SALT_LEN + 2)
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    if(drbg_bytes(salt, PKCS1_SALT_LEN) == FAILED)
+    {
+        return FAILED;
+    }
+
+    // EM = maskedDB || H || 0xbc with DB = PS || 0x01 || salt, right-aligned in k bytes
+    memset(signature, 0, (size_t)(k - em_len));
+    em = signature + (k - em_len);
+    db_len = em_len - PKCS1_HASH_LEN - 1;
+    pss_hash(em + db_len, message, message_len, salt);
+    memset(em, 0, (size_t)(db_len - PKCS1_SALT_LEN - 1));
+    em[db_len - PKCS1_SALT_LEN - 1] = 0x01;
+    memcpy(em + db_len - PKCS1_SALT_LEN, salt, PKCS1_SALT_LEN);
+    mgf1_xor(em, db_len, em + db_len, PKCS1_HASH_LEN);
+    em[0] &= (byte)(0xff >> (8 * em_len - em_bits));
+    em[em_len - 1] = 0xbc;
+#if ZERORIZE == 1
+    memset(salt, 0, sizeof(salt));
+#endif
+
+    error_msg = bi_set_from_bytes(&m, signature, k, BYTES_BIG);
+    if(error_msg == SUCCESS)
+    {
+        error_msg = rsa_decryption(&s, m, d, n);
+    }
+    if(error_msg == SUCCESS)
+    {
+        error_msg = bi_get_bytes(signature, k, s, BYTES_BIG);
+    }
+
+    bi_delete(&m);
+    bi_delete(&s);
+
+    return error_msg;
+}
+
+/**
+ * @brief Verifies an RSASSA-PSS signature (RFC 8017 8.1.2), SHA-256, MGF1-SHA256 and a 32-byte salt.
+ *
+ * @param[in] message Pointer to the message bytes.
+ * @param[in] message_len The message length.
+ * @param[in] signature Pointer to the k signature bytes, k being the byte length of n.
+ * @param[in] e The public exponent bigint.
+ * @param[in] n The modulus bigint.
+ *
+ * @return Returns SIGN_VALID (3) or SIGN_INVALID (-3), or -1 on failure.
+ */
+msg rsa_pss_verify(IN const byte* message, IN int message_len, IN const byte* signature, IN const bigint* e, IN const bigint* n)
+{
+    int k = 0;
+    int em_bits = 0;
+    int em_len = 0;
+    int db_len = 0;
+    byte h[PKCS1_HASH_LEN];
+    byte* em = NULL;
+    bigint* s = NULL;
+    bigint* m = NULL;
+    int result = SIGN_INVALID;
+
+    if((signature == NULL) || ((message == NULL) && (message_len > 0)) || (message_len < 0) || (e == NULL) ||
+        (n == NULL) || (n->sign != POSITIVE))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    k = bi_get_byte_len(n);
+    em_bits = pkcs1_bit_len(n) - 1;
+    em_len = (em_bits + 7) / 8;
+    if(em_len < PKCS1_HASH_LEN + PKCS1_SALT_LEN + 2)
+    {
+        return SIGN_INVALID;
+    }
+
+    // m = s^e mod n, EM = I2OSP(m, emLen)
+    if(bi_set_from_bytes(&s, signature, k, BYTES_BIG) == FAILED)
+    {
+        return FAILED;
+    }
+    if((s->sign == ZERO) || (bi_compare(s, n) >= 0))
+    {
+        bi_delete(&s);
+        return SIGN_INVALID;
+    }
+    em = (byte*)malloc((size_t)em_len);
+    if((em == NULL) || (rsa_encryption(&m, s, e, n) == FAILED))
+    {
+        free(em);
+        bi_delete(&s);
+        return FAILED;
+    }
+
+    db_len = em_len - PKCS1_HASH_LEN - 1;
+    if((bi_get_byte_len(m) <= em_len) && (bi_get_bytes(em, em_len, m, BYTES_BIG) == SUCCESS) &&
+        (em[em_len - 1] == 0xbc) && ((em[0] & ~(0xff >> (8 * em_len - em_bits))) == 0))
+    {
+        int pos = 0;
+
+        // DB = maskedDB ^ MGF(H) must be PS || 0x01 || salt
+        mgf1_xor(em, db_len, em + db_len, PKCS1_HASH_LEN);
+        em[0] &= (byte)(0xff >> (8 * em_len - em_bits));
+        while((pos < db_len - PKCS1_SALT_LEN - 1) && (em[pos] == 0))
+        {
+            pos++;
+        }
+        if((pos == db_len - PKCS1_SALT_LEN - 1) && (em[pos] == 0x01))
+        {
+            pss_hash(h, message, message_len, em + db_len - PKCS1_SALT_LEN);
+            if(memcmp(h, em + db_len, PKCS1_HASH_LEN) == 0)
+            {
+                result = SIGN_VALID;
+            }
+        }
+    }
+
+    free(em);
+    bi_delete(&s);
+    bi_delete(&m);
+
+    return result;
+}
@@ -0,0 +1,20 @@
+#ifndef PKCS1_H
+#define PKCS1_H
+
+#include "dtype.h"
+#include "sha256.h"
+
+#define PKCS1_HASH_LEN  SHA256_DIGEST_LEN   //OAEP and PSS use SHA-256 for the hash and MGF1
+#define PKCS1_SALT_LEN  PKCS1_HASH_LEN      //PSS salt length
+
+msg pkcs1_mgf1(OUT byte* mask, IN int mask_len, IN const byte* seed, IN int seed_len);
+
+msg rsa_oaep_encrypt(OUT byte* ciphertext, IN const byte* message, IN int message_len, IN const byte* label, IN int label_len, IN const bigint* e, IN const bigint* n);
+
+msg rsa_oaep_decrypt(OUT byte* message, OUT int* message_len, IN const byte* ciphertext, IN const byte* label, IN int label_len, IN const bigint* d, IN const bigint* n);
+
+msg rsa_pss_sign(OUT byte* signature, IN const byte* message, IN int message_len, IN const bigint* d, IN const bigint* n);
+
+msg rsa_pss_verify(IN const byte* message, IN int message_len, IN const byte* signature, IN const bigint* e, IN const bigint* n);
+
+#endif
@@ -1,10 +1,395 @@
 #include <stdio.h>
-
+#include <stdlib.h>
 
 #include "operation.h"
 #include "bigintfun.h"
+#include "arrayfun.h"
 #include "params.h"
 #include "errormsg.h"
+#include "rsa.h"
+#include "montgomery.h"
+#include "mont_avx2.h"
+#include "threadpool.h"
+
+
+/***********************************************
+ * Small Primality Test (up to 128 bits)
+ ***********************************************/
+//first 13 primes: witnesses of deterministic Miller-Rabin
+static const uint64_t small_primes[SMALL_PRIME_NUM] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41};
+
+//13 prime witnesses are deterministic below 3317044064679887385961981 (~2^81)
+#define SMALL_DETERMINISTIC_HI  (uint64_t)0x2be69
+#define SMALL_DETERMINISTIC_LO  (uint64_t)0x51adc5b22410a5fd
+
+/**
+ * @brief Montgomery parameters of an odd modulus with at most two 64-bit limbs.
+ */
+typedef struct {
+    int limb_num;          /**< Number of 64-bit limbs of the modulus (1 or 2). */
+    uint64_t n[2];         /**< Modulus, least significant limb first. */
+    uint64_t n0_inv;       /**< -n^(-1) mod 2^64. */
+    uint64_t one[2];       /**< R mod n (Montgomery form of 1). */
+    uint64_t minus_one[2]; /**< n - (R mod n) (Montgomery form of n - 1). */
+    uint64_t r2[2];        /**< R^2 mod n. */
+} small_mont;
+
+/**
+ * @brief Computes a * b + c + d on 64-bit limbs, returning the low limb and storing the high limb.
+ */
+static uint64_t small_mac(IN uint64_t a, IN uint64_t b, IN uint64_t c, IN uint64_t d, OUT uint64_t* hi)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 t = (unsigned __int128)a * b + c + d;
+    *hi = (uint64_t)(t >> 64);
+    return (uint64_t)t;
+#else
+    uint64_t a1 = a >> 32, a0 = a & 0xFFFFFFFF;
+    uint64_t b1 = b >> 32, b0 = b & 0xFFFFFFFF;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+    uint64_t lo = (mid << 32) | (p00 & 0xFFFFFFFF);
+    uint64_t high = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+
+    lo += c;
+    high += (lo < c);
+    lo += d;
+    high += (lo < d);
+    *hi = high;
+    return lo;
+#endif
+}
+
+/**
+ * @brief Compares two limb arrays, returning 1, 0 or -1.
+ */
+static int small_compare(IN const uint64_t* a, IN const uint64_t* b, IN int limb_num)
+{
+    for(int i = limb_num - 1; i >= 0; i--)
+    {
+        if(a[i] != b[i])
+        {
+            return (a[i] > b[i]) ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Subtracts two limb arrays (dst = a - b) and returns the borrow.
+ */
+static uint64_t small_sub(OUT uint64_t* dst, IN const uint64_t* a, IN const uint64_t* b, IN int limb_num)
+{
+    uint64_t borrow = 0;
+    for(int i = 0; i < limb_num; i++)
+    {
+        uint64_t t = a[i] - b[i];
+        uint64_t borrow_out = (a[i] < b[i]);
+        borrow_out |= (t < borrow);
+        dst[i] = t - borrow;
+        borrow = borrow_out;
+    }
+    return borrow;
+}
+
+/**
+ * @brief Doubles a residue modulo n (dst = 2 * dst mod n).
+ */
+static void small_mod_double(INOUT uint64_t* dst, IN const small_mont* ctx)
+{
+    uint64_t carry = dst[ctx->limb_num - 1] >> 63;
+    for(int i = ctx->limb_num - 1; i > 0; i--)
+    {
+        dst[i] = (dst[i] << 1) | (dst[i - 1] >> 63);
+    }
+    dst[0] <<= 1;
+    if(carry || (small_compare(dst, ctx->n, ctx->limb_num) >= 0))
+    {
+        small_sub(dst, dst, ctx->n, ctx->limb_num);
+    }
+}
+
+/**
+ * @brief Montgomery multiplication (CIOS) on one or two limbs: dst = a * b * R^(-1) mod n.
+ */
+static void small_mont_mul(OUT uint64_t* dst, IN const uint64_t* a, IN const uint64_t* b, IN const small_mont* ctx)
+{
+    int s = ctx->limb_num;
+    uint64_t t[4] = {0, 0, 0, 0};
+    uint64_t carry = 0;
+    uint64_t m = 0;
+
+    for(int i = 0; i < s; i++)
+    {
+        carry = 0;
+        for(int j = 0; j < s; j++)
+        {
+            t[j] = small_mac(a[j], b[i], t[j], carry, &carry);
+        }
+        t[s] += carry;
+        t[s + 1] = (t[s] < carry);
+
+        m = t[0] * ctx->n0_inv;
+        small_mac(m, ctx->n[0], t[0], 0, &carry);
+        for(int j = 1; j < s; j++)
+        {
+            t[j - 1] = small_mac(m, ctx->n[j], t[j], carry, &carry);
+        }
+        t[s - 1] = t[s] + carry;
+        t[s] = t[s + 1] + (t[s - 1] < carry);
+    }
+
+    if(t[s] || (small_compare(t, ctx->n, s) >= 0))
+    {
+        small_sub(t, t, ctx->n, s);
+    }
+    for(int i = 0; i < s; i++)
+    {
+        dst[i] = t[i];
+    }
+}
+
+/**
+ * @brief Sets up Montgomery parameters for an odd modulus n.
+ */
+static void small_mont_init(OUT small_mont* ctx, IN const uint64_t* n, IN int limb_num)
+{
+    uint64_t inv = n[0];
+
+    ctx->limb_num = limb_num;
+    ctx->n[0] = n[0];
+    ctx->n[1] = (limb_num == 2) ? n[1] : 0;
+
+    // Newton iteration: inv = n^(-1) mod 2^64 (each step doubles correct bits)
+    for(int i = 0; i < 5; i++)
+    {
+        inv *= 2 - n[0] * inv;
+    }
+    ctx->n0_inv = (uint64_t)0 - inv;
+
+    // R mod n and R^2 mod n by modular doubling
+    ctx->one[0] = 1;
+    ctx->one[1] = 0;
+    for(int i = 0; i < 64 * limb_num; i++)
+    {
+        small_mod_double(ctx->one, ctx);
+    }
+    ctx->r2[0] = ctx->one[0];
+    ctx->r2[1] = ctx->one[1];
+    for(int i = 0; i < 64 * limb_num; i++)
+    {
+        small_mod_double(ctx->r2, ctx);
+    }
+    small_sub(ctx->minus_one, ctx->n, ctx->one, limb_num);
+}
+
+/**
+ * @brief Runs one Miller-Rabin round for witness a (a < n) in Montgomery domain.
+ * 
+ * @return Returns COMPOSITE if a proves n composite, PROBABLY_PRIME otherwise.
+ */
+static msg small_witness_test(IN const small_mont* ctx, IN const uint64_t* a, IN const uint64_t* q, IN int l)
+{
+    int s = ctx->limb_num;
+    uint64_t base[2] = {0, 0};
+    uint64_t x[2] = {0, 0};
+    int top_bit = 64 * s - 1;
+
+    small_mont_mul(base, a, ctx->r2, ctx);
+    x[0] = ctx->one[0];
+    x[1] = ctx->one[1];
+
+    while((top_bit > 0) && !((q[top_bit / 64] >> (top_bit % 64)) & 1))
+    {
+        top_bit--;
+    }
+    for(int bit_index = top_bit; bit_index >= 0; bit_index--)
+    {
+        small_mont_mul(x, x, x, ctx);
+        if((q[bit_index / 64] >> (bit_index % 64)) & 1)
+        {
+            small_mont_mul(x, x, base, ctx);
+        }
+    }
+
+    if((small_compare(x, ctx->one, s) == 0) || (small_compare(x, ctx->minus_one, s) == 0))
+    {
+        return PROBABLY_PRIME;
+    }
+    for(int j = 1; j < l; j++)
+    {
+        small_mont_mul(x, x, x, ctx);
+        if(small_compare(x, ctx->minus_one, s) == 0)
+        {
+            return PROBABLY_PRIME;
+        }
+        if(small_compare(x, ctx->one, s) == 0)
+        {
+            return COMPOSITE;
+        }
+    }
+    return COMPOSITE;
+}
+
+/**
+ * @brief Miller-Rabin test of an odd limb-array number n > 41 without heap allocation.
+ * 
+ * The first 13 primes are always used as witnesses. When `testnum` is positive,
+ * that many random witnesses in [2, n - 2] are tested in addition. Returns FAILED
+ * if the random witnesses cannot be drawn.
+ */
+static msg small_MillerRabin(IN const uint64_t* n, IN int limb_num, IN int testnum)
+{
+    small_mont ctx;
+    uint64_t n_minus_1[2] = {0, 0};
+    uint64_t q[2] = {0, 0};
+    uint64_t a[2] = {0, 0};
+    uint64_t mask = 0;
+    int top = limb_num - 1;
+    int l = 0;
+    word rand_buf[128 / SIZEOFWORD];
+
+    small_mont_init(&ctx, n, limb_num);
+
+    n_minus_1[0] = n[0] - 1;
+    n_minus_1[1] = (limb_num == 2) ? n[1] : 0;
+    q[0] = n_minus_1[0];
+    q[1] = n_minus_1[1];
+    while(!(q[0] & 1))
+    {
+        q[0] = (q[0] >> 1) | (q[1] << 63);
+        q[1] >>= 1;
+        l++;
+    }
+
+    for(int i = 0; i < SMALL_PRIME_NUM; i++)
+    {
+        a[0] = small_primes[i];
+        a[1] = 0;
+        if(small_witness_test(&ctx, a, q, l) == COMPOSITE)
+        {
+            return COMPOSITE;
+        }
+    }
+
+    // random witnesses in [2, n - 2] by masked rejection sampling
+    mask = n[top];
+    mask |= mask >> 1;  mask |= mask >> 2;  mask |= mask >> 4;
+    mask |= mask >> 8;  mask |= mask >> 16; mask |= mask >> 32;
+    while(testnum > 0)
+    {
+        do{
+            if(array_rand(rand_buf, 128 / SIZEOFWORD) == FAILED)
+            {
+                return FAILED;
+            }
+            a[0] = a[1] = 0;
+            for(int i = 0; i < 128 / SIZEOFWORD; i++)
+            {
+                a[(i * SIZEOFWORD) / 64] |= (uint64_t)rand_buf[i] << ((i * SIZEOFWORD) % 64);
+            }
+            if(limb_num == 1)
+            {
+                a[1] = 0;
+            }
+            a[top] &= mask;
+        }while(((a[1] == 0) && (a[0] < 2)) || (small_compare(a, n_minus_1, limb_num) >= 0));
+
+        if(small_witness_test(&ctx, a, q, l) == COMPOSITE)
+        {
+            return COMPOSITE;
+        }
+        testnum--;
+    }
+
+    return PROBABLY_PRIME;
+}
+
+/**
+ * @brief Trial division by the first 13 primes.
+ * 
+ * @return Returns PROBABLY_PRIME if n is one of them, COMPOSITE if one divides n, 0 if undecided.
+ */
+static msg small_trial_division(IN uint64_t n_hi, IN uint64_t n_lo)
+{
+    if((n_hi == 0) && (n_lo < 2))
+    {
+        return COMPOSITE;
+    }
+    for(int i = 0; i < SMALL_PRIME_NUM; i++)
+    {
+        uint64_t p = small_primes[i];
+        // (n_hi * 2^64 + n_lo) mod p with 2^64 mod p folded in 32-bit halves
+        uint64_t r = ((((n_hi % p) << 32) | (n_lo >> 32)) % p);
+        r = ((r << 32) | (n_lo & 0xFFFFFFFF)) % p;
+
+        if((n_hi == 0) && (n_lo == p))
+        {
+            return PROBABLY_PRIME;
+        }
+        if(r == 0)
+        {
+            return COMPOSITE;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Deterministic primality test for a 64-bit number.
+ * 
+ * This function decides primality of `n` exactly, using trial division followed by
+ * Miller-Rabin with the first 13 primes as witnesses (sufficient for every n < 2^64).
+ * It performs no heap allocation and works on native 64-bit limbs.
+ * 
+ * @param[in] n The number to be tested.
+ * 
+ * @return Returns PROBABLY_PRIME if `n` is prime, COMPOSITE otherwise.
+ */
+msg bi_MillerRabinTest_u64(IN uint64_t n)
+{
+    msg result = small_trial_division(0, n);
+
+    if(result != 0)
+    {
+        return result;
+    }
+    return small_MillerRabin(&n, 1, 0);
+}
+
+/**
+ * @brief Primality test for a number of at most 128 bits.
+ * 
+ * This function tests `n = n_hi * 2^64 + n_lo` with trial division and Miller-Rabin on
+ * two 64-bit limbs without heap allocation. Below 3317044064679887385961981 (~2^81) the
+ * fixed witness set makes the answer deterministic; above it `testnum` random witnesses
+ * are tested in addition to the fixed ones.
+ * 
+ * @param[in] n_hi The most significant 64 bits of the number.
+ * @param[in] n_lo The least significant 64 bits of the number.
+ * @param[in] testnum The number of additional random rounds for numbers above ~2^81.
+ * 
+ * @return Returns PROBABLY_PRIME if `n` is probably prime, COMPOSITE otherwise, -1 if the random witnesses cannot be drawn.
+ */
+msg bi_MillerRabinTest_u128(IN uint64_t n_hi, IN uint64_t n_lo, IN int testnum)
+{
+    uint64_t n[2] = {n_lo, n_hi};
+    msg result = small_trial_division(n_hi, n_lo);
+
+    if(result != 0)
+    {
+        return result;
+    }
+    if(n_hi == 0)
+    {
+        return small_MillerRabin(n, 1, 0);
+    }
+    if((n_hi < SMALL_DETERMINISTIC_HI) || ((n_hi == SMALL_DETERMINISTIC_HI) && (n_lo < SMALL_DETERMINISTIC_LO)))
+    {
+        testnum = 0;
+    }
+    return small_MillerRabin(n, 2, testnum);
+}
 
 
 /***********************************************
@@ -47,11 +432,7 @@ msg bi_is_composite(IN const bigint* n, IN const bigint* q, IN const bigint* a,
     buf1->a[0] = 1;
     bi_sub(&n_minus_1, n, buf1);
 
-#if SECURE_SCA == 1
-    bi_mod_exp_MaS(&a_buf, a, q, n);
-#elif
-    bi_mod_exp_l2r(&a_buf, a, q, n);
-#endif
+    bi_mod_exp_mont(&a_buf, a, q, n);
     if(a_buf->sign == ZERO)
     {
         bi_delete(&buf1);
@@ -81,11 +462,7 @@ msg bi_is_composite(IN const bigint* n, IN const bigint* q, IN const bigint* a,
 
             return !COMPOSITE;
         }
-#if SECURE_SCA == 1
-    bi_mod_exp_MaS(&buf2, a_buf, buf1, n);
-#elif
-    bi_mod_exp_l2r(&buf2, a_buf, buf1, n);
-#endif
+        bi_mod_exp_mont(&buf2, a_buf, buf1, n);
         
         bi_assign(&a_buf, buf2);
     }
@@ -121,11 +498,33 @@ msg bi_MillerRabinTest(IN const bigint* src, IN int testnum)
         return FAILED;
     }
 
-    if((src->word_len == 1) && (src->a[0] == 2))
+    uint64_t limbs[2] = {0, 0};
+    int small_flag = 1;
+
+    // numbers of at most 128 bits take the allocation-free path
+    for(int word_index = 0; word_index < src->word_len; word_index++)
     {
-        return PROBABLY_PRIME;
+        if((word_index * SIZEOFWORD) >= 128)
+        {
+            if(src->a[word_index] != 0)
+            {
+                small_flag = 0;
+                break;
+            }
+            continue;
+        }
+        limbs[(word_index * SIZEOFWORD) / 64] |= (uint64_t)src->a[word_index] << ((word_index * SIZEOFWORD) % 64);
+    }
+    if(small_flag == 1)
+    {
+        if(limbs[1] == 0)
+        {
+            return bi_MillerRabinTest_u64(limbs[0]);
+        }
+        return bi_MillerRabinTest_u128(limbs[1], limbs[0], testnum);
     }
-    else if ((src->a[0] & 1) == 0)
+
+    if ((src->a[0] & 1) == 0)
     {
         return COMPOSITE;
     }
@@ -133,9 +532,16 @@ msg bi_MillerRabinTest(IN const bigint* src, IN int testnum)
     bigint* q = NULL;
     bigint* n_minus_1 = NULL;
     bigint* one = NULL;
-    bigint* a = NULL;
+    bigint* first = NULL;
+    bigint** a = NULL;
+    msg result = PROBABLY_PRIME;
     int l = 0;
 
+    if(testnum <= 0)
+    {
+        return PROBABLY_PRIME;
+    }
+
     bi_new(&one, 1);
     one->sign = POSITIVE;
     one->a[0] = 1;
@@ -147,25 +553,55 @@ msg bi_MillerRabinTest(IN const bigint* src, IN int testnum)
         l++;
     }
 
-    while (testnum > 0)
-    {   
-        bi_get_random_within_range(&a, one, n_minus_1);
-        if(bi_is_composite(src, q, a, l) == COMPOSITE)
+    // most candidates are composite and fail on the first witness: draw it alone,
+    // and the other witnesses in one batch only for a candidate that passes it
+    if(bi_get_random_within_range(&first, one, n_minus_1) == FAILED)
+    {
+        result = FAILED;
+    }
+    else if(bi_is_composite(src, q, first, l) == COMPOSITE)
+    {
+        result = COMPOSITE;
+    }
+    else if(testnum > 1)
+    {
+        a = (bigint**)calloc(testnum - 1, sizeof(bigint*));
+        if(a == NULL)
         {
-            bi_delete(&q);
-            bi_delete(&n_minus_1);
-            bi_delete(&one);
-            bi_delete(&a);
-            return COMPOSITE;
+            fprintf(stderr, ERR_MEMORY_ALLOCATION);
+            result = FAILED;
         }
-        testnum--;
+        else if(bi_get_random_within_range_batch(a, testnum - 1, one, n_minus_1) == FAILED)
+        {
+            result = FAILED;
+        }
+        else
+        {
+            for(int test_index = 0; test_index < testnum - 1; test_index++)
+            {
+                if(bi_is_composite(src, q, a[test_index], l) == COMPOSITE)
+                {
+                    result = COMPOSITE;
+                    break;
+                }
+            }
+        }
+    }
+
+    if(a != NULL)
+    {
+        for(int test_index = 0; test_index < testnum - 1; test_index++)
+        {
+            bi_delete(&a[test_index]);
+        }
+        free(a);
     }
+    bi_delete(&first);
     bi_delete(&q);
     bi_delete(&n_minus_1);
     bi_delete(&one);
-    bi_delete(&a);
 
-    return PROBABLY_PRIME;
+    return result;
 }
 
 
@@ -258,67 +694,1134 @@ msg rsa_key_generation(OUT bigint** N, OUT bigint** e, OUT bigint** p, OUT bigin
 }
 
 
-/***********************************************
- * RSA Encryption
- ***********************************************/
 /**
- * @brief Encrypts a message using the RSA public key.
- * 
- * This function encrypts the input message `msg` using the RSA algorithm. It uses the public key 
- * (e, N) to compute the ciphertext as `ciphertext = msg^e mod N`.
- * 
- * @param[out] ciphertext Pointer to the bigint that will hold the encrypted message.
- * @param[in] msg The input bigint message to be encrypted.
- * @param[in] e The public exponent bigint.
- * @param[in] n The modulus bigint.
- * 
- * @return Returns 1 on success, -1 on failure (e.g., invalid inputs or memory allocation error).
+ * @brief Returns 1 if `primes[index]` differs from every earlier prime.
  */
-msg rsa_encryption(OUT bigint** ciphertext, IN const bigint* msg, IN const bigint* e, IN const bigint* n)
+static int rsa_prime_is_new(IN bigint* const* primes, IN int index)
 {
-    if((msg == NULL) || (e == NULL) || (n == NULL) || (msg->a == NULL) || (e->a == NULL) || (n->a == NULL) 
-    || (msg->sign != POSITIVE) || (e->sign != POSITIVE) || (n->sign != POSITIVE) || (msg->word_len <= 0)|| (e->word_len <= 0)|| (n->word_len <= 0))
+    for(int i = 0; i < index; i++)
     {
-        fprintf(stderr, ERR_INVALID_INPUT);
-        return FAILED;
+        if(bi_compare(primes[i], primes[index]) == 0)
+        {
+            return 0;
+        }
     }
-    // C = M^e mod N
-    bi_mod_exp_l2r(ciphertext, msg, e, n);
-
-    return SUCCESS;
+    return 1;
 }
 
-
-/***********************************************
- * RSA Decryption
- ***********************************************/
 /**
- * @brief Decrypts a ciphertext using the RSA private key.
+ * @brief Generates a multi-prime RSA key (RFC 8017): N = r_1 * ... * r_u for u = `prime_num` distinct primes.
  * 
- * This function decrypts the input ciphertext `ciphertext` using the RSA algorithm. It uses the private key 
- * (d, N) to compute the original message as `msg = ciphertext^d mod N`.
+ * Each prime has about bitlen / prime_num bits and N has exactly `bitlen` bits: the first
+ * u - 1 primes have their two top bits set and the last one is drawn above 2^(bitlen-1) divided
+ * by their product. With more primes each CRT exponentiation of the private operation works
+ * modulo a smaller prime, which costs about u^2 / 4 times less than two-prime CRT.
  * 
- * @param[out] msg Pointer to the bigint that will hold the decrypted message.
- * @param[in] ciphertext The input bigint ciphertext to be decrypted.
- * @param[in] d The private exponent bigint.
- * @param[in] n The modulus bigint.
+ * @param[out] N Pointer to the bigint that will hold the modulus.
+ * @param[out] e Pointer to the bigint that will hold the public exponent.
+ * @param[out] primes Array of `prime_num` bigint pointers that will hold the prime factors.
+ * @param[in] prime_num The number of primes, 2 ... RSA_PRIME_MAX.
+ * @param[out] d Pointer to the bigint that will hold the private exponent.
+ * @param[in] bitlen The bit length of the modulus `N`, at least 16 bits per prime.
  * 
- * @return Returns 1 on success, -1 on failure (e.g., invalid inputs or memory allocation error).
+ * @return Returns 1 on success, -1 on failure (e.g., invalid bit length or memory allocation error).
  */
-msg rsa_decryption(OUT bigint** msg, IN const bigint* ciphertext, IN const bigint* d, IN const bigint* n)
+msg rsa_key_generation_multi(OUT bigint** N, OUT bigint** e, OUT bigint** primes, IN int prime_num, OUT bigint** d, IN int bitlen)
 {
-    if((ciphertext == NULL) || (d == NULL) || (n == NULL) || (ciphertext->a == NULL) || (d->a == NULL) || (n->a == NULL) 
-    || (ciphertext->sign != POSITIVE) || (d->sign != POSITIVE) || (n->sign != POSITIVE) || (ciphertext->word_len <= 0)|| (d->word_len <= 0)|| (n->word_len <= 0))
+    if((N == NULL) || (e == NULL) || (primes == NULL) || (d == NULL) || (prime_num < 2) || (prime_num > RSA_PRIME_MAX) ||
+        (bitlen < 16 * prime_num))
     {
         fprintf(stderr, ERR_INVALID_INPUT);
         return FAILED;
     }
-    // M = C^d mod N
-#if SECURE_SCA == 1
-    bi_mod_exp_MaS(msg, ciphertext, d, n);
-#elif
-    bi_mod_exp_l2r(msg, ciphertext, d, n);
-#endif
+    bigint* lower_bound = NULL;
+    bigint* upper_bound = NULL;
+    bigint* one = NULL;
+    bigint* buf1 = NULL;
+    bigint* buf2 = NULL;
+    bigint* phi_n = NULL;
+    bigint* quotient = NULL;
 
-    return SUCCESS;
+    bi_new(&one, 1);
+    one->sign = POSITIVE;
+    one->a[0] = 1;
+
+    // Choose distinct primes r_1, ..., r_u with 2^(bitlen-1) <= N < 2^bitlen
+    bi_assign(N, one);
+    for(int index = 0; index < prime_num; index++)
+    {
+        int prime_bits = bitlen / prime_num + ((index < bitlen % prime_num) ? 1 : 0);
+
+        // [3 * 2^(prime_bits-2), 2^prime_bits - 1]
+        bi_assign(&upper_bound, one);
+        bi_bit_lshift(upper_bound, prime_bits);
+        bi_sub(&upper_bound, upper_bound, one);
+        bi_assign(&lower_bound, one);
+        bi_bit_lshift(lower_bound, prime_bits - 2);
+        bi_mul_word(&lower_bound, lower_bound, 3);
+        if(index == prime_num - 1)
+        {
+            // r_u > 2^(bitlen-1) / (r_1 * ... * r_(u-1))
+            bi_assign(&buf1, one);
+            bi_bit_lshift(buf1, bitlen - 1);
+            bi_word_division(&quotient, &buf2, buf1, *N);
+            bi_add(&quotient, quotient, one);
+            if(bi_compare(quotient, lower_bound) > 0)
+            {
+                bi_assign(&lower_bound, quotient);
+            }
+            if(bi_compare(lower_bound, upper_bound) > 0)
+            {
+                // the other primes are too small for any r_u: draw them again
+                bi_assign(N, one);
+                index = -1;
+                continue;
+            }
+        }
+
+        printf("searching for prime %d...\n", index + 1);
+        do{
+            bi_get_random_within_range(&primes[index], lower_bound, upper_bound);
+        }while((bi_MillerRabinTest(primes[index], MILLER_NUM) != PROBABLY_PRIME) || (rsa_prime_is_new(primes, index) == 0));
+        bi_mul(N, *N, primes[index]);
+    }
+
+    // Calculate phi_n = (r_1 - 1) ... (r_u - 1)
+    bi_assign(&phi_n, one);
+    for(int index = 0; index < prime_num; index++)
+    {
+        bi_sub(&buf1, primes[index], one);
+        bi_mul(&phi_n, phi_n, buf1);
+    }
+
+    // Choose e such that gcd(e, phi_n) = 1
+    do{
+        bi_get_random_within_range(e, one, phi_n);
+        bi_gcd(&buf1, *e, phi_n);
+    }while(bi_compare(buf1, one) != 0); 
+
+    // Calculate d such that ed = 1 mod (phi_n)
+    bi_EEA(&buf1, d, &buf2, *e, phi_n);
+    if(((*d)->sign) == NEGATIVE)
+    {
+        bi_add(d, *d, phi_n);
+    }
+
+    bi_delete(&lower_bound);
+    bi_delete(&upper_bound);
+    bi_delete(&one);
+    bi_delete(&buf1);
+    bi_delete(&buf2);
+    bi_delete(&phi_n);
+    bi_delete(&quotient);
+
+    return SUCCESS;
+}
+
+/***********************************************
+ * RSA Encryption
+ ***********************************************/
+/**
+ * @brief Encrypts a message using the RSA public key.
+ * 
+ * This function encrypts the input message `msg` using the RSA algorithm. It uses the public key 
+ * (e, N) to compute the ciphertext as `ciphertext = msg^e mod N`.
+ * 
+ * @param[out] ciphertext Pointer to the bigint that will hold the encrypted message.
+ * @param[in] msg The input bigint message to be encrypted.
+ * @param[in] e The public exponent bigint.
+ * @param[in] n The modulus bigint.
+ * 
+ * @return Returns 1 on success, -1 on failure (e.g., invalid inputs or memory allocation error).
+ */
+msg rsa_encryption(OUT bigint** ciphertext, IN const bigint* msg, IN const bigint* e, IN const bigint* n)
+{
+    if((msg == NULL) || (e == NULL) || (n == NULL) || (msg->a == NULL) || (e->a == NULL) || (n->a == NULL) 
+    || (msg->sign != POSITIVE) || (e->sign != POSITIVE) || (n->sign != POSITIVE) || (msg->word_len <= 0)|| (e->word_len <= 0)|| (n->word_len <= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    if((n->a[0] & 1) == 0)
+    {
+        return bi_mod_exp_l2r(ciphertext, msg, e, n);
+    }
+
+    // C = M^e mod N, e is public: leading zeros are skipped and only set bits cost a multiplication
+    bi_mont_ctx ctx;
+    int error_msg;
+
+    if(bi_mont_init(&ctx, n) == FAILED)
+    {
+        return FAILED;
+    }
+    error_msg = bi_mont_exp_public(ciphertext, msg, e, &ctx);
+    bi_mont_clear(&ctx);
+
+    return error_msg;
+}
+
+
+/***********************************************
+ * RSA Decryption
+ ***********************************************/
+/**
+ * @brief Decrypts a ciphertext using the RSA private key.
+ * 
+ * This function decrypts the input ciphertext `ciphertext` using the RSA algorithm. It uses the private key 
+ * (d, N) to compute the original message as `msg = ciphertext^d mod N`.
+ * 
+ * @param[out] msg Pointer to the bigint that will hold the decrypted message.
+ * @param[in] ciphertext The input bigint ciphertext to be decrypted.
+ * @param[in] d The private exponent bigint.
+ * @param[in] n The modulus bigint.
+ * 
+ * @return Returns 1 on success, -1 on failure (e.g., invalid inputs or memory allocation error).
+ */
+msg rsa_decryption(OUT bigint** msg, IN const bigint* ciphertext, IN const bigint* d, IN const bigint* n)
+{
+    if((ciphertext == NULL) || (d == NULL) || (n == NULL) || (ciphertext->a == NULL) || (d->a == NULL) || (n->a == NULL) 
+    || (ciphertext->sign != POSITIVE) || (d->sign != POSITIVE) || (n->sign != POSITIVE) || (ciphertext->word_len <= 0)|| (d->word_len <= 0)|| (n->word_len <= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    // M = C^d mod N (constant time with SECURE_SCA)
+    bi_mod_exp_mont(msg, ciphertext, d, n);
+
+    return SUCCESS;
+}
+
+
+/***********************************************
+ * RSA Key Contexts
+ ***********************************************/
+/**
+ * @brief Sets up a public key context: copies (e, n) and precomputes the Montgomery context of n.
+ * 
+ * @param[out] ctx Pointer to the context to be set up; release it with `rsa_public_clear`.
+ * @param[in] e The public exponent bigint.
+ * @param[in] n The odd modulus bigint.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg rsa_public_init(OUT rsa_public_ctx* ctx, IN const bigint* e, IN const bigint* n)
+{
+    if((ctx == NULL) || (e == NULL) || (n == NULL) || (e->sign != POSITIVE) || (n->sign != POSITIVE))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    ctx->n = NULL;
+    ctx->e = NULL;
+    if((bi_assign(&ctx->n, n) == FAILED) || (bi_assign(&ctx->e, e) == FAILED) ||
+        (bi_mont_init(&ctx->mont_n, n) == FAILED))
+    {
+        bi_delete(&ctx->n);
+        bi_delete(&ctx->e);
+        return FAILED;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Releases a public key context.
+ * 
+ * @param[inout] ctx Pointer to the context.
+ * 
+ * @return void
+ */
+void rsa_public_clear(INOUT rsa_public_ctx* ctx)
+{
+    if(ctx == NULL)
+    {
+        return;
+    }
+    bi_delete(&ctx->n);
+    bi_delete(&ctx->e);
+    bi_mont_clear(&ctx->mont_n);
+}
+
+/**
+ * @brief Sets up a private key context.
+ * 
+ * With the primes `p` and `q` the CRT exponents d mod (p - 1), d mod (q - 1), the coefficient
+ * q^(-1) mod p and the Montgomery contexts of p and q are precomputed, so every private
+ * operation is two half-size exponentiations. `p` and `q` may be NULL.
+ * 
+ * @param[out] ctx Pointer to the context to be set up; release it with `rsa_private_clear`.
+ * @param[in] n The modulus bigint.
+ * @param[in] e The public exponent bigint.
+ * @param[in] d The private exponent bigint.
+ * @param[in] p The first prime factor of n, or NULL.
+ * @param[in] q The second prime factor of n, or NULL.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg rsa_private_init(OUT rsa_private_ctx* ctx, IN const bigint* n, IN const bigint* e, IN const bigint* d, IN const bigint* p, IN const bigint* q)
+{
+    const bigint* primes[2] = {p, q};
+
+    if((p == NULL) != (q == NULL))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    return rsa_private_init_multi(ctx, n, e, d, primes, (p == NULL) ? 0 : 2);
+}
+
+/**
+ * @brief Sets up the CRT values of an additional prime r_i of a multi-prime key; `prod` is r_1 ... r_(i-1).
+ */
+static msg rsa_prime_info_init(OUT rsa_prime_info* info, IN const bigint* prime, IN const bigint* prod, IN const bigint* d)
+{
+    msg error_msg = SUCCESS;
+    bigint* one = NULL;
+    bigint* buf = NULL;
+    bigint* quotient = NULL;
+    bigint* gcd = NULL;
+    bigint* y = NULL;
+
+    bi_new(&one, 1);
+    one->sign = POSITIVE;
+    one->a[0] = 1;
+
+    bi_assign(&info->r, prime);
+    bi_assign(&info->prod, prod);
+
+    // d_i = d mod (r_i - 1)
+    bi_sub(&buf, prime, one);
+    error_msg = bi_word_division(&quotient, &info->d, d, buf);
+
+    // t_i = (r_1 ... r_(i-1))^(-1) mod r_i
+    if(error_msg == SUCCESS)
+    {
+        error_msg = bi_word_division(&quotient, &buf, prod, prime);
+    }
+    if(error_msg == SUCCESS)
+    {
+        error_msg = bi_EEA(&gcd, &info->t, &y, buf, prime);
+    }
+    if((error_msg == SUCCESS) && (bi_compare(gcd, one) != 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        error_msg = FAILED;
+    }
+    if((error_msg == SUCCESS) && (info->t->sign == NEGATIVE))
+    {
+        bi_add(&info->t, info->t, prime);
+    }
+    if(error_msg == SUCCESS)
+    {
+        error_msg = bi_mont_init(&info->mont, prime);
+    }
+
+    bi_delete(&one);
+    bi_delete(&buf);
+    bi_delete(&quotient);
+    bi_delete(&gcd);
+    bi_delete(&y);
+
+    return error_msg;
+}
+
+/**
+ * @brief Sets up a private key context for a two-prime or multi-prime key (RFC 8017).
+ * 
+ * For r_1 = p and r_2 = q the values are those of `rsa_private_init`. Every further prime r_i
+ * gets d mod (r_i - 1), its own Montgomery context and the Garner coefficient
+ * (r_1 ... r_(i-1))^(-1) mod r_i, so the private operation is `prime_num` exponentiations
+ * modulo the primes.
+ * 
+ * @param[out] ctx Pointer to the context to be set up; release it with `rsa_private_clear`.
+ * @param[in] n The modulus bigint.
+ * @param[in] e The public exponent bigint.
+ * @param[in] d The private exponent bigint.
+ * @param[in] primes Array of the `prime_num` distinct prime factors of n.
+ * @param[in] prime_num 0 (no primes known) or 2 ... RSA_PRIME_MAX.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg rsa_private_init_multi(OUT rsa_private_ctx* ctx, IN const bigint* n, IN const bigint* e, IN const bigint* d, IN const bigint* const* primes, IN int prime_num)
+{
+    msg error_msg = SUCCESS;
+    bigint* one = NULL;
+    bigint* buf = NULL;
+    bigint* quotient = NULL;
+    bigint* gcd = NULL;
+    bigint* y = NULL;
+    bigint* prod = NULL;
+
+    if((ctx == NULL) || (n == NULL) || (e == NULL) || (d == NULL) || (n->sign != POSITIVE) ||
+        (e->sign != POSITIVE) || (d->sign != POSITIVE) || (prime_num < 0) || (prime_num == 1) ||
+        (prime_num > RSA_PRIME_MAX) || ((prime_num > 0) && (primes == NULL)))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    for(int index = 0; index < prime_num; index++)
+    {
+        if((primes[index] == NULL) || (primes[index]->sign != POSITIVE))
+        {
+            fprintf(stderr, ERR_INVALID_INPUT);
+            return FAILED;
+        }
+    }
+
+    ctx->n = ctx->e = ctx->d = NULL;
+    ctx->p = ctx->q = ctx->dp = ctx->dq = ctx->qinv = NULL;
+    ctx->mont_n.n = ctx->mont_p.n = ctx->mont_q.n = NULL;
+    ctx->mont_n.rr = ctx->mont_p.rr = ctx->mont_q.rr = NULL;
+    ctx->mont_n.avx2_rr = ctx->mont_p.avx2_rr = ctx->mont_q.avx2_rr = NULL;
+    ctx->other_num = 0;
+    for(int index = 0; index < RSA_PRIME_MAX - 2; index++)
+    {
+        ctx->other[index].r = ctx->other[index].d = ctx->other[index].t = ctx->other[index].prod = NULL;
+        ctx->other[index].mont.n = ctx->other[index].mont.rr = ctx->other[index].mont.avx2_rr = NULL;
+    }
+    if((bi_assign(&ctx->n, n) == FAILED) || (bi_assign(&ctx->e, e) == FAILED) ||
+        (bi_assign(&ctx->d, d) == FAILED) || (bi_mont_init(&ctx->mont_n, n) == FAILED))
+    {
+        rsa_private_clear(ctx);
+        return FAILED;
+    }
+    if(prime_num == 0)
+    {
+        return SUCCESS;
+    }
+
+    bi_new(&one, 1);
+    one->sign = POSITIVE;
+    one->a[0] = 1;
+
+    // n = r_1 * ... * r_u
+    bi_assign(&prod, primes[0]);
+    for(int index = 1; index < prime_num; index++)
+    {
+        bi_mul(&prod, prod, primes[index]);
+    }
+    if(bi_compare(prod, n) != 0)
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        error_msg = FAILED;
+    }
+
+    bi_assign(&ctx->p, primes[0]);
+    bi_assign(&ctx->q, primes[1]);
+
+    // dp = d mod (p - 1), dq = d mod (q - 1)
+    if(error_msg == SUCCESS)
+    {
+        bi_sub(&buf, ctx->p, one);
+        error_msg = bi_word_division(&quotient, &ctx->dp, d, buf);
+    }
+    if(error_msg == SUCCESS)
+    {
+        bi_sub(&buf, ctx->q, one);
+        error_msg = bi_word_division(&quotient, &ctx->dq, d, buf);
+    }
+
+    // qinv = q^(-1) mod p
+    if(error_msg == SUCCESS)
+    {
+        error_msg = bi_EEA(&gcd, &ctx->qinv, &y, ctx->q, ctx->p);
+    }
+    if((error_msg == SUCCESS) && (bi_compare(gcd, one) != 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        error_msg = FAILED;
+    }
+    if((error_msg == SUCCESS) && (ctx->qinv->sign == NEGATIVE))
+    {
+        bi_add(&ctx->qinv, ctx->qinv, ctx->p);
+    }
+
+    if((error_msg == FAILED) || (bi_mont_init(&ctx->mont_p, ctx->p) == FAILED) || (bi_mont_init(&ctx->mont_q, ctx->q) == FAILED))
+    {
+        error_msg = FAILED;
+    }
+
+    // r_3 ... r_u
+    bi_mul(&prod, ctx->p, ctx->q);
+    for(int index = 2; (error_msg == SUCCESS) && (index < prime_num); index++)
+    {
+        error_msg = rsa_prime_info_init(&ctx->other[index - 2], primes[index], prod, d);
+        ctx->other_num++;
+        bi_mul(&prod, prod, primes[index]);
+    }
+
+    if(error_msg == FAILED)
+    {
+        rsa_private_clear(ctx);
+    }
+
+    bi_delete(&one);
+    bi_delete(&buf);
+    bi_delete(&quotient);
+    bi_delete(&gcd);
+    bi_delete(&y);
+    bi_delete(&prod);
+
+    return error_msg;
+}
+
+/**
+ * @brief Releases a private key context; the key material is cleared with ZERORIZE.
+ * 
+ * @param[inout] ctx Pointer to the context.
+ * 
+ * @return void
+ */
+void rsa_private_clear(INOUT rsa_private_ctx* ctx)
+{
+    if(ctx == NULL)
+    {
+        return;
+    }
+    bi_delete(&ctx->n);
+    bi_delete(&ctx->e);
+    bi_delete(&ctx->d);
+    bi_delete(&ctx->p);
+    bi_delete(&ctx->q);
+    bi_delete(&ctx->dp);
+    bi_delete(&ctx->dq);
+    bi_delete(&ctx->qinv);
+    bi_mont_clear(&ctx->mont_n);
+    bi_mont_clear(&ctx->mont_p);
+    bi_mont_clear(&ctx->mont_q);
+    for(int index = 0; index < RSA_PRIME_MAX - 2; index++)
+    {
+        bi_delete(&ctx->other[index].r);
+        bi_delete(&ctx->other[index].d);
+        bi_delete(&ctx->other[index].t);
+        bi_delete(&ctx->other[index].prod);
+        bi_mont_clear(&ctx->other[index].mont);
+    }
+    ctx->other_num = 0;
+}
+
+/**
+ * @brief Recombines the residues of a CRT private operation into `dst`.
+ * 
+ * residues[0] = m1 = src^dp mod p, residues[1] = m2 = src^dq mod q and residues[2 + i] = m_i =
+ * src^d_i mod r_i: h = qinv * (m1 - m2) mod p, m = m2 + h * q, and each further prime is added
+ * by Garner's step h = t_i * (m_i - m) mod r_i, m = m + h * (r_1 ... r_(i-1)).
+ * The residues are overwritten.
+ */
+static msg rsa_crt_combine(OUT bigint** dst, INOUT bigint** residues, IN const rsa_private_ctx* ctx)
+{
+    msg error_msg = SUCCESS;
+    bigint* h = NULL;
+    bigint* m = NULL;
+    bigint* r = NULL;
+    bigint* quotient = NULL;
+
+    // h = qinv * (m1 - m2) mod p
+    bi_sub(&residues[0], residues[0], residues[1]);
+    while(residues[0]->sign == NEGATIVE)
+    {
+        bi_add(&residues[0], residues[0], ctx->p);
+    }
+    bi_mul(&h, residues[0], ctx->qinv);
+    error_msg = bi_word_division(&quotient, &residues[0], h, ctx->p);
+    if(error_msg == SUCCESS)
+    {
+        // m = m2 + h * q
+        bi_mul(&h, residues[0], ctx->q);
+        error_msg = bi_add(&m, residues[1], h);
+    }
+
+    for(int index = 0; (error_msg == SUCCESS) && (index < ctx->other_num); index++)
+    {
+        const rsa_prime_info* info = &ctx->other[index];
+        bigint** mi = &residues[2 + index];
+
+        // h = t_i * (m_i - m) mod r_i
+        if(bi_word_division(&quotient, &r, m, info->r) == FAILED)
+        {
+            error_msg = FAILED;
+            break;
+        }
+        bi_sub(mi, *mi, r);
+        if((*mi)->sign == NEGATIVE)
+        {
+            bi_add(mi, *mi, info->r);
+        }
+        bi_mul(&h, *mi, info->t);
+        error_msg = bi_word_division(&quotient, mi, h, info->r);
+
+        // m = m + h * (r_1 ... r_(i-1))
+        if(error_msg == SUCCESS)
+        {
+            bi_mul(&h, *mi, info->prod);
+            error_msg = bi_add(&m, m, h);
+        }
+    }
+    if(error_msg == SUCCESS)
+    {
+        error_msg = bi_assign(dst, m);
+    }
+
+    bi_delete(&h);
+    bi_delete(&m);
+    bi_delete(&r);
+    bi_delete(&quotient);
+
+    return error_msg;
+}
+
+/**
+ * @brief Computes `src^d mod n` with the private key context, by CRT when the primes are known.
+ * 
+ * One exponentiation per prime, m1 = src^dp mod p, m2 = src^dq mod q and m_i = src^d_i mod r_i,
+ * recombined by `rsa_crt_combine`.
+ */
+static msg rsa_private_exp(OUT bigint** dst, IN const bigint* src, IN const rsa_private_ctx* ctx)
+{
+    msg error_msg = SUCCESS;
+    bigint* residues[RSA_PRIME_MAX] = {NULL};
+
+    if(ctx->p == NULL)
+    {
+        return bi_mont_exp(dst, src, ctx->d, &ctx->mont_n);
+    }
+
+    if((bi_mont_exp(&residues[0], src, ctx->dp, &ctx->mont_p) == FAILED) || (bi_mont_exp(&residues[1], src, ctx->dq, &ctx->mont_q) == FAILED))
+    {
+        error_msg = FAILED;
+    }
+    for(int index = 0; (error_msg == SUCCESS) && (index < ctx->other_num); index++)
+    {
+        error_msg = bi_mont_exp(&residues[2 + index], src, ctx->other[index].d, &ctx->other[index].mont);
+    }
+    if(error_msg == SUCCESS)
+    {
+        error_msg = rsa_crt_combine(dst, residues, ctx);      //dst may alias src
+    }
+
+    for(int index = 0; index < RSA_PRIME_MAX; index++)
+    {
+        bi_delete(&residues[index]);
+    }
+
+    return error_msg;
+}
+
+/**
+ * @brief Encrypts a message with a public key context: `ciphertext = msg^e mod n`.
+ * 
+ * @param[out] ciphertext Pointer to the bigint that will hold the encrypted message.
+ * @param[in] msg The non-negative message, smaller than n.
+ * @param[in] ctx The public key context.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg rsa_encryption_ctx(OUT bigint** ciphertext, IN const bigint* msg, IN const rsa_public_ctx* ctx)
+{
+    if((ciphertext == NULL) || (msg == NULL) || (ctx == NULL) || (ctx->n == NULL) || (msg->sign == NEGATIVE) ||
+        (bi_compare(msg, ctx->n) >= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    return bi_mont_exp_public(ciphertext, msg, ctx->e, &ctx->mont_n);
+}
+
+/**
+ * @brief Decrypts a ciphertext with a private key context: `msg = ciphertext^d mod n`.
+ * 
+ * @param[out] msg Pointer to the bigint that will hold the decrypted message.
+ * @param[in] ciphertext The non-negative ciphertext, smaller than n.
+ * @param[in] ctx The private key context.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg rsa_decryption_ctx(OUT bigint** msg, IN const bigint* ciphertext, IN const rsa_private_ctx* ctx)
+{
+    if((msg == NULL) || (ciphertext == NULL) || (ctx == NULL) || (ctx->n == NULL) || (ciphertext->sign == NEGATIVE) ||
+        (bi_compare(ciphertext, ctx->n) >= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    return rsa_private_exp(msg, ciphertext, ctx);
+}
+
+/**
+ * @brief Signs a message representative with a private key context: `signature = msg^d mod n`.
+ * 
+ * @param[out] signature Pointer to the bigint that will hold the signature.
+ * @param[in] msg The non-negative message representative, smaller than n.
+ * @param[in] ctx The private key context.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg rsa_sign(OUT bigint** signature, IN const bigint* msg, IN const rsa_private_ctx* ctx)
+{
+    if((signature == NULL) || (msg == NULL) || (ctx == NULL) || (ctx->n == NULL) || (msg->sign == NEGATIVE) ||
+        (bi_compare(msg, ctx->n) >= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    return rsa_private_exp(signature, msg, ctx);
+}
+
+/**
+ * @brief Verifies a signature with a public key context: checks `signature^e mod n == msg`.
+ * 
+ * @param[in] msg The message representative.
+ * @param[in] signature The signature to be checked.
+ * @param[in] ctx The public key context.
+ * 
+ * @return Returns SIGN_VALID (3) or SIGN_INVALID (-3), or -1 on failure.
+ */
+msg rsa_verify(IN const bigint* msg, IN const bigint* signature, IN const rsa_public_ctx* ctx)
+{
+    int result = SIGN_INVALID;
+    bigint* buf = NULL;
+
+    if((msg == NULL) || (signature == NULL) || (ctx == NULL) || (ctx->n == NULL))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    if((signature->sign == NEGATIVE) || (bi_compare(signature, ctx->n) >= 0))
+    {
+        return SIGN_INVALID;
+    }
+
+    if(bi_mont_exp_public(&buf, signature, ctx->e, &ctx->mont_n) == FAILED)
+    {
+        return FAILED;
+    }
+    if(bi_compare(buf, msg) == 0)
+    {
+        result = SIGN_VALID;
+    }
+    bi_delete(&buf);
+
+    return result;
+}
+
+
+/**
+ * @brief Verifies many signatures under one public key.
+ * 
+ * The signatures in range are raised to e together with `bi_mont_exp_public_multi`, which runs
+ * them MONT_LANES at a time on the AVX2 engine; without AVX2 they run one by one as in
+ * `rsa_verify`. Signatures that are negative or not smaller than n are marked invalid without
+ * being exponentiated.
+ * 
+ * @param[out] results Array of `num` results, SIGN_VALID (3) or SIGN_INVALID (-3) per signature.
+ * @param[in] msgs Array of `num` message representatives.
+ * @param[in] signatures Array of `num` signatures to be checked.
+ * @param[in] num The number of signatures.
+ * @param[in] ctx The public key context.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg rsa_verify_batch(OUT int* results, IN bigint* const* msgs, IN bigint* const* signatures, IN int num, IN const rsa_public_ctx* ctx)
+{
+    bigint** checked = NULL;
+    bigint** powers = NULL;
+    const bigint** exps = NULL;
+    const bi_mont_ctx* mont = NULL;
+    int* index = NULL;
+    int checked_num = 0;
+    int error_msg = SUCCESS;
+
+    if((results == NULL) || (msgs == NULL) || (signatures == NULL) || (num < 0) || (ctx == NULL) || (ctx->n == NULL))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    for(int i = 0; i < num; i++)
+    {
+        if((msgs[i] == NULL) || (signatures[i] == NULL))
+        {
+            fprintf(stderr, ERR_INVALID_INPUT);
+            return FAILED;
+        }
+    }
+    if(num == 0)
+    {
+        return SUCCESS;
+    }
+
+    checked = (bigint**)calloc(num, sizeof(bigint*));
+    powers = (bigint**)calloc(num, sizeof(bigint*));
+    exps = (const bigint**)calloc(num, sizeof(const bigint*));
+    index = (int*)calloc(num, sizeof(int));
+    if((checked == NULL) || (powers == NULL) || (exps == NULL) || (index == NULL))
+    {
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        free(checked);
+        free(powers);
+        free(exps);
+        free(index);
+        return FAILED;
+    }
+
+    for(int i = 0; i < num; i++)
+    {
+        results[i] = SIGN_INVALID;
+        if((signatures[i]->sign != NEGATIVE) && (bi_compare(signatures[i], ctx->n) < 0))
+        {
+            checked[checked_num] = signatures[i];
+            exps[checked_num] = ctx->e;
+            index[checked_num++] = i;
+        }
+    }
+
+    mont = &ctx->mont_n;
+    error_msg = bi_mont_exp_public_multi(powers, checked, exps, &mont, 1, checked_num);
+    for(int k = 0; k < checked_num; k++)
+    {
+        if((error_msg == SUCCESS) && (bi_compare(powers[k], msgs[index[k]]) == 0))
+        {
+            results[index[k]] = SIGN_VALID;
+        }
+        bi_delete(&powers[k]);
+    }
+
+    free(checked);
+    free(powers);
+    free(exps);
+    free(index);
+    return error_msg;
+}
+
+/***********************************************
+ * RSA Blinding
+ ***********************************************/
+/**
+ * @brief Sets up an empty blinding state; the first blinded operation draws r.
+ * 
+ * @param[out] blinding Pointer to the state; release it with `rsa_blinding_clear`.
+ * 
+ * @return void
+ */
+void rsa_blinding_init(OUT rsa_blinding* blinding)
+{
+    if(blinding == NULL)
+    {
+        return;
+    }
+    blinding->vi = NULL;
+    blinding->vf = NULL;
+    blinding->remain = 0;
+}
+
+/**
+ * @brief Releases a blinding state (cleared with ZERORIZE).
+ * 
+ * @param[inout] blinding Pointer to the state.
+ * 
+ * @return void
+ */
+void rsa_blinding_clear(INOUT rsa_blinding* blinding)
+{
+    if(blinding == NULL)
+    {
+        return;
+    }
+    bi_delete(&blinding->vi);
+    bi_delete(&blinding->vf);
+    blinding->remain = 0;
+}
+
+/**
+ * @brief Draws a random r invertible modulo n and sets the pair (r^e, r^(-1)) in Montgomery form.
+ */
+static msg rsa_blinding_refresh(INOUT rsa_blinding* blinding, IN const rsa_private_ctx* ctx)
+{
+    msg error_msg = SUCCESS;
+    bigint* one = NULL;
+    bigint* r = NULL;
+    bigint* gcd = NULL;
+    bigint* y = NULL;
+
+    bi_new(&one, 1);
+    one->sign = POSITIVE;
+    one->a[0] = 1;
+
+    do {
+        error_msg = bi_get_random_within_range(&r, one, ctx->n);
+        if(error_msg == SUCCESS)
+        {
+            error_msg = bi_EEA(&gcd, &blinding->vf, &y, r, ctx->n);
+        }
+    }while((error_msg == SUCCESS) && (bi_compare(gcd, one) != 0));
+
+    if((error_msg == SUCCESS) && (blinding->vf->sign == NEGATIVE))
+    {
+        error_msg = bi_add(&blinding->vf, blinding->vf, ctx->n);
+    }
+    if(error_msg == SUCCESS)
+    {
+        error_msg = bi_mont_exp_public(&blinding->vi, r, ctx->e, &ctx->mont_n);
+    }
+    if((error_msg == SUCCESS) && ((bi_mont_to(&blinding->vi, blinding->vi, &ctx->mont_n) == FAILED) ||
+        (bi_mont_to(&blinding->vf, blinding->vf, &ctx->mont_n) == FAILED)))
+    {
+        error_msg = FAILED;
+    }
+    blinding->remain = (error_msg == SUCCESS) ? BLINDING_REFRESH : 0;
+
+    bi_delete(&one);
+    bi_delete(&r);
+    bi_delete(&gcd);
+    bi_delete(&y);
+
+    return error_msg;
+}
+
+/**
+ * @brief Private operation with base blinding: src * r^e is exponentiated and r is divided out.
+ * 
+ * The pair is advanced before it is used, by two Montgomery squarings, or redrawn every
+ * BLINDING_REFRESH operations.
+ */
+static msg rsa_private_exp_blinded(OUT bigint** dst, IN const bigint* src, IN const rsa_private_ctx* ctx, INOUT rsa_blinding* blinding)
+{
+    bigint* blinded = NULL;
+    msg error_msg = SUCCESS;
+
+    if(blinding->remain <= 0)
+    {
+        error_msg = rsa_blinding_refresh(blinding, ctx);
+    }
+    else
+    {
+        // (r^e, r^-1) -> ((r^2)^e, (r^2)^-1)
+        error_msg = ((bi_mont_mul(&blinding->vi, blinding->vi, blinding->vi, &ctx->mont_n) == FAILED) ||
+            (bi_mont_mul(&blinding->vf, blinding->vf, blinding->vf, &ctx->mont_n) == FAILED)) ? FAILED : SUCCESS;
+    }
+    blinding->remain--;
+
+    // (src * r^e)^d * r^-1 = src^d
+    if((error_msg == FAILED) || (bi_mont_mul(&blinded, src, blinding->vi, &ctx->mont_n) == FAILED) ||
+        (rsa_private_exp(&blinded, blinded, ctx) == FAILED) || (bi_mont_mul(dst, blinded, blinding->vf, &ctx->mont_n) == FAILED))
+    {
+        blinding->remain = 0;
+        error_msg = FAILED;
+    }
+    bi_delete(&blinded);
+
+    return error_msg;
+}
+
+/**
+ * @brief Decrypts a ciphertext with a private key context and base blinding.
+ * 
+ * The exponentiation runs on `ciphertext * r^e` for a secret r that changes with every call,
+ * so its timing is not correlated with the ciphertext.
+ * 
+ * @param[out] msg Pointer to the bigint that will hold the decrypted message.
+ * @param[in] ciphertext The non-negative ciphertext, smaller than n.
+ * @param[in] ctx The private key context.
+ * @param[inout] blinding The blinding state of the calling thread for this key.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg rsa_decryption_blinded(OUT bigint** msg, IN const bigint* ciphertext, IN const rsa_private_ctx* ctx, INOUT rsa_blinding* blinding)
+{
+    if((msg == NULL) || (ciphertext == NULL) || (ctx == NULL) || (ctx->n == NULL) || (blinding == NULL) ||
+        (ciphertext->sign == NEGATIVE) || (bi_compare(ciphertext, ctx->n) >= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    return rsa_private_exp_blinded(msg, ciphertext, ctx, blinding);
+}
+
+/**
+ * @brief Signs a message representative with a private key context and base blinding.
+ * 
+ * @param[out] signature Pointer to the bigint that will hold the signature.
+ * @param[in] msg The non-negative message representative, smaller than n.
+ * @param[in] ctx The private key context.
+ * @param[inout] blinding The blinding state of the calling thread for this key.
+ * 
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg rsa_sign_blinded(OUT bigint** signature, IN const bigint* msg, IN const rsa_private_ctx* ctx, INOUT rsa_blinding* blinding)
+{
+    if((signature == NULL) || (msg == NULL) || (ctx == NULL) || (ctx->n == NULL) || (blinding == NULL) ||
+        (msg->sign == NEGATIVE) || (bi_compare(msg, ctx->n) >= 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    return rsa_private_exp_blinded(signature, msg, ctx, blinding);
+}
+
+/***********************************************
+ * RSA Batch Decryption
+ ***********************************************/
+/**
+ * @struct rsa_batch
+ * @brief Shared description of a batch; each task reads item `index` and writes only its own output.
+ */
+typedef struct {
+    bigint** msgs;                          /**< Output array. */
+    int* results;                           /**< Per-item status. */
+    bigint* const* ciphertexts;             /**< Input array. */
+    const rsa_private_ctx* const* ctxs;     /**< One key for all items, or one per item. */
+    int ctx_num;                            /**< 1 or the number of items. */
+    int num;                                /**< Number of items. */
+} rsa_batch;
+
+/**
+ * @brief Task body of `rsa_decryption_batch`: decrypts item `index`.
+ */
+static void rsa_decryption_task(void* arg, int index)
+{
+    rsa_batch* batch = (rsa_batch*)arg;
+    const rsa_private_ctx* ctx = batch->ctxs[(batch->ctx_num == 1) ? 0 : index];
+
+    batch->results[index] = rsa_decryption_ctx(&batch->msgs[index], batch->ciphertexts[index], ctx);
+}
+
+/**
+ * @brief Task body of `rsa_decryption_batch` on the multi-buffer engine: decrypts items
+ * [MONT_LANES * index, MONT_LANES * (index + 1)) under the single key.
+ * 
+ * The exponentiation modulo each prime runs for all items of the group at once with
+ * `bi_mont_exp_multi`; the residues are then recombined item by item.
+ */
+static void rsa_decryption_group_task(void* arg, int index)
+{
+    rsa_batch* batch = (rsa_batch*)arg;
+    const rsa_private_ctx* ctx = batch->ctxs[0];
+    const bi_mont_ctx* monts[RSA_PRIME_MAX] = {&ctx->mont_p, &ctx->mont_q};
+    const bigint* exps[RSA_PRIME_MAX] = {ctx->dp, ctx->dq};
+    bigint* residues[RSA_PRIME_MAX][MONT_LANES] = {{NULL}};
+    bigint* srcs[MONT_LANES];
+    const bigint* lane_exps[MONT_LANES];
+    int items[MONT_LANES];
+    int lane_num = 0;
+    int prime_num = 2 + ctx->other_num;
+    int error_msg = SUCCESS;
+
+    for(int k = 0; k < ctx->other_num; k++)
+    {
+        monts[2 + k] = &ctx->other[k].mont;
+        exps[2 + k] = ctx->other[k].d;
+    }
+    for(int item = MONT_LANES * index; (item < batch->num) && (item < MONT_LANES * (index + 1)); item++)
+    {
+        const bigint* ciphertext = batch->ciphertexts[item];
+
+        if((ciphertext == NULL) || (ciphertext->sign == NEGATIVE) || (bi_compare(ciphertext, ctx->n) >= 0))
+        {
+            fprintf(stderr, ERR_INVALID_INPUT);
+            batch->results[item] = FAILED;
+            continue;
+        }
+        srcs[lane_num] = batch->ciphertexts[item];
+        items[lane_num++] = item;
+    }
+
+    for(int k = 0; (error_msg == SUCCESS) && (k < prime_num); k++)
+    {
+        for(int l = 0; l < lane_num; l++)
+        {
+            lane_exps[l] = exps[k];
+        }
+        error_msg = bi_mont_exp_multi(residues[k], srcs, lane_exps, &monts[k], 1, lane_num);
+    }
+    for(int l = 0; l < lane_num; l++)
+    {
+        bigint* lane_residues[RSA_PRIME_MAX] = {NULL};
+
+        for(int k = 0; k < prime_num; k++)
+        {
+            lane_residues[k] = residues[k][l];
+        }
+        batch->results[items[l]] = (error_msg == SUCCESS) ? rsa_crt_combine(&batch->msgs[items[l]], lane_residues, ctx) : FAILED;
+        for(int k = 0; k < prime_num; k++)
+        {
+            bi_delete(&lane_residues[k]);
+        }
+    }
+}
+
+/**
+ * @brief Decrypts a batch of ciphertexts, under one key or under one key per ciphertext, on a thread pool.
+ * 
+ * Every item is an independent CRT decryption, so the items are spread over the workers of
+ * `pool` and idle workers steal from busy ones. Under a single key with known primes on a CPU
+ * with AVX2, a task instead decrypts MONT_LANES items together on the multi-buffer engine. Item i is written to `msgs[i]`: an entry that
+ * already holds a bigint with capacity for n is reused as the output buffer, a NULL entry is
+ * allocated. The key contexts are only read and may be shared by all items.
+ * 
+ * @param[out] msgs Array of `num` bigint pointers that will hold the decrypted messages.
+ * @param[out] results Array of `num` statuses (1 or -1 per item), or NULL.
+ * @param[in] ciphertexts Array of `num` ciphertexts, each non-negative and smaller than its n.
+ * @param[in] ctxs Array of `ctx_num` private key contexts.
+ * @param[in] ctx_num 1 to decrypt every item with `ctxs[0]`, or `num` for one key per item.
+ * @param[in] num The number of items.
+ * @param[inout] pool The thread pool, or NULL to decrypt on the calling thread.
+ * 
+ * @return Returns 1 if every item was decrypted, -1 otherwise.
+ */
+msg rsa_decryption_batch(OUT bigint** msgs, OUT int* results, IN bigint* const* ciphertexts, IN const rsa_private_ctx* const* ctxs, IN int ctx_num, IN int num, INOUT thread_pool* pool)
+{
+    rsa_batch batch;
+    int* status = results;
+    int error_msg = SUCCESS;
+
+    if((msgs == NULL) || (ciphertexts == NULL) || (ctxs == NULL) || (num < 0) || ((ctx_num != 1) && (ctx_num != num)))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+
+    if(status == NULL)
+    {
+        status = (int*)calloc((num > 0) ? num : 1, sizeof(int));
+        if(status == NULL)
+        {
+            fprintf(stderr, ERR_MEMORY_ALLOCATION);
+            return FAILED;
+        }
+    }
+
+    batch.msgs = msgs;
+    batch.results = status;
+    batch.ciphertexts = ciphertexts;
+    batch.ctxs = ctxs;
+    batch.ctx_num = ctx_num;
+    batch.num = num;
+    if((ctx_num == 1) && (ctxs[0] != NULL) && (ctxs[0]->n != NULL) && (ctxs[0]->p != NULL) && mont_avx2_supported())
+    {
+        error_msg = thread_pool_run(pool, rsa_decryption_group_task, &batch, (num + MONT_LANES - 1) / MONT_LANES);
+    }
+    else
+    {
+        error_msg = thread_pool_run(pool, rsa_decryption_task, &batch, num);
+    }
+    for(int i = 0; (error_msg == SUCCESS) && (i < num); i++)
+    {
+        if(status[i] != SUCCESS)
+        {
+            error_msg = FAILED;
+        }
+    }
+
+    if(status != results)
+    {
+        free(status);
+    }
+    return error_msg;
 }
\ No newline at end of file
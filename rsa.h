@@ -2,15 +2,117 @@
 #define RSA_H
 
 #include "dtype.h"
+#include "params.h"
+#include "montgomery.h"
+#include "threadpool.h"
+
+/**
+ * @struct rsa_public_ctx
+ * @brief RSA public key (e, n) with the Montgomery context of n, set up once per key.
+ *
+ * A context is read-only after `rsa_public_init`, so one context can be shared by threads.
+ */
+typedef struct {
+    bigint* n;              /**< The modulus. */
+    bigint* e;              /**< The public exponent. */
+    bi_mont_ctx mont_n;     /**< Montgomery context of n. */
+} rsa_public_ctx;
+
+/**
+ * @struct rsa_prime_info
+ * @brief One additional prime r_i (i >= 3) of a multi-prime key with its CRT values (RFC 8017 OtherPrimeInfo).
+ */
+typedef struct {
+    bigint* r;              /**< The prime. */
+    bigint* d;              /**< d mod (r - 1). */
+    bigint* t;              /**< (r_1 * ... * r_(i-1))^(-1) mod r. */
+    bigint* prod;           /**< r_1 * ... * r_(i-1). */
+    bi_mont_ctx mont;       /**< Montgomery context of r. */
+} rsa_prime_info;
+
+/**
+ * @struct rsa_private_ctx
+ * @brief RSA private key with the CRT values and Montgomery contexts of its primes.
+ *
+ * p and q are the first two primes; a multi-prime key keeps the others in `other`.
+ * Without the primes only `n`, `e`, `d` and `mont_n` are set and the private operation
+ * falls back to a single exponentiation modulo n. Read-only after `rsa_private_init`.
+ */
+typedef struct {
+    bigint* n;              /**< The modulus. */
+    bigint* e;              /**< The public exponent. */
+    bigint* d;              /**< The private exponent. */
+    bigint* p;              /**< First prime factor, or NULL. */
+    bigint* q;              /**< Second prime factor, or NULL. */
+    bigint* dp;             /**< d mod (p - 1). */
+    bigint* dq;             /**< d mod (q - 1). */
+    bigint* qinv;           /**< q^(-1) mod p. */
+    bi_mont_ctx mont_n;     /**< Montgomery context of n. */
+    bi_mont_ctx mont_p;     /**< Montgomery context of p. */
+    bi_mont_ctx mont_q;     /**< Montgomery context of q. */
+    int other_num;                              /**< Number of primes after p and q. */
+    rsa_prime_info other[RSA_PRIME_MAX - 2];    /**< The primes after p and q. */
+} rsa_private_ctx;
+
+/**
+ * @struct rsa_blinding
+ * @brief Blinding pair for the private operations of one key, kept in Montgomery form modulo n.
+ *
+ * The pair is (r^e, r^(-1)); after every operation both are squared, which gives the pair of
+ * r^2, and every BLINDING_REFRESH operations a fresh random r is drawn. The state changes on
+ * every use, so each thread keeps its own `rsa_blinding` per key (the key context itself
+ * stays shared and read-only).
+ */
+typedef struct {
+    bigint* vi;             /**< r^e * R mod n, multiplied into the input. */
+    bigint* vf;             /**< r^(-1) * R mod n, multiplied into the output. */
+    int remain;             /**< Operations left before a fresh r is drawn. */
+} rsa_blinding;
 
 msg bi_is_composite(IN const bigint* n, IN const bigint* q, IN const bigint* a, IN int l);
 
 msg bi_MillerRabinTest(IN const bigint* src, IN int testnum);
 
+msg bi_MillerRabinTest_u64(IN uint64_t n);
+
+msg bi_MillerRabinTest_u128(IN uint64_t n_hi, IN uint64_t n_lo, IN int testnum);
+
 msg rsa_key_generation(OUT bigint** N, OUT bigint** e, OUT bigint** p, OUT bigint** q, OUT bigint** d, IN int bitlen);
 
+msg rsa_key_generation_multi(OUT bigint** N, OUT bigint** e, OUT bigint** primes, IN int prime_num, OUT bigint** d, IN int bitlen);
+
 msg rsa_encryption(OUT bigint** ciphertext, IN const bigint* msg, IN const bigint* e, IN const bigint* n);
 
 msg rsa_decryption(OUT bigint** msg, IN const bigint* ciphertext, IN const bigint* d, IN const bigint* n);
 
+msg rsa_public_init(OUT rsa_public_ctx* ctx, IN const bigint* e, IN const bigint* n);
+
+void rsa_public_clear(INOUT rsa_public_ctx* ctx);
+
+msg rsa_private_init(OUT rsa_private_ctx* ctx, IN const bigint* n, IN const bigint* e, IN const bigint* d, IN const bigint* p, IN const bigint* q);
+
+msg rsa_private_init_multi(OUT rsa_private_ctx* ctx, IN const bigint* n, IN const bigint* e, IN const bigint* d, IN const bigint* const* primes, IN int prime_num);
+
+void rsa_private_clear(INOUT rsa_private_ctx* ctx);
+
+msg rsa_encryption_ctx(OUT bigint** ciphertext, IN const bigint* msg, IN const rsa_public_ctx* ctx);
+
+msg rsa_decryption_ctx(OUT bigint** msg, IN const bigint* ciphertext, IN const rsa_private_ctx* ctx);
+
+msg rsa_sign(OUT bigint** signature, IN const bigint* msg, IN const rsa_private_ctx* ctx);
+
+msg rsa_verify(IN const bigint* msg, IN const bigint* signature, IN const rsa_public_ctx* ctx);
+
+msg rsa_verify_batch(OUT int* results, IN bigint* const* msgs, IN bigint* const* signatures, IN int num, IN const rsa_public_ctx* ctx);
+
+void rsa_blinding_init(OUT rsa_blinding* blinding);
+
+void rsa_blinding_clear(INOUT rsa_blinding* blinding);
+
+msg rsa_decryption_blinded(OUT bigint** msg, IN const bigint* ciphertext, IN const rsa_private_ctx* ctx, INOUT rsa_blinding* blinding);
+
+msg rsa_sign_blinded(OUT bigint** signature, IN const bigint* msg, IN const rsa_private_ctx* ctx, INOUT rsa_blinding* blinding);
+
+msg rsa_decryption_batch(OUT bigint** msgs, OUT int* results, IN bigint* const* ciphertexts, IN const rsa_private_ctx* const* ctxs, IN int ctx_num, IN int num, INOUT thread_pool* pool);
+
 #endif
\ No newline at end of file
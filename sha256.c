@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "sha256.h"
+#include "params.h"
+#include "dtype.h"
+#include "errormsg.h"
+
+#define ROTR32(x, n)    (((x) >> (n)) | ((x) << (32 - (n))))
+#define SHA_CH(x, y, z)     (((x) & (y)) ^ (~(x) & (z)))
+#define SHA_MAJ(x, y, z)    (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SHA_BSIG0(x)    (ROTR32(x, 2) ^ ROTR32(x, 13) ^ ROTR32(x, 22))
+#define SHA_BSIG1(x)    (ROTR32(x, 6) ^ ROTR32(x, 11) ^ ROTR32(x, 25))
+#define SHA_SSIG0(x)    (ROTR32(x, 7) ^ ROTR32(x, 18) ^ ((x) >> 3))
+#define SHA_SSIG1(x)    (ROTR32(x, 17) ^ ROTR32(x, 19) ^ ((x) >> 10))
+
+//round constants: first 32 bits of the fractional parts of the cube roots of the first 64 primes
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/**
+ * @brief Compresses `block_num` consecutive 64-byte blocks into the chaining value.
+ */
+static void sha256_blocks(INOUT uint32_t* state, IN const byte* src, IN size_t block_num)
+{
+    uint32_t w[64];
+
+    while(block_num-- > 0)
+    {
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for(int i = 0; i < 16; i++)
+        {
+            w[i] = ((uint32_t)src[4 * i] << 24) | ((uint32_t)src[4 * i + 1] << 16) |
+                   ((uint32_t)src[4 * i + 2] << 8) | (uint32_t)src[4 * i + 3];
+        }
+        for(int i = 16; i < 64; i++)
+        {
+            w[i] = SHA_SSIG1(w[i - 2]) + w[i - 7] + SHA_SSIG0(w[i - 15]) + w[i - 16];
+        }
+
+        for(int i = 0; i < 64; i++)
+        {
+            uint32_t t1 = h + SHA_BSIG1(e) + SHA_CH(e, f, g) + sha256_k[i] + w[i];
+            uint32_t t2 = SHA_BSIG0(a) + SHA_MAJ(a, b, c);
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+        src += SHA256_BLOCK_LEN;
+    }
+#if ZERORIZE == 1
+    memset(w, 0, sizeof(w));
+#endif
+}
+
+/**
+ * @brief Starts a SHA-256 computation.
+ *
+ * @param[out] ctx Pointer to the state to be initialized.
+ *
+ * @return void
+ */
+void sha256_init(OUT sha256_ctx* ctx)
+{
+    static const uint32_t iv[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    if(ctx == NULL)
+    {
+        return;
+    }
+    memcpy(ctx->state, iv, sizeof(iv));
+    ctx->total_len = 0;
+    ctx->buf_len = 0;
+}
+
+/**
+ * @brief Feeds bytes into a SHA-256 computation.
+ *
+ * Whole blocks are compressed straight from `src`; only a trailing partial block is buffered.
+ *
+ * @param[inout] ctx Pointer to the state.
+ * @param[in] src Pointer to the input bytes.
+ * @param[in] byte_len The number of input bytes.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg sha256_update(INOUT sha256_ctx* ctx, IN const byte* src, IN size_t byte_len)
+{
+    if((ctx == NULL) || ((src == NULL) && (byte_len > 0)))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    if(byte_len == 0)
+    {
+        return SUCCESS;
+    }
+    ctx->total_len += byte_len;
+
+    if(ctx->buf_len > 0)
+    {
+        size_t len = SHA256_BLOCK_LEN - (size_t)ctx->buf_len;
+
+        len = (len < byte_len) ? len : byte_len;
+        memcpy(ctx->buf + ctx->buf_len, src, len);
+        ctx->buf_len += (int)len;
+        src += len;
+        byte_len -= len;
+        if(ctx->buf_len < SHA256_BLOCK_LEN)
+        {
+            return SUCCESS;
+        }
+        sha256_blocks(ctx->state, ctx->buf, 1);
+        ctx->buf_len = 0;
+    }
+
+    sha256_blocks(ctx->state, src, byte_len / SHA256_BLOCK_LEN);
+    src += byte_len - byte_len % SHA256_BLOCK_LEN;
+    byte_len %= SHA256_BLOCK_LEN;
+    memcpy(ctx->buf, src, byte_len);
+    ctx->buf_len = (int)byte_len;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Pads the message, writes the digest and clears the state.
+ *
+ * @param[out] digest Pointer to the SHA256_DIGEST_LEN output bytes.
+ * @param[inout] ctx Pointer to the state; it must be initialized again before reuse.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg sha256_final(OUT byte* digest, INOUT sha256_ctx* ctx)
+{
+    uint64_t bit_len = 0;
+
+    if((digest == NULL) || (ctx == NULL))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    bit_len = ctx->total_len << 3;
+
+    // 0x80, zeros up to 56 mod 64, then the 64-bit big-endian message length
+    ctx->buf[ctx->buf_len++] = 0x80;
+    if(ctx->buf_len > SHA256_BLOCK_LEN - 8)
+    {
+        memset(ctx->buf + ctx->buf_len, 0, (size_t)(SHA256_BLOCK_LEN - ctx->buf_len));
+        sha256_blocks(ctx->state, ctx->buf, 1);
+        ctx->buf_len = 0;
+    }
+    memset(ctx->buf + ctx->buf_len, 0, (size_t)(SHA256_BLOCK_LEN - 8 - ctx->buf_len));
+    for(int i = 0; i < 8; i++)
+    {
+        ctx->buf[SHA256_BLOCK_LEN - 1 - i] = (byte)(bit_len >> (8 * i));
+    }
+    sha256_blocks(ctx->state, ctx->buf, 1);
+
+    for(int i = 0; i < 8; i++)
+    {
+        digest[4 * i]     = (byte)(ctx->state[i] >> 24);
+        digest[4 * i + 1] = (byte)(ctx->state[i] >> 16);
+        digest[4 * i + 2] = (byte)(ctx->state[i] >> 8);
+        digest[4 * i + 3] = (byte)ctx->state[i];
+    }
+    memset(ctx, 0, sizeof(sha256_ctx));
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Computes the SHA-256 digest of a byte string in one call.
+ *
+ * @param[out] digest Pointer to the SHA256_DIGEST_LEN output bytes.
+ * @param[in] src Pointer to the input bytes.
+ * @param[in] byte_len The number of input bytes.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg sha256(OUT byte* digest, IN const byte* src, IN size_t byte_len)
+{
+    sha256_ctx ctx;
+
+    sha256_init(&ctx);
+    if(sha256_update(&ctx, src, byte_len) == FAILED)
+    {
+        return FAILED;
+    }
+    return sha256_final(digest, &ctx);
+}
@@ -0,0 +1,29 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stddef.h>
+#include "dtype.h"
+
+#define SHA256_DIGEST_LEN   32      //bytes of a digest
+#define SHA256_BLOCK_LEN    64      //bytes of a message block
+
+/**
+ * @struct sha256_ctx
+ * @brief State of an incremental SHA-256 computation (FIPS 180-4).
+ */
+typedef struct {
+    uint32_t state[8];              /**< Chaining value H0 ... H7. */
+    uint64_t total_len;             /**< Bytes processed so far. */
+    byte buf[SHA256_BLOCK_LEN];     /**< Bytes of the incomplete block. */
+    int buf_len;                    /**< Number of bytes in `buf`. */
+} sha256_ctx;
+
+void sha256_init(OUT sha256_ctx* ctx);
+
+msg sha256_update(INOUT sha256_ctx* ctx, IN const byte* src, IN size_t byte_len);
+
+msg sha256_final(OUT byte* digest, INOUT sha256_ctx* ctx);
+
+msg sha256(OUT byte* digest, IN const byte* src, IN size_t byte_len);
+
+#endif
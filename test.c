@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <pthread.h>
 
 #include "bigintfun.h"
 #include "arrayfun.h"
@@ -12,6 +13,13 @@
 #include "operation.h"
 #include "test.h"
 #include "rsa.h"
+#include "montgomery.h"
+#include "mont_avx2.h"
+#include "cpu.h"
+#include "drbg.h"
+#include "sha256.h"
+#include "pkcs1.h"
+#include "mempool.h"
 
 
 /**
@@ -1596,7 +1604,31 @@ void python_mul_k_test(IN const char* filename) {
         bi_delete(&nz_mul);
         bi_delete(&zp_mul);
         bi_delete(&zz_mul);
-    }   
+    }
+
+    // operands above KARA_FLAG_MUL, so that bi_mul_k recurses (unbalanced lengths included)
+    for (int i = 0; i < TESTNUM_kara; i++) {
+        bigint *a = NULL;
+        bi_get_random(&a, (rand() % 2) ? POSITIVE : NEGATIVE, KARA_FLAG_MUL + 1 + rand() % (T_KARA_WORD_SIZE - KARA_FLAG_MUL));
+        bigint *b = NULL;
+        bi_get_random(&b, (rand() % 2) ? POSITIVE : NEGATIVE, KARA_FLAG_MUL + 1 + rand() % (T_KARA_WORD_SIZE - KARA_FLAG_MUL));
+
+        bigint *ab_mul = NULL;
+        bi_mul_kara(&ab_mul, a, b);
+
+        fprintf(file, "a = ");
+        bi_fprint(file,a);
+        fprintf(file, "b = ");
+        bi_fprint(file,b);
+        fprintf(file, "ab_mul = ");
+        bi_fprint(file,ab_mul);
+
+        fprintf(file, "if (a * b != ab_mul):\n \t print(f\"[kara_mul]: {a:#x} * {b:#x} != {ab_mul:#x}\\n\")\n");
+
+        bi_delete(&a);
+        bi_delete(&b);
+        bi_delete(&ab_mul);
+    }
     fclose(file);
 }
 
@@ -2217,7 +2249,26 @@ void python_squ_k_test(IN const char* filename) {
         bi_delete(&neg_b);
         bi_delete(&p_squ);
         bi_delete(&n_squ);
-    }   
+    }
+
+    // operands above KARA_FLAG_SQU, so that bi_squ_kara recurses
+    for (int i = 0; i < TESTNUM_kara; i++) {
+        bigint *a = NULL;
+        bi_get_random(&a, (rand() % 2) ? POSITIVE : NEGATIVE, KARA_FLAG_SQU + 1 + rand() % (T_KARA_WORD_SIZE - KARA_FLAG_SQU));
+
+        bigint *a_squ = NULL;
+        bi_squ_kara(&a_squ, a);
+
+        fprintf(file, "a = ");
+        bi_fprint(file,a);
+        fprintf(file, "a_squ = ");
+        bi_fprint(file,a_squ);
+
+        fprintf(file, "if (a * a != a_squ):\n \t print(f\"[kara_squ]: {a:#x} ^ 2 != {a_squ:#x}\\n\")\n\n");
+
+        bi_delete(&a);
+        bi_delete(&a_squ);
+    }
     fclose(file);
 }
 
@@ -2608,4 +2659,1534 @@ void python_rsa_enc_dec_test(IN const char* filename)
     bi_delete(&c);
     bi_delete(&msg_buf);
     bi_delete(&zero);
+}
+
+/**
+ * @brief Test function for the small-number primality test using Python-generated test data.
+ * 
+ * This function tests the allocation-free Miller-Rabin path for numbers of at most
+ * 128 bits. Random odd numbers of 1 to 128 bits are tested and the results are
+ * checked against sympy's isprime.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_small_prime_test(IN const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+
+    fprintf(file, "from sympy import isprime\n\n");
+    for (int i = 0; i < TESTNUM; i++) {
+        bigint* n = NULL;
+        msg result = 0;
+
+        bi_get_random(&n, POSITIVE, rand() % (128 / SIZEOFWORD) + 1);
+        bi_bit_rshift(n, rand() % SIZEOFWORD);
+        if(n->sign == ZERO)
+        {
+            bi_delete(&n);
+            continue;
+        }
+        n->a[0] |= 1;
+        result = bi_MillerRabinTest(n, MILLER_NUM);
+
+        fprintf(file, "n = ");
+        bi_fprint(file, n);
+        fprintf(file, "result = %d\n", (result == PROBABLY_PRIME) ? 1 : 0);
+        fprintf(file, "if (isprime(n) != result):\n \t print(f\"[small_prime]: {n:#x} -> {result}\")\n");
+
+        bi_delete(&n);
+    }
+    fclose(file);
+}
+
+/**
+ * @brief Test function for byte-string import and export using Python-generated test data.
+ * 
+ * Random bigints are exported with `bi_get_bytes` into buffers of up to three bytes more
+ * than needed, in big- or little-endian order, and imported back with `bi_set_from_bytes`;
+ * Python checks the bytes with int.from_bytes.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_bytes_test(IN const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+
+    for (int i = 0; i < TESTNUM; i++) {
+        bigint* src = NULL;
+        bigint* dst = NULL;
+        byte* buf = NULL;
+        int byte_len = 0;
+        int order = rand() % 2;
+
+        bi_get_random(&src, POSITIVE, rand() % T_TEST_DATA_WORD_SIZE + 1);
+        bi_bit_rshift(src, rand() % SIZEOFWORD);
+        byte_len = bi_get_byte_len(src) + rand() % 4;
+        buf = (byte*)calloc(byte_len + 1, sizeof(byte));
+        if(buf == NULL)
+        {
+            bi_delete(&src);
+            break;
+        }
+        bi_get_bytes(buf, byte_len, src, order);
+        bi_set_from_bytes(&dst, buf, byte_len, order);
+
+        fprintf(file, "n = ");
+        bi_fprint(file, src);
+        fprintf(file, "s = bytes.fromhex(\"");
+        for(int j = 0; j < byte_len; j++)
+        {
+            fprintf(file, "%02x", buf[j]);
+        }
+        fprintf(file, "\")\n");
+        fprintf(file, "result = %d\n", (bi_compare(src, dst) == 0) ? 1 : 0);
+        fprintf(file, "if (len(s) != %d or int.from_bytes(s, \"%s\") != n or result != 1):\n \t print(f\"[bytes]: {n:#x} -> {s.hex()}\")\n", byte_len, (order == BYTES_BIG) ? "big" : "little");
+
+        free(buf);
+        bi_delete(&src);
+        bi_delete(&dst);
+    }
+    fclose(file);
+}
+
+/**
+ * @brief Test function for decimal formatting and parsing using Python-generated test data.
+ * 
+ * Random signed bigints are written with `bi_dec_encode` and read back with `bi_set_from_string`;
+ * Python checks the digits with int(). Every 100th case has DEC_DC_FLAG to 4 * DEC_DC_FLAG words,
+ * so both directions run the divide and conquer conversion through several levels.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_dec_test(IN const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+
+    fprintf(file, "import sys\n\nif hasattr(sys, \"set_int_max_str_digits\"):\n \t sys.set_int_max_str_digits(0)\n\n");
+    for (int i = 0; i < TESTNUM; i++) {
+        bigint* src = NULL;
+        bigint* dst = NULL;
+        char* buf = NULL;
+        int buf_len = 0;
+
+        int word_len = (i % 100 == 0) ? rand() % (3 * DEC_DC_FLAG) + DEC_DC_FLAG : rand() % T_TEST_DATA_WORD_SIZE + 1;
+
+        bi_get_random(&src, (rand() % 2) ? POSITIVE : NEGATIVE, word_len);
+        buf_len = (int)((uint64_t)SIZEOFWORD * src->word_len * 30103 / 100000 + 3);
+        buf = (char*)calloc(buf_len, sizeof(char));
+        if(buf == NULL)
+        {
+            bi_delete(&src);
+            break;
+        }
+        if(src->sign == NEGATIVE)
+        {
+            buf[0] = '-';
+        }
+        bi_dec_encode(buf + (src->sign == NEGATIVE), buf_len - 1, src);
+        bi_set_from_string(&dst, buf, 10);
+
+        fprintf(file, "n = ");
+        bi_fprint(file, src);
+        fprintf(file, "s = \"%s\"\n", buf);
+        fprintf(file, "result = %d\n", (bi_compare(src, dst) == 0) ? 1 : 0);
+        fprintf(file, "if (int(s) != n or result != 1):\n \t print(f\"[dec]: {n:#x} -> {s}\")\n");
+
+        free(buf);
+        bi_delete(&src);
+        bi_delete(&dst);
+    }
+    fclose(file);
+}
+
+
+
+/**
+ * @brief Test function for Montgomery modular exponentiation using Python data.
+ * 
+ * Every other case uses a modulus of 1024, 2048, 3072 or 4096 bits so that the
+ * fixed-size kernels are checked as well as the generic one.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_mont_exp_test(IN const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+
+    for (int i = 0; i < TESTNUM_modexp; i++) {
+        int mod_len = (i % 2 == 0) ? ((i / 2) % 4 + 1) * 1024 / SIZEOFWORD : rand() % T_TEST_DATA_WORD_SIZE + 1;
+
+        bigint *base = NULL;
+        bi_get_random(&base, POSITIVE, rand() % (mod_len + 1) + 1);
+        bigint *exp = NULL;
+        bi_get_random(&exp, POSITIVE, rand() % T_TEST_DATA_WORD_SIZE + 1);
+        bigint *mod = NULL;
+        bi_get_random(&mod, POSITIVE, mod_len);
+        mod->a[0] |= 1;
+
+        bigint *mod_exp_result = NULL;
+        bi_mod_exp_mont(&mod_exp_result, base, exp, mod);
+
+        fprintf(file, "base = ");
+        bi_fprint(file,base);
+        fprintf(file, "exp = ");
+        bi_fprint(file,exp);
+
+        fprintf(file, "mod = ");
+        bi_fprint(file,mod);
+        fprintf(file, "mod_exp_result = ");
+        bi_fprint(file,mod_exp_result);
+
+        fprintf(file, "temp = pow(base, exp, mod)\n");
+        fprintf(file, "if (mod_exp_result != temp):\n \t print(f\"[mont]: {base:#x} ^ {exp:#x} mod {mod:#x} != {mod_exp_result:#x}\\n\")\n\n");
+
+        bi_delete(&base);
+        bi_delete(&exp);
+        bi_delete(&mod);
+        bi_delete(&mod_exp_result);
+    }
+    fclose(file);
+}
+
+
+
+/**
+ * @brief Test function for in-place arithmetic using Python data.
+ * 
+ * The result of every operation is stored in one of its own operands
+ * (`bi_add(&x, x, y)` and the like), so the aliasing paths are checked.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_inplace_test(IN const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+
+    for (int i = 0; i < TESTNUM; i++) {
+        bigint *a = NULL;
+        bi_get_random(&a, (rand() % 2) ? POSITIVE : NEGATIVE, rand() % T_TEST_DATA_WORD_SIZE + 1);
+        bigint *b = NULL;
+        bi_get_random(&b, (rand() % 2) ? POSITIVE : NEGATIVE, rand() % T_TEST_DATA_WORD_SIZE + 1);
+        word w = 0;
+        if (array_rand(&w, 1) == FAILED) {
+            fprintf(file, "print(\"[inplace] array_rand failed\\n\")\n");
+            bi_delete(&a);
+            bi_delete(&b);
+            break;
+        }
+
+        bigint *x = NULL;
+        bigint *y = NULL;
+
+        fprintf(file, "a = ");
+        bi_fprint(file, a);
+        fprintf(file, "b = ");
+        bi_fprint(file, b);
+        fprintf(file, "w = %#llx\n", (unsigned long long)w);
+
+        bi_assign(&x, a);
+        bi_add(&x, x, b);
+        fprintf(file, "add_1 = ");
+        bi_fprint(file, x);
+        bi_assign(&y, b);
+        bi_add(&y, a, y);
+        fprintf(file, "add_2 = ");
+        bi_fprint(file, y);
+        bi_add(&y, y, y);
+        fprintf(file, "add_3 = ");
+        bi_fprint(file, y);
+
+        bi_assign(&x, a);
+        bi_sub(&x, x, b);
+        fprintf(file, "sub_1 = ");
+        bi_fprint(file, x);
+        bi_assign(&y, b);
+        bi_sub(&y, a, y);
+        fprintf(file, "sub_2 = ");
+        bi_fprint(file, y);
+        bi_sub(&y, y, y);
+        fprintf(file, "sub_3 = ");
+        bi_fprint(file, y);
+
+        bi_assign(&x, a);
+        bi_neg(&x, x);
+        fprintf(file, "neg = ");
+        bi_fprint(file, x);
+
+        bi_assign(&x, a);
+        bi_mul_word(&x, x, w);
+        fprintf(file, "mul_word = ");
+        bi_fprint(file, x);
+
+        bi_assign(&x, a);
+        bi_mul(&x, x, b);
+        fprintf(file, "mul = ");
+        bi_fprint(file, x);
+
+        fprintf(file, "if (add_1 != a + b) or (add_2 != a + b) or (add_3 != 2 * (a + b)):\n \t print(f\"[inplace add]: {a:#x} + {b:#x}\\n\")\n");
+        fprintf(file, "if (sub_1 != a - b) or (sub_2 != a - b) or (sub_3 != 0):\n \t print(f\"[inplace sub]: {a:#x} - {b:#x}\\n\")\n");
+        fprintf(file, "if (neg != -a):\n \t print(f\"[inplace neg]: -{a:#x} != {neg:#x}\\n\")\n");
+        fprintf(file, "if (mul_word != a * w):\n \t print(f\"[inplace mul_word]: {a:#x} * {w:#x} != {mul_word:#x}\\n\")\n");
+        fprintf(file, "if (mul != a * b):\n \t print(f\"[inplace mul]: {a:#x} * {b:#x} != {mul:#x}\\n\")\n\n");
+
+        bi_delete(&a);
+        bi_delete(&b);
+        bi_delete(&x);
+        bi_delete(&y);
+    }
+    fclose(file);
+}
+
+
+
+/**
+ * @brief Test function for the RSA key contexts (CRT decryption, sign and verify) using Python data.
+ * 
+ * Reads the keys of rsa_2048_params.txt and checks, for several messages per key, that the
+ * context operations (plain and blinded) agree with pow() and that a signature fails to verify
+ * for another message.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_rsa_ctx_test(IN const char* filename)
+{
+    bigint* n = NULL; bigint* e = NULL; bigint* p = NULL;
+    bigint* q = NULL; bigint* d = NULL; bigint* msg = NULL;
+    bigint* c = NULL; bigint* msg_buf = NULL; bigint* sig = NULL;
+    bigint* zero = NULL; bigint* one = NULL;
+    rsa_public_ctx pub;
+    rsa_private_ctx priv;
+    rsa_blinding blinding;
+    bigint* msg_blind = NULL; bigint* sig_blind = NULL;
+
+    bi_new(&zero, 1);
+    bi_new(&one, 1);
+    one->sign = POSITIVE;
+    one->a[0] = 1;
+    char buffer[1024];
+    char n_string[1024];
+    char e_string[1024];
+    char p_string[1024];
+    char q_string[1024];
+    char d_string[1024];
+
+    FILE* python_file = NULL;
+    FILE* rsa_param_file = NULL;
+
+    python_file = fopen(filename, "w");
+    if(python_file == NULL)
+    {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+    rsa_param_file = fopen("rsa_2048_params.txt", "r");
+    if (rsa_param_file == NULL) {
+        perror("FILE OPEN ERROR");
+        fclose(python_file);
+        return;
+    }
+    while ((fgets(buffer, sizeof(buffer), rsa_param_file) != NULL) && (sscanf(buffer, "n = 0x%s", n_string) == 1))
+    {
+        if ((fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "e = 0x%s", e_string) != 1) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "p = 0x%s", p_string) != 1) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "q = 0x%s", q_string) != 1) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "d = 0x%s", d_string) != 1)) {
+            perror("Error reading from file");
+            break;
+        }
+
+        bi_set_from_string(&n, n_string, 16);
+        bi_set_from_string(&e, e_string, 16);
+        bi_set_from_string(&p, p_string, 16);
+        bi_set_from_string(&q, q_string, 16);
+        bi_set_from_string(&d, d_string, 16);
+
+        rsa_public_init(&pub, e, n);
+        rsa_private_init(&priv, n, e, d, p, q);
+        rsa_blinding_init(&blinding);
+
+        fprintf(python_file, "n = ");
+        bi_fprint(python_file,n);
+        fprintf(python_file, "e = ");
+        bi_fprint(python_file,e);
+        fprintf(python_file, "d = ");
+        bi_fprint(python_file,d);
+
+        //enough operations per key to square the blinding pair and draw a fresh one
+        for (int testnum = 0; testnum < BLINDING_REFRESH + 8; testnum++)
+        {
+            bi_get_random_within_range(&msg, zero, n);
+            rsa_encryption_ctx(&c, msg, &pub);
+            rsa_decryption_ctx(&msg_buf, c, &priv);
+            rsa_sign(&sig, msg, &priv);
+            rsa_decryption_blinded(&msg_blind, c, &priv, &blinding);
+            rsa_sign_blinded(&sig_blind, msg, &priv, &blinding);
+            int valid = rsa_verify(msg, sig, &pub);
+            bi_add(&msg, msg, one);
+            int invalid = rsa_verify(msg, sig, &pub);
+            bi_sub(&msg, msg, one);
+
+            fprintf(python_file, "msg = ");
+            bi_fprint(python_file,msg);
+            fprintf(python_file, "c = ");
+            bi_fprint(python_file,c);
+            fprintf(python_file, "msg_buf = ");
+            bi_fprint(python_file,msg_buf);
+            fprintf(python_file, "sig = ");
+            bi_fprint(python_file,sig);
+            fprintf(python_file, "msg_blind = ");
+            bi_fprint(python_file,msg_blind);
+            fprintf(python_file, "sig_blind = ");
+            bi_fprint(python_file,sig_blind);
+            fprintf(python_file, "if (c != pow(msg, e, n)) or (msg_buf != msg):\n \t print(f\"[rsa ctx] : enc/dec {msg:#x}\")\n");
+            fprintf(python_file, "if (sig != pow(msg, d, n)):\n \t print(f\"[rsa ctx] : sign {msg:#x}\")\n");
+            fprintf(python_file, "if (msg_blind != msg) or (sig_blind != sig):\n \t print(f\"[rsa ctx] : blinded {msg:#x}\")\n");
+            fprintf(python_file, "if (%d != %d) or (%d != %d):\n \t print(f\"[rsa ctx] : verify {msg:#x}\")\n", valid, SIGN_VALID, invalid, SIGN_INVALID);
+        }
+
+        rsa_public_clear(&pub);
+        rsa_private_clear(&priv);
+        rsa_blinding_clear(&blinding);
+    }
+    fclose(python_file);
+    fclose(rsa_param_file);
+
+    bi_delete(&n);
+    bi_delete(&e);
+    bi_delete(&p);
+    bi_delete(&q);
+    bi_delete(&d);
+    bi_delete(&msg);
+    bi_delete(&c);
+    bi_delete(&msg_buf);
+    bi_delete(&sig);
+    bi_delete(&msg_blind);
+    bi_delete(&sig_blind);
+    bi_delete(&zero);
+    bi_delete(&one);
+}
+
+/**
+ * @brief Tests batch RSA decryption on a thread pool against Python pow().
+ * 
+ * Decrypts one batch with a different key per item (all keys of rsa_2048_params.txt) and
+ * one batch under a single key into preallocated outputs, on a pool of four threads.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_rsa_batch_test(IN const char* filename)
+{
+    enum {KEY_MAX = 16, BATCH_NUM = 64};
+    bigint* n[KEY_MAX] = {NULL}; bigint* e[KEY_MAX] = {NULL}; bigint* d[KEY_MAX] = {NULL};
+    bigint* p = NULL; bigint* q = NULL; bigint* zero = NULL;
+    bigint* msgs[BATCH_NUM] = {NULL}; bigint* cts[BATCH_NUM] = {NULL}; bigint* outs[BATCH_NUM] = {NULL};
+    rsa_private_ctx keys[KEY_MAX];
+    const rsa_private_ctx* ctxs[BATCH_NUM];
+    int results[BATCH_NUM];
+    int key_num = 0;
+    thread_pool* pool = NULL;
+
+    bi_new(&zero, 1);
+    char buffer[1024];
+    char n_string[1024];
+    char e_string[1024];
+    char p_string[1024];
+    char q_string[1024];
+    char d_string[1024];
+
+    FILE* python_file = NULL;
+    FILE* rsa_param_file = NULL;
+
+    python_file = fopen(filename, "w");
+    if(python_file == NULL)
+    {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+    rsa_param_file = fopen("rsa_2048_params.txt", "r");
+    if (rsa_param_file == NULL) {
+        perror("FILE OPEN ERROR");
+        fclose(python_file);
+        return;
+    }
+    while ((key_num < KEY_MAX) && (fgets(buffer, sizeof(buffer), rsa_param_file) != NULL) && (sscanf(buffer, "n = 0x%s", n_string) == 1))
+    {
+        if ((fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "e = 0x%s", e_string) != 1) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "p = 0x%s", p_string) != 1) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "q = 0x%s", q_string) != 1) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "d = 0x%s", d_string) != 1)) {
+            perror("Error reading from file");
+            break;
+        }
+
+        bi_set_from_string(&n[key_num], n_string, 16);
+        bi_set_from_string(&e[key_num], e_string, 16);
+        bi_set_from_string(&p, p_string, 16);
+        bi_set_from_string(&q, q_string, 16);
+        bi_set_from_string(&d[key_num], d_string, 16);
+        rsa_private_init(&keys[key_num], n[key_num], e[key_num], d[key_num], p, q);
+
+        fprintf(python_file, "n%d = ", key_num);
+        bi_fprint(python_file,n[key_num]);
+        key_num++;
+    }
+    fclose(rsa_param_file);
+
+    if ((key_num > 0) && (thread_pool_create(&pool, 4) == SUCCESS))
+    {
+        //mixed keys: item i uses key i mod key_num
+        for (int i = 0; i < BATCH_NUM; i++)
+        {
+            ctxs[i] = &keys[i % key_num];
+            bi_get_random_within_range(&msgs[i], zero, n[i % key_num]);
+            rsa_encryption(&cts[i], msgs[i], e[i % key_num], n[i % key_num]);
+        }
+        int batch_result = rsa_decryption_batch(outs, results, cts, ctxs, BATCH_NUM, BATCH_NUM, pool);
+        fprintf(python_file, "if %d != 1:\n \t print(\"[rsa batch] : mixed keys status\")\n", batch_result);
+        for (int i = 0; i < BATCH_NUM; i++)
+        {
+            fprintf(python_file, "msg = ");
+            bi_fprint(python_file,msgs[i]);
+            fprintf(python_file, "out = ");
+            bi_fprint(python_file,outs[i]);
+            fprintf(python_file, "if (out != msg) or (%d != 1):\n \t print(f\"[rsa batch] : mixed keys {msg:#x} mod {n%d:#x}\")\n", results[i], i % key_num);
+        }
+
+        //single key, outputs preallocated by the caller
+        for (int i = 0; i < BATCH_NUM; i++)
+        {
+            bi_get_random_within_range(&msgs[i], zero, n[0]);
+            rsa_encryption(&cts[i], msgs[i], e[0], n[0]);
+            bi_new(&outs[i], n[0]->word_len);
+        }
+        batch_result = rsa_decryption_batch(outs, NULL, cts, ctxs, 1, BATCH_NUM, pool);
+        fprintf(python_file, "if %d != 1:\n \t print(\"[rsa batch] : single key status\")\n", batch_result);
+        for (int i = 0; i < BATCH_NUM; i++)
+        {
+            fprintf(python_file, "msg = ");
+            bi_fprint(python_file,msgs[i]);
+            fprintf(python_file, "out = ");
+            bi_fprint(python_file,outs[i]);
+            fprintf(python_file, "if out != msg:\n \t print(f\"[rsa batch] : single key {msg:#x}\")\n");
+        }
+        thread_pool_destroy(&pool);
+    }
+    fclose(python_file);
+
+    for (int i = 0; i < key_num; i++)
+    {
+        rsa_private_clear(&keys[i]);
+        bi_delete(&n[i]);
+        bi_delete(&e[i]);
+        bi_delete(&d[i]);
+    }
+    for (int i = 0; i < BATCH_NUM; i++)
+    {
+        bi_delete(&msgs[i]);
+        bi_delete(&cts[i]);
+        bi_delete(&outs[i]);
+    }
+    bi_delete(&p);
+    bi_delete(&q);
+    bi_delete(&zero);
+}
+
+/**
+ * @brief Tests multi-prime RSA key generation and the generalized CRT private operation.
+ * 
+ * For every prime count from 2 to RSA_PRIME_MAX, generates `testnum` keys and checks with
+ * Python that the primes are distinct primes with product n of the requested bit length and
+ * that e * d = 1 mod phi(n); decryption (plain and blinded) and signing with the key context
+ * are checked against pow().
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * @param[in] testnum The number of keys per prime count.
+ * 
+ * @return void
+ */
+void python_rsa_multi_prime_test(IN const char* filename, IN int testnum)
+{
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+    bigint* zero = NULL;
+    bi_new(&zero, 1);
+
+    fprintf(file, "from sympy import isprime\n\n");
+    for (int prime_num = 2; prime_num <= RSA_PRIME_MAX; prime_num++) {
+        for (int i = 0; i < testnum; i++) {
+            bigint* n = NULL; bigint* e = NULL; bigint* d = NULL;
+            bigint* primes[RSA_PRIME_MAX] = {NULL};
+            bigint* msg = NULL; bigint* c = NULL; bigint* msg_buf = NULL;
+            bigint* sig = NULL; bigint* msg_blind = NULL;
+            rsa_private_ctx priv;
+            rsa_blinding blinding;
+
+            int bit_len = T_TEST_DATA_WORD_SIZE * SIZEOFWORD + 2 * i;   //also bit lengths not divisible by the prime count
+
+            rsa_key_generation_multi(&n, &e, primes, prime_num, &d, bit_len);
+            rsa_private_init_multi(&priv, n, e, d, (const bigint* const*)primes, prime_num);
+            rsa_blinding_init(&blinding);
+
+            fprintf(file, "n = ");
+            bi_fprint(file,n);
+            fprintf(file, "e = ");
+            bi_fprint(file,e);
+            fprintf(file, "d = ");
+            bi_fprint(file,d);
+            fprintf(file, "primes = []\n");
+            for (int j = 0; j < prime_num; j++) {
+                fprintf(file, "primes.append(");
+                bi_fprint(file,primes[j]);
+                fprintf(file, ")\n");
+            }
+            fprintf(file, "prod = 1\nphi_n = 1\n");
+            fprintf(file, "for r in primes:\n\t prod *= r\n\t phi_n *= r - 1\n");
+            fprintf(file, "if (len(set(primes)) != %d) or (prod != n) or (n.bit_length() != %d):\n \t print(f\"[rsa multi] : key {n:#x}\")\n", prime_num, bit_len);
+            fprintf(file, "if not all(isprime(r) for r in primes):\n \t print(f\"[rsa multi] : not prime {primes}\")\n");
+            fprintf(file, "if (((e * d) %% phi_n) != 1):\n \t print(f\"[rsa multi] : ({e:#x} x {d:#x} mod {phi_n:#x}) != 1)\")\n");
+
+            for (int testcase = 0; testcase < 4; testcase++) {
+                bi_get_random_within_range(&msg, zero, n);
+                rsa_encryption(&c, msg, e, n);
+                rsa_decryption_ctx(&msg_buf, c, &priv);
+                rsa_decryption_blinded(&msg_blind, c, &priv, &blinding);
+                rsa_sign(&sig, msg, &priv);
+
+                fprintf(file, "msg = ");
+                bi_fprint(file,msg);
+                fprintf(file, "msg_buf = ");
+                bi_fprint(file,msg_buf);
+                fprintf(file, "msg_blind = ");
+                bi_fprint(file,msg_blind);
+                fprintf(file, "sig = ");
+                bi_fprint(file,sig);
+                fprintf(file, "if (msg_buf != msg) or (msg_blind != msg):\n \t print(f\"[rsa multi] : dec {msg:#x} with %d primes\")\n", prime_num);
+                fprintf(file, "if (sig != pow(msg, d, n)):\n \t print(f\"[rsa multi] : sign {msg:#x} with %d primes\")\n", prime_num);
+            }
+
+            rsa_private_clear(&priv);
+            rsa_blinding_clear(&blinding);
+            bi_delete(&n);
+            bi_delete(&e);
+            bi_delete(&d);
+            for (int j = 0; j < prime_num; j++) {
+                bi_delete(&primes[j]);
+            }
+            bi_delete(&msg);
+            bi_delete(&c);
+            bi_delete(&msg_buf);
+            bi_delete(&sig);
+            bi_delete(&msg_blind);
+        }
+    }
+    fclose(file);
+    bi_delete(&zero);
+}
+
+/**
+ * @brief Writes a byte string to the Python file as `name = bytes.fromhex("...")`.
+ */
+static void fprint_bytes(IN FILE* file, IN const char* name, IN const byte* src, IN int byte_len)
+{
+    fprintf(file, "%s = bytes.fromhex(\"", name);
+    for (int i = 0; i < byte_len; i++) {
+        fprintf(file, "%02x", src[i]);
+    }
+    fprintf(file, "\")\n");
+}
+
+/**
+ * @brief Tests SHA-256 against Python hashlib.
+ * 
+ * Hashes random messages of every length up to three blocks and some longer ones, in one
+ * call and fed in random pieces, and compares both digests with hashlib.sha256.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_sha256_test(IN const char* filename)
+{
+    enum {DATA_MAX = 4096};
+    static const int long_lens[] = {1000, 1023, 1024, 1025, 4096};
+    byte* data = (byte*)malloc(DATA_MAX);
+    byte digest[SHA256_DIGEST_LEN];
+    byte digest_inc[SHA256_DIGEST_LEN];
+    sha256_ctx ctx;
+
+    FILE* file = fopen(filename, "w");
+    if ((file == NULL) || (data == NULL)) {
+        perror("FILE OPEN ERROR");
+        free(data);
+        if (file != NULL) {
+            fclose(file);
+        }
+        return;
+    }
+    fprintf(file, "import hashlib\n\n");
+
+    for (int testnum = 0; testnum < 3 * SHA256_BLOCK_LEN + 1 + 5; testnum++) {
+        int len = (testnum <= 3 * SHA256_BLOCK_LEN) ? testnum : long_lens[testnum - 3 * SHA256_BLOCK_LEN - 1];
+
+        drbg_bytes(data, len);
+        sha256(digest, data, len);
+        sha256_init(&ctx);
+        for (int pos = 0; pos < len; ) {
+            int piece = rand() % 100;
+            piece = (piece < len - pos) ? piece : len - pos;
+            sha256_update(&ctx, data + pos, piece);
+            pos += piece;
+        }
+        sha256_final(digest_inc, &ctx);
+
+        fprint_bytes(file, "data", data, len);
+        fprint_bytes(file, "digest", digest, SHA256_DIGEST_LEN);
+        fprint_bytes(file, "digest_inc", digest_inc, SHA256_DIGEST_LEN);
+        fprintf(file, "if (hashlib.sha256(data).digest() != digest) or (digest_inc != digest):\n \t print(f\"[sha256] : length %d\")\n", len);
+    }
+    fclose(file);
+    free(data);
+}
+
+/**
+ * @brief Tests RSA-OAEP and RSA-PSS against an independent Python encoding (RFC 8017, SHA-256).
+ * 
+ * For keys of rsa_2048_params.txt, the Python file decodes the OAEP ciphertexts with pow()
+ * and checks the PSS signatures with its own MGF1; the C decryption and verification of the
+ * same data, and the rejection of a changed message, are checked too.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_pkcs1_test(IN const char* filename)
+{
+    bigint* n = NULL; bigint* e = NULL; bigint* d = NULL;
+    byte message[256];
+    byte label[16];
+    byte out[512];
+    byte decrypted[512];
+    char buffer[1024];
+    char n_string[1024];
+    char e_string[1024];
+    char d_string[1024];
+    int key_num = 0;
+
+    FILE* python_file = NULL;
+    FILE* rsa_param_file = NULL;
+
+    python_file = fopen(filename, "w");
+    if(python_file == NULL)
+    {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+    rsa_param_file = fopen("rsa_2048_params.txt", "r");
+    if (rsa_param_file == NULL) {
+        perror("FILE OPEN ERROR");
+        fclose(python_file);
+        return;
+    }
+
+    fprintf(python_file, "import hashlib\n\n");
+    fprintf(python_file, "def mgf1(seed, length):\n");
+    fprintf(python_file, "\t out = b\"\"\n");
+    fprintf(python_file, "\t for i in range((length + 31) // 32):\n");
+    fprintf(python_file, "\t\t out += hashlib.sha256(seed + i.to_bytes(4, \"big\")).digest()\n");
+    fprintf(python_file, "\t return out[:length]\n\n");
+    fprintf(python_file, "def xor(a, b):\n\t return bytes(x ^ y for x, y in zip(a, b))\n\n");
+    fprintf(python_file, "def oaep_decode(em, label):\n");
+    fprintf(python_file, "\t seed = xor(em[1:33], mgf1(em[33:], 32))\n");
+    fprintf(python_file, "\t db = xor(em[33:], mgf1(seed, len(em) - 33))\n");
+    fprintf(python_file, "\t if em[0] != 0 or db[:32] != hashlib.sha256(label).digest():\n\t\t return None\n");
+    fprintf(python_file, "\t rest = db[32:].lstrip(b\"\\x00\")\n");
+    fprintf(python_file, "\t return rest[1:] if rest[:1] == b\"\\x01\" else None\n\n");
+    fprintf(python_file, "def pss_verify(message, sig, e, n):\n");
+    fprintf(python_file, "\t em_bits = n.bit_length() - 1\n");
+    fprintf(python_file, "\t em_len = (em_bits + 7) // 8\n");
+    fprintf(python_file, "\t em = pow(int.from_bytes(sig, \"big\"), e, n).to_bytes(em_len, \"big\")\n");
+    fprintf(python_file, "\t if em[-1] != 0xbc:\n\t\t return False\n");
+    fprintf(python_file, "\t h = em[em_len - 33:em_len - 1]\n");
+    fprintf(python_file, "\t db = bytearray(xor(em[:em_len - 33], mgf1(h, em_len - 33)))\n");
+    fprintf(python_file, "\t db[0] &= 0xff >> (8 * em_len - em_bits)\n");
+    fprintf(python_file, "\t if any(db[:em_len - 66]) or db[em_len - 66] != 1:\n\t\t return False\n");
+    fprintf(python_file, "\t m_hash = hashlib.sha256(message).digest()\n");
+    fprintf(python_file, "\t return hashlib.sha256(bytes(8) + m_hash + bytes(db[-32:])).digest() == h\n\n");
+
+    while ((key_num < 2) && (fgets(buffer, sizeof(buffer), rsa_param_file) != NULL) && (sscanf(buffer, "n = 0x%s", n_string) == 1))
+    {
+        if ((fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "e = 0x%s", e_string) != 1) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "d = 0x%s", d_string) != 1)) {
+            perror("Error reading from file");
+            break;
+        }
+        bi_set_from_string(&n, n_string, 16);
+        bi_set_from_string(&e, e_string, 16);
+        bi_set_from_string(&d, d_string, 16);
+        key_num++;
+
+        int k = bi_get_byte_len(n);
+        fprintf(python_file, "n = ");
+        bi_fprint(python_file,n);
+        fprintf(python_file, "e = ");
+        bi_fprint(python_file,e);
+        fprintf(python_file, "d = ");
+        bi_fprint(python_file,d);
+
+        for (int testnum = 0; testnum < 8; testnum++) {
+            int message_len = (testnum == 0) ? 0 : (testnum == 1) ? k - 2 * PKCS1_HASH_LEN - 2 : rand() % (k - 2 * PKCS1_HASH_LEN - 1);
+            int label_len = testnum % (int)sizeof(label);
+            int decrypted_len = -1;
+
+            drbg_bytes(message, message_len);
+            drbg_bytes(label, label_len);
+
+            // OAEP
+            int enc = rsa_oaep_encrypt(out, message, message_len, label, label_len, e, n);
+            int dec = rsa_oaep_decrypt(decrypted, &decrypted_len, out, label, label_len, d, n);
+            fprint_bytes(python_file, "message", message, message_len);
+            fprint_bytes(python_file, "label", label, label_len);
+            fprint_bytes(python_file, "c", out, k);
+            fprint_bytes(python_file, "decrypted", decrypted, (decrypted_len > 0) ? decrypted_len : 0);
+            fprintf(python_file, "em = pow(int.from_bytes(c, \"big\"), d, n).to_bytes(%d, \"big\")\n", k);
+            fprintf(python_file, "if (%d != 1) or (%d != 1) or (oaep_decode(em, label) != message) or (decrypted != message):\n \t print(f\"[oaep] : {message.hex()}\")\n", enc, dec);
+
+            // a changed ciphertext is rejected
+            out[k / 2] ^= 0x01;
+            int bad_dec = rsa_oaep_decrypt(decrypted, &decrypted_len, out, label, label_len, d, n);
+            fprintf(python_file, "if %d != -1:\n \t print(f\"[oaep] : modified ciphertext accepted {message.hex()}\")\n", bad_dec);
+
+            // PSS
+            int sign = rsa_pss_sign(out, message, message_len, d, n);
+            int valid = rsa_pss_verify(message, message_len, out, e, n);
+            message[0] ^= 0x01;
+            int invalid = rsa_pss_verify(message, (message_len > 0) ? message_len : 1, out, e, n);
+            message[0] ^= 0x01;
+            fprint_bytes(python_file, "sig", out, k);
+            fprintf(python_file, "if (%d != 1) or (%d != %d) or (%d != %d) or not pss_verify(message, sig, e, n):\n \t print(f\"[pss] : {message.hex()}\")\n", sign, valid, SIGN_VALID, invalid, SIGN_INVALID);
+        }
+    }
+    fclose(python_file);
+    fclose(rsa_param_file);
+
+    bi_delete(&n);
+    bi_delete(&e);
+    bi_delete(&d);
+}
+
+/**
+ * @brief Tests batch RSA verification against Python pow().
+ * 
+ * For every key of rsa_2048_params.txt, verifies a batch that mixes valid signatures, signatures
+ * of a different message and signatures not smaller than n. The batch size is not a multiple
+ * of MONT_LANES.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_rsa_verify_batch_test(IN const char* filename)
+{
+    enum {BATCH_NUM = 4 * MONT_LANES + 3};
+    bigint* n = NULL; bigint* e = NULL; bigint* p = NULL;
+    bigint* q = NULL; bigint* d = NULL; bigint* zero = NULL;
+    bigint* one = NULL;
+    bigint* msgs[BATCH_NUM] = {NULL}; bigint* sigs[BATCH_NUM] = {NULL};
+    rsa_public_ctx pub;
+    rsa_private_ctx priv;
+    int results[BATCH_NUM];
+    word small = 0;
+
+    bi_new(&zero, 1);
+    bi_new(&one, 1);
+    one->sign = POSITIVE;
+    one->a[0] = 1;
+    char buffer[1024];
+    char n_string[1024];
+    char e_string[1024];
+    char p_string[1024];
+    char q_string[1024];
+    char d_string[1024];
+
+    FILE* python_file = NULL;
+    FILE* rsa_param_file = NULL;
+
+    python_file = fopen(filename, "w");
+    if(python_file == NULL)
+    {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+    rsa_param_file = fopen("rsa_2048_params.txt", "r");
+    if (rsa_param_file == NULL) {
+        perror("FILE OPEN ERROR");
+        fclose(python_file);
+        return;
+    }
+    while ((fgets(buffer, sizeof(buffer), rsa_param_file) != NULL) && (sscanf(buffer, "n = 0x%s", n_string) == 1))
+    {
+        if ((fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "e = 0x%s", e_string) != 1) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "p = 0x%s", p_string) != 1) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "q = 0x%s", q_string) != 1) ||
+            (fgets(buffer, sizeof(buffer), rsa_param_file) == NULL) || (sscanf(buffer, "d = 0x%s", d_string) != 1)) {
+            perror("Error reading from file");
+            break;
+        }
+
+        bi_set_from_string(&n, n_string, 16);
+        bi_set_from_string(&e, e_string, 16);
+        bi_set_from_string(&p, p_string, 16);
+        bi_set_from_string(&q, q_string, 16);
+        bi_set_from_string(&d, d_string, 16);
+
+        rsa_public_init(&pub, e, n);
+        rsa_private_init(&priv, n, e, d, p, q);
+
+        fprintf(python_file, "n = ");
+        bi_fprint(python_file,n);
+        fprintf(python_file, "e = ");
+        bi_fprint(python_file,e);
+
+        //every third signature belongs to another message, every fifth is replaced by n + i
+        for (int i = 0; i < BATCH_NUM; i++)
+        {
+            bi_get_random_within_range(&msgs[i], zero, n);
+            rsa_sign(&sigs[i], msgs[i], &priv);
+            if (i % 3 == 1)
+            {
+                bi_add(&msgs[i], msgs[i], one);
+            }
+            if (i % 5 == 2)
+            {
+                small = (word)i;
+                bi_set_from_array(&sigs[i], POSITIVE, 1, &small);
+                bi_add(&sigs[i], sigs[i], n);
+            }
+        }
+        int batch_result = rsa_verify_batch(results, msgs, sigs, BATCH_NUM, &pub);
+        fprintf(python_file, "if %d != 1:\n \t print(\"[rsa verify batch] : status\")\n", batch_result);
+        for (int i = 0; i < BATCH_NUM; i++)
+        {
+            fprintf(python_file, "msg = ");
+            bi_fprint(python_file,msgs[i]);
+            fprintf(python_file, "sig = ");
+            bi_fprint(python_file,sigs[i]);
+            fprintf(python_file, "valid = %d if (sig < n) and (pow(sig, e, n) == msg) else %d\n", SIGN_VALID, SIGN_INVALID);
+            fprintf(python_file, "if %d != valid:\n \t print(f\"[rsa verify batch] : {sig:#x}\")\n", results[i]);
+        }
+
+        rsa_public_clear(&pub);
+        rsa_private_clear(&priv);
+    }
+    fclose(python_file);
+    fclose(rsa_param_file);
+
+    for (int i = 0; i < BATCH_NUM; i++)
+    {
+        bi_delete(&msgs[i]);
+        bi_delete(&sigs[i]);
+    }
+    bi_delete(&n);
+    bi_delete(&e);
+    bi_delete(&p);
+    bi_delete(&q);
+    bi_delete(&d);
+    bi_delete(&zero);
+    bi_delete(&one);
+}
+
+/**
+ * @brief Tests the multi-buffer exponentiations against Python pow().
+ * 
+ * Rounds alternate between one shared modulus, one modulus per item of equal length and one
+ * modulus per item of mixed lengths (scalar fallback inside a group). Item counts are not
+ * multiples of MONT_LANES; bases may exceed the modulus and exponents may be zero.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_mont_exp_multi_test(IN const char* filename)
+{
+    enum {ITEM_MAX = 2 * MONT_LANES + 1};
+    bigint* mods[ITEM_MAX] = {NULL}; bigint* bases[ITEM_MAX] = {NULL}; bigint* exps[ITEM_MAX] = {NULL};
+    bigint* outs[ITEM_MAX] = {NULL}; bigint* public_outs[ITEM_MAX] = {NULL};
+    bi_mont_ctx monts[ITEM_MAX];
+    const bi_mont_ctx* ctxs[ITEM_MAX];
+    const bigint* exp_args[ITEM_MAX];
+
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+
+    for (int i = 0; i < TESTNUM_modexp / 10; i++) {
+        int num = rand() % ITEM_MAX + 1;
+        int mode = i % 3;
+        int ctx_num = (mode == 0) ? 1 : num;
+        int mod_len = rand() % T_TEST_DATA_WORD_SIZE + 1;
+
+        for (int k = 0; k < ctx_num; k++) {
+            bi_get_random(&mods[k], POSITIVE, (mode == 2) ? rand() % T_TEST_DATA_WORD_SIZE + 1 : mod_len);
+            mods[k]->a[0] |= 1;
+            mods[k]->a[mods[k]->word_len - 1] |= (word)1 << (SIZEOFWORD - 1);
+            bi_mont_init(&monts[k], mods[k]);
+            ctxs[k] = &monts[k];
+        }
+        for (int k = 0; k < num; k++) {
+            int len = ctxs[(ctx_num == 1) ? 0 : k]->word_len;
+
+            bi_get_random(&bases[k], POSITIVE, rand() % (len + 1) + 1);
+            bi_get_random(&exps[k], POSITIVE, rand() % 4 + 1);
+            if (rand() % 8 == 0) {
+                array_init(exps[k]->a, exps[k]->word_len);
+                bi_refine(exps[k]);
+            }
+            exp_args[k] = exps[k];
+        }
+
+        int secure_result = bi_mont_exp_multi(outs, bases, exp_args, ctxs, ctx_num, num);
+        int public_result = bi_mont_exp_public_multi(public_outs, bases, exp_args, ctxs, ctx_num, num);
+        fprintf(file, "if (%d != 1) or (%d != 1):\n \t print(\"[mont multi] : status\")\n", secure_result, public_result);
+        for (int k = 0; k < num; k++) {
+            fprintf(file, "base = ");
+            bi_fprint(file, bases[k]);
+            fprintf(file, "exp = ");
+            bi_fprint(file, exps[k]);
+            fprintf(file, "mod = ");
+            bi_fprint(file, mods[(ctx_num == 1) ? 0 : k]);
+            fprintf(file, "out = ");
+            bi_fprint(file, outs[k]);
+            fprintf(file, "public_out = ");
+            bi_fprint(file, public_outs[k]);
+            fprintf(file, "temp = pow(base, exp, mod)\n");
+            fprintf(file, "if (out != temp) or (public_out != temp):\n \t print(f\"[mont multi]: {base:#x} ^ {exp:#x} mod {mod:#x}\\n\")\n\n");
+        }
+
+        for (int k = 0; k < ctx_num; k++) {
+            bi_mont_clear(&monts[k]);
+        }
+    }
+    fclose(file);
+
+    for (int k = 0; k < ITEM_MAX; k++) {
+        bi_delete(&mods[k]);
+        bi_delete(&bases[k]);
+        bi_delete(&exps[k]);
+        bi_delete(&outs[k]);
+        bi_delete(&public_outs[k]);
+    }
+}
+
+/**
+ * @brief Tests single exponentiations on moduli around and above MONT_AVX2_WIDE against Python pow().
+ * 
+ * Moduli from one word below the threshold up to 15360 bits, with limb counts on and off a
+ * multiple of 4, go through `bi_mont_exp` in place and `bi_mont_exp_public`; bases may exceed
+ * the modulus and exponents may be zero.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_mont_exp_wide_test(IN const char* filename)
+{
+    const int mod_bits[] = {MONT_AVX2_WIDE - SIZEOFWORD, MONT_AVX2_WIDE, 4096, 4096 + SIZEOFWORD, 7680, 15360};
+    const int mod_num = (int)(sizeof(mod_bits) / sizeof(mod_bits[0]));
+    bigint* mod = NULL; bigint* base = NULL; bigint* exp = NULL;
+    bigint* out = NULL; bigint* public_out = NULL;
+    bi_mont_ctx ctx;
+
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+
+    for (int i = 0; i < TESTNUM_modexp / 50; i++) {
+        int mod_len = mod_bits[i % mod_num] / SIZEOFWORD;
+
+        bi_get_random(&mod, POSITIVE, mod_len);
+        mod->a[0] |= 1;
+        mod->a[mod_len - 1] |= (word)1 << (SIZEOFWORD - 1);
+        bi_mont_init(&ctx, mod);
+        bi_get_random(&base, POSITIVE, rand() % (mod_len + 1) + 1);
+        bi_get_random(&exp, POSITIVE, (i < mod_num) ? mod_len : rand() % 4 + 1);
+        if (rand() % 8 == 0) {
+            array_init(exp->a, exp->word_len);
+            bi_refine(exp);
+        }
+
+        int public_result = bi_mont_exp_public(&public_out, base, exp, &ctx);
+        bi_assign(&out, base);
+        int secure_result = bi_mont_exp(&out, out, exp, &ctx);
+        fprintf(file, "if (%d != 1) or (%d != 1):\n \t print(\"[mont wide] : status\")\n", secure_result, public_result);
+        fprintf(file, "base = ");
+        bi_fprint(file, base);
+        fprintf(file, "exp = ");
+        bi_fprint(file, exp);
+        fprintf(file, "mod = ");
+        bi_fprint(file, mod);
+        fprintf(file, "out = ");
+        bi_fprint(file, out);
+        fprintf(file, "public_out = ");
+        bi_fprint(file, public_out);
+        fprintf(file, "temp = pow(base, exp, mod)\n");
+        fprintf(file, "if (out != temp) or (public_out != temp):\n \t print(f\"[mont wide]: {base:#x} ^ {exp:#x} mod {mod:#x}\\n\")\n\n");
+
+        bi_mont_clear(&ctx);
+    }
+    fclose(file);
+
+    bi_delete(&mod);
+    bi_delete(&base);
+    bi_delete(&exp);
+    bi_delete(&out);
+    bi_delete(&public_out);
+}
+
+/**
+ * @brief Writes `name = <value of the word array>` to a Python test file.
+ */
+static void fprint_words(IN FILE* file, IN const char* name, IN const word* src, IN int len)
+{
+    bigint* value = NULL;
+
+    bi_set_from_array(&value, POSITIVE, len, src);
+    bi_refine(value);
+    fprintf(file, "%s = ", name);
+    bi_fprint(file, value);
+    bi_delete(&value);
+}
+
+/**
+ * @brief Tests the kernels of every CPU tier against Python integers.
+ * 
+ * Each round fills one random input set and runs it through the `cpu_kernels` table of every
+ * tier (tiers the CPU lacks fall back to the ones below): `addmul_1`, `mul_basecase`, both
+ * shifts and Montgomery multiplication and squaring. Some words are all ones, so the carry
+ * chains overflow.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_cpu_kernels_test(IN const char* filename)
+{
+    enum {LEN_MAX = T_TEST_DATA_WORD_SIZE};
+    const int tiers[] = {CPU_TIER_GENERIC, CPU_TIER_BMI2, CPU_TIER_ADX, CPU_TIER_AVX2, CPU_TIER_AVX512};
+    word a[LEN_MAX], b[LEN_MAX], acc[LEN_MAX], pad[LEN_MAX], out[2 * LEN_MAX + 4], t[2 * LEN_MAX + 2];
+    bigint* mod = NULL;
+    bi_mont_ctx ctx;
+
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+
+    for (int i = 0; i < TESTNUM / 50; i++) {
+        int len1 = rand() % LEN_MAX + 1;
+        int len2 = rand() % LEN_MAX + 1;
+        int lbits = rand() % (3 * SIZEOFWORD);
+        int rbits = rand() % (len1 * SIZEOFWORD);
+        word w = 0;
+
+        if ((array_rand(a, len1) == FAILED) || (array_rand(b, len2) == FAILED) ||
+            (array_rand(acc, len2) == FAILED) || (array_rand(&w, 1) == FAILED)) {
+            fprintf(file, "print(\"[cpu] array_rand failed\\n\")\n");
+            break;
+        }
+        for (int k = 0; k < len2; k++) {
+            if (rand() % 4 == 0) {
+                b[k] = acc[k] = ~(word)0;
+            }
+        }
+        if (rand() % 4 == 0) {
+            w = ~(word)0;
+        }
+        bi_get_random(&mod, POSITIVE, len2);
+        mod->a[0] |= 1;
+        mod->a[len2 - 1] |= (word)1 << (SIZEOFWORD - 1);
+        bi_mont_init(&ctx, mod);
+        a[len1 - 1] &= ~((word)1 << (SIZEOFWORD - 1));     //a, b < n as Montgomery operands
+        b[len2 - 1] &= ~((word)1 << (SIZEOFWORD - 1));
+        array_init(pad, len2);
+        array_copy(pad, a, (len1 < len2) ? len1 : len2);
+
+        fprint_words(file, "a", a, len1);
+        fprint_words(file, "b", b, len2);
+        fprint_words(file, "acc", acc, len2);
+        fprint_words(file, "n", ctx.n, len2);
+        fprint_words(file, "w", &w, 1);
+        fprintf(file, "W = %d\n", SIZEOFWORD);
+
+        for (int k = 0; k < (int)(sizeof(tiers) / sizeof(tiers[0])); k++) {
+            cpu_kernels kernels;
+            word carry;
+
+            cpu_kernels_init(&kernels, tiers[k]);
+            fprintf(file, "tier = %#x\n", tiers[k]);
+
+            array_copy(out, acc, len2);
+            carry = kernels.addmul_1(out, b, len2, w);
+            out[len2] = carry;
+            fprint_words(file, "r", out, len2 + 1);
+            fprintf(file, "if (r != acc + b * w):\n \t print(f\"[cpu {tier:#x}] addmul_1: {acc:#x} + {b:#x} * {w:#x} != {r:#x}\\n\")\n");
+
+            kernels.mul_basecase(out, a, len1, b, len2);
+            fprint_words(file, "r", out, len1 + len2);
+            fprintf(file, "if (r != a * b):\n \t print(f\"[cpu {tier:#x}] mul_basecase: {a:#x} * {b:#x} != {r:#x}\\n\")\n");
+
+            carry = kernels.lshift(out, a, len1, lbits);
+            out[len1 + lbits / SIZEOFWORD] = carry;
+            fprint_words(file, "r", out, len1 + lbits / SIZEOFWORD + 1);
+            fprintf(file, "if (r != a << %d):\n \t print(f\"[cpu {tier:#x}] lshift: {a:#x} << %d != {r:#x}\\n\")\n", lbits, lbits);
+
+            kernels.rshift(out, a, len1, rbits);
+            fprint_words(file, "r", out, len1 - rbits / SIZEOFWORD);
+            fprintf(file, "if (r != a >> %d):\n \t print(f\"[cpu {tier:#x}] rshift: {a:#x} >> %d != {r:#x}\\n\")\n", rbits, rbits);
+
+            if (len1 <= len2) {
+                kernels.mont_mul(out, pad, b, ctx.n, ctx.n0, len2, t);
+                fprint_words(file, "r", out, len2);
+                fprintf(file, "if (r >= n) or ((r << (W * %d)) - a * b) %% n != 0:\n \t print(f\"[cpu {tier:#x}] mont_mul: {a:#x} * {b:#x} mod {n:#x} -> {r:#x}\\n\")\n", len2);
+                kernels.mont_sqr(out, pad, ctx.n, ctx.n0, len2, t);
+                fprint_words(file, "r", out, len2);
+                fprintf(file, "if (r >= n) or ((r << (W * %d)) - a * a) %% n != 0:\n \t print(f\"[cpu {tier:#x}] mont_sqr: {a:#x} ^ 2 mod {n:#x} -> {r:#x}\\n\")\n", len2);
+            }
+        }
+        fprintf(file, "\n");
+        bi_mont_clear(&ctx);
+    }
+    fclose(file);
+
+    bi_delete(&mod);
+}
+
+/**
+ * @struct alloc_count
+ * @brief Counts the blocks and bytes that are live in `count_alloc` for `python_mempool_test`.
+ */
+typedef struct {
+    int blocks;     /**< Blocks handed out and not yet released. */
+    long bytes;     /**< Bytes of those blocks. */
+} alloc_count;
+
+static void* count_alloc(void* ctx, size_t size)
+{
+    ((alloc_count*)ctx)->blocks++;
+    ((alloc_count*)ctx)->bytes += (long)size;
+    return calloc(1, size);
+}
+
+static void count_release(void* ctx, void* ptr, size_t size)
+{
+    ((alloc_count*)ctx)->blocks--;
+    ((alloc_count*)ctx)->bytes -= (long)size;
+    free(ptr);
+}
+
+/**
+ * @brief Creates and deletes bigints on a thread that exits without calling bi_pool_clear.
+ */
+static void* pool_thread(void* arg)
+{
+    bigint* a = NULL;
+    bigint* b = NULL;
+
+    (void)arg;
+    for (int i = 0; i < 64; i++) {
+        bi_get_random(&a, POSITIVE, rand() % T_TEST_DATA_WORD_SIZE + 1);
+        bi_mul(&b, a, a);
+        bi_delete(&a);
+        bi_delete(&b);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Tests the storage management of bigints using Python data.
+ * 
+ * Each round checks that `bi_reserve` and `bi_shrink` keep the value and set the capacity,
+ * and that an arena leaves the bigints created before it valid even when they grow inside it,
+ * keeping either such a bigint or one created in the arena (nested arenas included). A counting
+ * allocator set with `bi_set_allocator` must get every block back, and `bi_pool_clear` is called
+ * between rounds. A thread that exits without `bi_pool_clear` runs the pool's thread-exit path.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_mempool_test(IN const char* filename)
+{
+    const bi_allocator broken = {NULL, count_release, NULL};
+    pthread_t thread;
+
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+
+    if (pthread_create(&thread, NULL, pool_thread, NULL) == 0) {
+        pthread_join(thread, NULL);
+    }
+
+    for (int i = 0; i < TESTNUM / 100; i++) {
+        bigint* a = NULL;
+        bigint* acc = NULL;
+        bigint* other = NULL;
+        bigint* x = NULL;
+        bigint* res = NULL;
+        bigint* keep = NULL;
+        alloc_count count = {0, 0};
+        bi_allocator counting = {count_alloc, count_release, NULL};
+        int capacity = 0;
+        int result = 1;
+
+        // reserve and shrink
+        bi_get_random(&a, POSITIVE, rand() % T_TEST_DATA_WORD_SIZE + 1);
+        fprintf(file, "a = ");
+        bi_fprint(file, a);
+        capacity = a->word_len + rand() % 64 + 1;
+        result &= (bi_reserve(a, capacity) == SUCCESS) && (a->capacity >= capacity);
+        fprintf(file, "reserved = ");
+        bi_fprint(file, a);
+        result &= (bi_shrink(a) == SUCCESS) && (a->capacity == a->word_len);
+        fprintf(file, "shrunk = ");
+        bi_fprint(file, a);
+        fprintf(file, "result = %d\n", result);
+        fprintf(file, "if (reserved != a) or (shrunk != a) or (result != 1):\n \t print(f\"[reserve/shrink]: {a:#x} -> {reserved:#x}, {shrunk:#x}, {result}\\n\")\n");
+
+        // arena: acc and other are created before it and grow inside it
+        bi_get_random(&acc, POSITIVE, rand() % T_TEST_DATA_WORD_SIZE + 1);
+        bi_get_random(&other, POSITIVE, rand() % T_TEST_DATA_WORD_SIZE + 1);
+        bi_get_random(&x, POSITIVE, rand() % (4 * T_TEST_DATA_WORD_SIZE) + 1);
+        fprintf(file, "acc = ");
+        bi_fprint(file, acc);
+        fprintf(file, "other = ");
+        bi_fprint(file, other);
+        fprintf(file, "x = ");
+        bi_fprint(file, x);
+        result = (bi_arena_begin() == SUCCESS);
+        bi_add(&acc, acc, x);
+        bi_mul(&other, other, x);
+        bi_mul(&res, acc, x);
+        result &= (bi_arena_begin() == SUCCESS);
+        bi_add(&res, res, acc);
+        result &= (bi_arena_end(NULL) == SUCCESS);     //inner arena: nothing is freed yet
+        keep = (i % 2 == 0) ? acc : res;
+        result &= (bi_arena_end(&keep) == SUCCESS);
+        if (i == 0) {
+            result &= (bi_arena_end(NULL) == FAILED);  //no arena left
+        }
+        if (i % 2 == 0) {
+            acc = keep;
+        }
+        else {
+            res = keep;
+            fprintf(file, "res = ");
+            bi_fprint(file, res);
+            fprintf(file, "if (res != (acc + x) * x + acc + x):\n \t print(f\"[arena res]: {res:#x}\\n\")\n");
+        }
+        fprintf(file, "acc_x = ");
+        bi_fprint(file, acc);
+        fprintf(file, "other_x = ");
+        bi_fprint(file, other);
+        fprintf(file, "result = %d\n", result);
+        fprintf(file, "if (acc_x != acc + x) or (other_x != other * x) or (result != 1):\n \t print(f\"[arena]: {acc:#x}, {other:#x}, {x:#x} -> {acc_x:#x}, {other_x:#x}, {result}\\n\")\n");
+        if (i % 2 == 0) {
+            res = NULL;     //created in the arena and not kept
+        }
+
+        // counting allocator: every block comes back
+        counting.ctx = &count;
+        result = (i != 0) || (bi_set_allocator(&broken) == FAILED);
+        result &= (bi_set_allocator(&counting) == SUCCESS);
+        {
+            bigint* y = NULL;
+            bigint* z = NULL;
+
+            bi_assign(&y, x);
+            bi_mul(&z, y, acc);
+            bi_add(&y, y, z);
+            bi_delete(&y);
+            bi_delete(&z);
+        }
+        result &= (count.blocks == 0) && (count.bytes == 0) && (bi_set_allocator(NULL) == SUCCESS);
+        fprintf(file, "result = %d\n", result);
+        fprintf(file, "if (result != 1):\n \t print(f\"[allocator]: %d blocks, %ld bytes left\\n\")\n\n", count.blocks, count.bytes);
+
+        bi_delete(&a);
+        bi_delete(&acc);
+        bi_delete(&other);
+        bi_delete(&x);
+        bi_delete(&res);
+        bi_pool_clear();
+    }
+    fclose(file);
+}
+
+/**
+ * @brief Tests fixed-capacity bigints and byte views using Python data.
+ * 
+ * Addition, subtraction, multiplication, squaring (schoolbook and Karatsuba), word division
+ * and shifts write into `BI_FIXED_INIT` destinations, and one operand is a `bi_view_from_bytes`
+ * view of a word buffer. The first round also checks that results beyond the capacity fail,
+ * that a view cannot be written or made from a misaligned buffer, and that `bi_delete` only
+ * clears a fixed bigint and detaches a view.
+ * 
+ * @param[in] filename The name of the file containing test data.
+ * 
+ * @return void
+ */
+void python_fixed_test(IN const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("FILE OPEN ERROR");
+        return;
+    }
+
+    for (int i = 0; i < TESTNUM / 10; i++) {
+        bigint4096 add_f, sub_f, mul_f, mulk_f, squ_f, squk_f, q_f, r_f, shift_f;
+        bigint* add = &add_f.bi;
+        bigint* sub = &sub_f.bi;
+        bigint* mul = &mul_f.bi;
+        bigint* mulk = &mulk_f.bi;
+        bigint* squ = &squ_f.bi;
+        bigint* squk = &squk_f.bi;
+        bigint* q = &q_f.bi;
+        bigint* r = &r_f.bi;
+        bigint* shift = &shift_f.bi;
+        bigint* a = NULL;
+        bigint* b = NULL;
+        bigint view;
+        bigint* v = &view;
+        word v_words[T_TEST_DATA_WORD_SIZE];
+        int v_len = rand() % T_TEST_DATA_WORD_SIZE + 1;
+        int lbits = rand() % (T_TEST_DATA_WORD_SIZE * SIZEOFWORD);
+        int rbits = rand() % (2 * T_TEST_DATA_WORD_SIZE * SIZEOFWORD);
+        int result = 1;
+
+        BI_FIXED_INIT(add_f);
+        BI_FIXED_INIT(sub_f);
+        BI_FIXED_INIT(mul_f);
+        BI_FIXED_INIT(mulk_f);
+        BI_FIXED_INIT(squ_f);
+        BI_FIXED_INIT(squk_f);
+        BI_FIXED_INIT(q_f);
+        BI_FIXED_INIT(r_f);
+        BI_FIXED_INIT(shift_f);
+        bi_get_random(&a, (rand() % 2) ? POSITIVE : NEGATIVE, rand() % T_TEST_DATA_WORD_SIZE + 1);
+        bi_get_random(&b, POSITIVE, rand() % T_TEST_DATA_WORD_SIZE + 1);
+        result &= (array_rand(v_words, v_len) == SUCCESS);
+        result &= (bi_view_from_bytes(&view, (const byte*)v_words, v_len * (int)sizeof(word)) == SUCCESS);
+
+        result &= (bi_add(&add, a, v) == SUCCESS);
+        result &= (bi_sub(&sub, a, b) == SUCCESS);
+        result &= (bi_mul(&mul, a, v) == SUCCESS);
+        result &= (bi_mul_kara(&mulk, v, b) == SUCCESS);
+        result &= (bi_squ(&squ, a) == SUCCESS);
+        result &= (bi_squ_kara(&squk, v) == SUCCESS);
+        result &= (bi_word_division(&q, &r, mulk, a) == SUCCESS);
+        result &= (bi_bit_lshift_to(&shift, v, lbits) == SUCCESS) && (bi_bit_rshift(shift, rbits) == SUCCESS);
+        result &= (add == &add_f.bi) && (mul == &mul_f.bi) && (q == &q_f.bi) && (r == &r_f.bi);
+
+        fprintf(file, "a = ");
+        bi_fprint(file, a);
+        fprintf(file, "b = ");
+        bi_fprint(file, b);
+        fprint_bytes(file, "v_bytes", (const byte*)v_words, v_len * (int)sizeof(word));
+        fprintf(file, "v = int.from_bytes(v_bytes, \"little\")\n");
+        fprintf(file, "add = ");
+        bi_fprint(file, add);
+        fprintf(file, "sub = ");
+        bi_fprint(file, sub);
+        fprintf(file, "mul = ");
+        bi_fprint(file, mul);
+        fprintf(file, "mulk = ");
+        bi_fprint(file, mulk);
+        fprintf(file, "squ = ");
+        bi_fprint(file, squ);
+        fprintf(file, "squk = ");
+        bi_fprint(file, squk);
+        fprintf(file, "q = ");
+        bi_fprint(file, q);
+        fprintf(file, "r = ");
+        bi_fprint(file, r);
+        fprintf(file, "shift = ");
+        bi_fprint(file, shift);
+
+        if (i == 0) {
+            bigint1024 small_f;
+            bigint* small = &small_f.bi;
+            bigint* full = NULL;
+            word full_words[BI_FIXED_WORDS(1024)];
+
+            BI_FIXED_INIT(small_f);
+            for (int k = 0; k < BI_FIXED_WORDS(1024); k++) {
+                full_words[k] = ~(word)0;
+            }
+            bi_set_from_array(&full, POSITIVE, BI_FIXED_WORDS(1024), full_words);
+            result &= (bi_mul(&small, full, full) == FAILED);               //twice the capacity
+            result &= (bi_add(&small, full, full) == FAILED);               //one carry word more
+            result &= (bi_bit_lshift_to(&small, full, 1) == FAILED);
+            result &= (bi_squ_kara(&small, full) == FAILED);
+            result &= (small == &small_f.bi);
+            result &= (bi_add(&v, a, b) == FAILED);                         //views are read-only
+            result &= (bi_view_from_bytes(&view, (const byte*)v_words + 1, (int)sizeof(word)) == FAILED);
+            result &= (bi_delete(&add) == SUCCESS) && (add == &add_f.bi) && (add->sign == ZERO);
+            result &= (bi_delete(&v) == SUCCESS) && (v == NULL) && (view.a == v_words);
+            bi_delete(&full);
+        }
+        fprintf(file, "result = %d\n", result);
+        fprintf(file, "if (add != a + v and %d != 0) or (sub != a - b) or (mul != a * v) or (mulk != v * b) or (squ != a * a) or (squk != v * v):\n \t print(f\"[fixed]: {a:#x}, {b:#x}, {v:#x}\\n\")\n", i);
+        fprintf(file, "if (q != mulk // a) or (r != mulk %% a) or (shift != (v << %d) >> %d) or (result != 1):\n \t print(f\"[fixed div/shift]: {a:#x}, {b:#x}, {v:#x}, {result}\\n\")\n\n", lbits, rbits);
+
+        bi_delete(&a);
+        bi_delete(&b);
+    }
+    fclose(file);
 }
\ No newline at end of file
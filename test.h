@@ -7,6 +7,9 @@
 
 #define TESTNUM_modexp              1000      //number of test case to modexp
 
+#define TESTNUM_kara                100       //number of test case to Karatsuba above the thresholds
+#define T_KARA_WORD_SIZE            (4 * KARA_FLAG_SQU)    //largest operand of those cases: two levels of squaring recursion
+
 #if SIZEOFWORD == 8
     #define T_TEST_DATA_WORD_SIZE (1024 / SIZEOFWORD) 
 #elif SIZEOFWORD == 32
@@ -22,6 +25,7 @@
 #define T_USE_RANDOM_WORD_SIZE       0
 #define T_TEST_ALL_CASE              0      //Run All case of operator bigint(ex. pp, nn, np, ..., zz)
 #define T_TEST_AVERAGE               1      //Measure time with testnum average or sum
+#define T_TEST_FIXED_SEED            0      //Seed random generators with fixed value for reproducible runs
 
 void bignum_add_time_test();
 
@@ -81,4 +85,36 @@ void python_rsa_key_gen_test(IN const char* filename, IN int testnum);
 
 void python_rsa_enc_dec_test(IN const char* filename);
 
+void python_small_prime_test(IN const char* filename);
+
+void python_bytes_test(IN const char* filename);
+
+void python_dec_test(IN const char* filename);
+
+void python_mont_exp_test(IN const char* filename);
+
+void python_inplace_test(IN const char* filename);
+
+void python_rsa_ctx_test(IN const char* filename);
+
+void python_rsa_batch_test(IN const char* filename);
+
+void python_rsa_multi_prime_test(IN const char* filename, IN int testnum);
+
+void python_sha256_test(IN const char* filename);
+
+void python_pkcs1_test(IN const char* filename);
+
+void python_rsa_verify_batch_test(IN const char* filename);
+
+void python_mont_exp_multi_test(IN const char* filename);
+
+void python_mont_exp_wide_test(IN const char* filename);
+
+void python_cpu_kernels_test(IN const char* filename);
+
+void python_mempool_test(IN const char* filename);
+
+void python_fixed_test(IN const char* filename);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,371 @@
+#define _POSIX_C_SOURCE 200112L     //pthread and sysconf under -std=c99
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+#include "threadpool.h"
+#include "mempool.h"
+#include "params.h"
+#include "errormsg.h"
+
+/**
+ * @struct task_queue
+ * @brief Range [begin, end) of task indices owned by one worker.
+ *
+ * The owner takes indices from the front; idle workers steal the back half.
+ */
+typedef struct {
+    pthread_mutex_t lock;   /**< Protects `begin` and `end`. */
+    int begin;              /**< Next index taken by the owner. */
+    int end;                /**< One past the last index. */
+} task_queue;
+
+/**
+ * @struct thread_worker
+ * @brief Start argument of a helper thread.
+ */
+typedef struct {
+    thread_pool* pool;      /**< The pool the thread belongs to. */
+    int index;              /**< Index of the thread's queue. */
+} thread_worker;
+
+struct thread_pool {
+    int thread_num;             /**< Number of workers, including the thread that calls run. */
+    pthread_t* threads;         /**< The thread_num - 1 helper threads. */
+    thread_worker* workers;     /**< Start arguments of the helper threads. */
+    task_queue* queues;         /**< One queue per worker; queue 0 belongs to the calling thread. */
+    pthread_mutex_t lock;       /**< Protects the fields below. */
+    pthread_cond_t start;       /**< Signalled when a batch is posted or the pool stops. */
+    pthread_cond_t done;        /**< Signalled when the last helper finishes a batch. */
+    unsigned long generation;   /**< Number of batches posted so far. */
+    int busy;                   /**< Helpers still working on the current batch. */
+    int running;                /**< 1 while a batch is in progress. */
+    int stop;                   /**< 1 when the helpers should exit. */
+    thread_task task;           /**< Task of the current batch. */
+    void* arg;                  /**< Argument of the current batch. */
+};
+
+/***********************************************
+ * Work Stealing
+ ***********************************************/
+/**
+ * @brief Returns the number of online processors, at least 1.
+ */
+static int cpu_count()
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return (info.dwNumberOfProcessors > 0) ? (int)info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (count > 0) ? (int)count : 1;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Takes the next index from the front of a worker's own queue, or returns -1.
+ */
+static int queue_pop(INOUT task_queue* queue)
+{
+    int index = -1;
+
+    pthread_mutex_lock(&queue->lock);
+    if(queue->begin < queue->end)
+    {
+        index = queue->begin++;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return index;
+}
+
+/**
+ * @brief Steals the back half of another worker's queue into the (empty) queue of `self`.
+ *
+ * Victims are scanned starting after `self`, so thieves spread over different queues.
+ * Returns the first stolen index, or -1 if every queue is empty. No task is added after a
+ * batch is posted, so once every queue is seen empty all indices have been handed out.
+ */
+static int queue_steal(INOUT thread_pool* pool, IN int self)
+{
+    for(int k = 1; k < pool->thread_num; k++)
+    {
+        task_queue* victim = &pool->queues[(self + k) % pool->thread_num];
+        int begin = 0, end = 0;
+
+        pthread_mutex_lock(&victim->lock);
+        if(victim->begin < victim->end)
+        {
+            end = victim->end;
+            begin = end - (victim->end - victim->begin + 1) / 2;
+            victim->end = begin;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if(begin < end)
+        {
+            task_queue* own = &pool->queues[self];
+
+            pthread_mutex_lock(&own->lock);
+            own->begin = begin + 1;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            return begin;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Runs tasks of the current batch, from the own queue first and then stolen ones, until none are left.
+ */
+static void worker_drain(INOUT thread_pool* pool, IN int self)
+{
+    int index = 0;
+
+    while(((index = queue_pop(&pool->queues[self])) >= 0) || ((index = queue_steal(pool, self)) >= 0))
+    {
+        pool->task(pool->arg, index);
+    }
+}
+
+/**
+ * @brief Helper thread: waits for batches and drains them until the pool stops.
+ */
+static void* worker_main(void* arg)
+{
+    thread_worker* worker = (thread_worker*)arg;
+    thread_pool* pool = worker->pool;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while(1)
+    {
+        while((pool->stop == 0) && (pool->generation == seen))
+        {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if(pool->stop)
+        {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        worker_drain(pool, worker->index);
+
+        pthread_mutex_lock(&pool->lock);
+        if(--pool->busy == 0)
+        {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    bi_pool_clear();    //blocks cached by this thread
+
+    return NULL;
+}
+
+/***********************************************
+ * Thread Pool
+ ***********************************************/
+/**
+ * @brief Creates a pool of worker threads.
+ *
+ * The thread that calls `thread_pool_run` works on the batch too, so `thread_num - 1` helper
+ * threads are started.
+ *
+ * @param[out] pool Pointer to the pool; release it with `thread_pool_destroy`.
+ * @param[in] thread_num The number of workers, or 0 for the number of online processors.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg thread_pool_create(OUT thread_pool** pool, IN int thread_num)
+{
+    thread_pool* new_pool = NULL;
+    int started = 0;
+
+    if((pool == NULL) || (thread_num < 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    if(thread_num == 0)
+    {
+        thread_num = cpu_count();
+    }
+
+    new_pool = (thread_pool*)calloc(1, sizeof(thread_pool));
+    if(new_pool == NULL)
+    {
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        return FAILED;
+    }
+    new_pool->thread_num = thread_num;
+    new_pool->threads = (pthread_t*)calloc(thread_num, sizeof(pthread_t));
+    new_pool->workers = (thread_worker*)calloc(thread_num, sizeof(thread_worker));
+    new_pool->queues = (task_queue*)calloc(thread_num, sizeof(task_queue));
+    if((new_pool->threads == NULL) || (new_pool->workers == NULL) || (new_pool->queues == NULL))
+    {
+        fprintf(stderr, ERR_MEMORY_ALLOCATION);
+        free(new_pool->threads);
+        free(new_pool->workers);
+        free(new_pool->queues);
+        free(new_pool);
+        return FAILED;
+    }
+
+    pthread_mutex_init(&new_pool->lock, NULL);
+    pthread_cond_init(&new_pool->start, NULL);
+    pthread_cond_init(&new_pool->done, NULL);
+    for(int i = 0; i < thread_num; i++)
+    {
+        pthread_mutex_init(&new_pool->queues[i].lock, NULL);
+        new_pool->workers[i].pool = new_pool;
+        new_pool->workers[i].index = i;
+    }
+
+    for(started = 1; started < thread_num; started++)
+    {
+        if(pthread_create(&new_pool->threads[started], NULL, worker_main, &new_pool->workers[started]) != 0)
+        {
+            break;
+        }
+    }
+    *pool = new_pool;
+    if(started < thread_num)
+    {
+        fprintf(stderr, ERR_NOT_CONDITION_FUNC);
+        new_pool->thread_num = started;     //only the started helpers are joined
+        thread_pool_destroy(pool);
+        return FAILED;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Stops and joins the helper threads and releases the pool.
+ *
+ * @param[inout] pool Pointer to the pool; set to NULL.
+ *
+ * @return void
+ */
+void thread_pool_destroy(INOUT thread_pool** pool)
+{
+    thread_pool* old_pool = NULL;
+
+    if((pool == NULL) || (*pool == NULL))
+    {
+        return;
+    }
+    old_pool = *pool;
+
+    pthread_mutex_lock(&old_pool->lock);
+    old_pool->stop = 1;
+    pthread_cond_broadcast(&old_pool->start);
+    pthread_mutex_unlock(&old_pool->lock);
+    for(int i = 1; i < old_pool->thread_num; i++)
+    {
+        pthread_join(old_pool->threads[i], NULL);
+    }
+
+    for(int i = 0; i < old_pool->thread_num; i++)
+    {
+        pthread_mutex_destroy(&old_pool->queues[i].lock);
+    }
+    pthread_cond_destroy(&old_pool->done);
+    pthread_cond_destroy(&old_pool->start);
+    pthread_mutex_destroy(&old_pool->lock);
+    free(old_pool->threads);
+    free(old_pool->workers);
+    free(old_pool->queues);
+    free(old_pool);
+    *pool = NULL;
+}
+
+/**
+ * @brief Returns the number of workers of a pool (1 for NULL, which runs batches inline).
+ */
+int thread_pool_size(IN const thread_pool* pool)
+{
+    return (pool == NULL) ? 1 : pool->thread_num;
+}
+
+/**
+ * @brief Runs `task(arg, i)` for every i in [0, task_num) and returns when all have finished.
+ *
+ * The indices are split into one contiguous range per worker, and a worker whose range is
+ * used up steals half of the remaining range of another, so uneven task costs still keep
+ * every thread busy. Only one batch can be in progress per pool.
+ *
+ * @param[inout] pool The pool, or NULL to run the tasks in order on the calling thread.
+ * @param[in] task The task body.
+ * @param[in] arg The argument passed to every task.
+ * @param[in] task_num The number of tasks.
+ *
+ * @return Returns 1 on success, -1 on failure.
+ */
+msg thread_pool_run(INOUT thread_pool* pool, IN thread_task task, IN void* arg, IN int task_num)
+{
+    if((task == NULL) || (task_num < 0))
+    {
+        fprintf(stderr, ERR_INVALID_INPUT);
+        return FAILED;
+    }
+    if((pool == NULL) || (pool->thread_num == 1))
+    {
+        for(int i = 0; i < task_num; i++)
+        {
+            task(arg, i);
+        }
+        return SUCCESS;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    if(pool->running)
+    {
+        pthread_mutex_unlock(&pool->lock);
+        fprintf(stderr, ERR_NOT_CONDITION_FUNC);
+        return FAILED;
+    }
+    pool->running = 1;
+    for(int i = 0; i < pool->thread_num; i++)
+    {
+        pthread_mutex_lock(&pool->queues[i].lock);
+        pool->queues[i].begin = (int)((long long)task_num * i / pool->thread_num);
+        pool->queues[i].end = (int)((long long)task_num * (i + 1) / pool->thread_num);
+        pthread_mutex_unlock(&pool->queues[i].lock);
+    }
+    pool->task = task;
+    pool->arg = arg;
+    pool->busy = pool->thread_num - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    worker_drain(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while(pool->busy > 0)
+    {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pool->running = 0;
+    pthread_mutex_unlock(&pool->lock);
+
+    return SUCCESS;
+}
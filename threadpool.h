@@ -0,0 +1,27 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "dtype.h"
+
+/**
+ * @brief Task body run by the pool: processes item `index` of a batch described by `arg`.
+ *
+ * Tasks of one batch run concurrently, so they must only write to their own item.
+ */
+typedef void (*thread_task)(void* arg, int index);
+
+/**
+ * @struct thread_pool
+ * @brief Fixed set of worker threads that run batches of independent tasks (opaque).
+ */
+typedef struct thread_pool thread_pool;
+
+msg thread_pool_create(OUT thread_pool** pool, IN int thread_num);
+
+void thread_pool_destroy(INOUT thread_pool** pool);
+
+int thread_pool_size(IN const thread_pool* pool);
+
+msg thread_pool_run(INOUT thread_pool* pool, IN thread_task task, IN void* arg, IN int task_num);
+
+#endif
@@ -33,4 +33,20 @@ void py_file_check() {
     run_system_command("python barret_redu_test.py");
     run_system_command("python rsa_key_gen_test.py");
     run_system_command("python rsa_enc_dec_test.py");
+    run_system_command("python small_prime_test.py");
+    run_system_command("python bytes_test.py");
+    run_system_command("python dec_test.py");
+    run_system_command("python mont_exp_test.py");
+    run_system_command("python inplace_test.py");
+    run_system_command("python rsa_ctx_test.py");
+    run_system_command("python rsa_batch_test.py");
+    run_system_command("python rsa_multi_prime_test.py");
+    run_system_command("python sha256_test.py");
+    run_system_command("python pkcs1_test.py");
+    run_system_command("python rsa_verify_batch_test.py");
+    run_system_command("python mont_exp_multi_test.py");
+    run_system_command("python mont_exp_wide_test.py");
+    run_system_command("python cpu_kernels_test.py");
+    run_system_command("python mempool_test.py");
+    run_system_command("python fixed_test.py");
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#ifndef WORDFUNC_H
+#define WORDFUNC_H
+
+#include "dtype.h"
+
+#if (SIZEOFWORD == 64) && (defined(__x86_64__) || defined(_M_X64))
+    #include <immintrin.h>
+    #define WORD_ADDCARRY 1     //add-with-carry intrinsics (ADC/SBB)
+#else
+    #define WORD_ADDCARRY 0
+#endif
+
+/**
+ * @brief Multiplies two words into a double word.
+ *
+ * Uses the compiler's double-width type when there is one (`dword`: unsigned __int128
+ * for 64-bit words, uint64_t for 32-bit words), which compiles to a single multiply
+ * instruction, and four half-word products otherwise.
+ *
+ * @param[out] hi Pointer to the upper word of the product.
+ * @param[in] a, b The words to be multiplied.
+ *
+ * @return The lower word of the product.
+ */
+static inline word word_mul(OUT word* hi, IN word a, IN word b)
+{
+#if HAVE_DWORD == 1
+    dword t = (dword)a * b;
+
+    *hi = (word)(t >> SIZEOFWORD);
+    return (word)t;
+#else
+    const word mask = ((word)1 << (SIZEOFWORD / 2)) - 1;
+    word a0 = a & mask, a1 = a >> (SIZEOFWORD / 2);
+    word b0 = b & mask, b1 = b >> (SIZEOFWORD / 2);
+    word p00 = a0 * b0;
+    word p01 = a0 * b1;
+    word p10 = a1 * b0;
+    word mid = (p00 >> (SIZEOFWORD / 2)) + (p01 & mask) + (p10 & mask);
+
+    *hi = a1 * b1 + (p01 >> (SIZEOFWORD / 2)) + (p10 >> (SIZEOFWORD / 2)) + (mid >> (SIZEOFWORD / 2));
+    return (p00 & mask) | (mid << (SIZEOFWORD / 2));
+#endif
+}
+
+/**
+ * @brief Computes a * b + c + d as a double word (the sum always fits).
+ *
+ * @param[out] hi Pointer to the upper word of the result.
+ * @param[in] a, b The words to be multiplied.
+ * @param[in] c, d The words to be added.
+ *
+ * @return The lower word of the result.
+ */
+static inline word word_mul_add(OUT word* hi, IN word a, IN word b, IN word c, IN word d)
+{
+#if HAVE_DWORD == 1
+    dword t = (dword)a * b + c + d;
+
+    *hi = (word)(t >> SIZEOFWORD);
+    return (word)t;
+#else
+    word lo = word_mul(hi, a, b);
+
+    lo += c;
+    *hi += (lo < c);
+    lo += d;
+    *hi += (lo < d);
+    return lo;
+#endif
+}
+
+/**
+ * @brief Computes a + b + carry_in and the outgoing carry.
+ *
+ * Uses `_addcarry_u64` on x86-64, so a chain of calls becomes a chain of ADC instructions;
+ * otherwise the carry is recovered with comparisons.
+ *
+ * @param[out] carry Pointer to the outgoing carry (0 or 1).
+ * @param[in] a, b The words to be added.
+ * @param[in] carry_in The incoming carry (0 or 1).
+ *
+ * @return The lower word of the sum.
+ */
+static inline word word_add_c(OUT word* carry, IN word a, IN word b, IN word carry_in)
+{
+#if WORD_ADDCARRY == 1
+    unsigned long long sum = 0;
+
+    *carry = _addcarry_u64((unsigned char)carry_in, a, b, &sum);
+    return (word)sum;
+#else
+    word sum = a + carry_in;
+    word c = (sum < carry_in);
+
+    sum += b;
+    *carry = c | (sum < b);
+    return sum;
+#endif
+}
+
+/**
+ * @brief Computes a - b - borrow_in and the outgoing borrow.
+ *
+ * @param[out] borrow Pointer to the outgoing borrow (0 or 1).
+ * @param[in] a The minuend.
+ * @param[in] b The subtrahend.
+ * @param[in] borrow_in The incoming borrow (0 or 1).
+ *
+ * @return The difference modulo W.
+ */
+static inline word word_sub_b(OUT word* borrow, IN word a, IN word b, IN word borrow_in)
+{
+#if WORD_ADDCARRY == 1
+    unsigned long long diff = 0;
+
+    *borrow = _subborrow_u64((unsigned char)borrow_in, a, b, &diff);
+    return (word)diff;
+#else
+    word diff = a - b;
+    word c = (a < b);
+
+    *borrow = c | (diff < borrow_in);
+    return diff - borrow_in;
+#endif
+}
+
+#endif